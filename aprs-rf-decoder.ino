@@ -13,6 +13,7 @@
  * 
  * 功能特性：
  * - AFSK解调（Bell 202标准）
+ * - G3RUH 9600波特基带解调（MODEM_MODE = MODEM_G3RUH9600）
  * - NRZI解码和比特去填充
  * - AX.25帧解析
  * - 自动载波检测
@@ -41,15 +42,18 @@
 #include "src/aprs_config.h"
 #include "src/aprs_decoder.h"
 #include "src/stm32_hal.h"
+#include "src/aprs_format.h"
+#include "src/aprs_profile.h"
+#include "src/aprs_memory.h"
 
-// 根据是否支持DSP选择解码器
-#if USE_CMSIS_DSP
-  #include "src/aprs_decoder_enhanced.h"
-  APRSDecoderEnhanced decoder;
-  #define DECODER_TYPE "Enhanced (CMSIS-DSP)"
-#else
-  APRSDecoder decoder;
-  #define DECODER_TYPE "Standard"
+// 解码器状态从静态内存池分配（各部分大小见aprs_memory.h，超出RAM预算时编译失败）
+StaticArena<memoryArenaSize()> memoryArena;
+
+// 解码器类型由配置和是否支持DSP决定（APRSDecoderType）
+APRSDecoderType& decoder = *memoryArena.create<APRSDecoderType>();
+
+#if DUP_FILTER_ENABLE
+  DuplicateFilter& dupFilter = *memoryArena.create<DuplicateFilter>();  // 抑制经中继转发的重复副本
 #endif
 
 // ============================================================================
@@ -88,9 +92,20 @@ HardwareSerial Serial1(PA10, PA9);
 // 全局变量
 // ============================================================================
 
-// 采样缓冲区（双缓冲）
-uint8_t sampleBuffer1[SAMPLE_DMA_BUFFER_SIZE];
-uint8_t sampleBuffer2[SAMPLE_DMA_BUFFER_SIZE];
+#if USE_DMA_CAPTURE
+// DMA采样循环缓冲区（GPIO输入寄存器，每采样一字节）
+uint8_t* dmaCaptureBuffer = memoryArena.allocate(DMA_CAPTURE_BUFFER_SIZE);
+#endif
+
+#if USE_SAMPLE_RING || USE_PACKED_SAMPLES
+// ISR端采样打包器（每32个采样组成一个字）
+SamplePacker samplePacker = { 0, 0 };
+#endif
+
+#if USE_SAMPLE_RING
+// 采样中断与loop()之间的无锁环形缓冲区
+SampleRing& sampleRing = *memoryArena.create<SampleRing>();
+#endif
 
 // 统计计数器
 uint32_t lastStatsTime = 0;
@@ -104,34 +119,54 @@ const uint32_t STATS_INTERVAL = 10000;  // 10秒输出一次统计
  * 读取单个比特（由RadioLib直接模式调用）
  */
 void readBit(void) {
+  PROFILE_BEGIN(isrStart);
+  
   // 直接从DIO2引脚读取比特值
   uint8_t bit = digitalRead(SX127X_DIO2);
   
+#if USE_SAMPLE_RING
+  // 仅打包并写入环形缓冲区，解码在loop()中进行
+  if (packSample(&samplePacker, bit)) {
+    sampleRing.push(samplePacker.word);
+  }
+#elif USE_PACKED_SAMPLES
+  // 打包采样，每32个采样处理一次
+  if (packSample(&samplePacker, bit)) {
+    decoder.processPackedSamples(&samplePacker.word, 1);
+  }
+#else
   // 直接处理（实时模式）
   decoder.processSample(bit);
+#endif
+  
+  PROFILE_END(PROFILE_STAGE_ISR, isrStart, 1);
 }
 
 /**
  * 采样定时器回调（备用方案）
  */
 void samplingTimerCallback(void) {
-  // 从DIO2读取比特
-  uint8_t bit = digitalRead(SX127X_DIO2);
-  decoder.processSample(bit);
+  // 与RadioLib直接模式回调相同
+  readBit();
 }
 
 /**
- * DMA传输完成回调
+ * DMA半区回调（DMA中断上下文，采样已打包）
  */
-void dmaTransferCallback(uint8_t* buffer, uint16_t size) {
-  // 批量处理采样
-  #if USE_CMSIS_DSP
-    decoder.processSampleBatch(buffer, size);
-  #else
-    for (uint16_t i = 0; i < size; i++) {
-      decoder.processSample(buffer[i]);
-    }
-  #endif
+void dmaCaptureCallback(const uint32_t* words, uint16_t count) {
+  PROFILE_BEGIN(isrStart);
+  
+#if USE_SAMPLE_RING
+  // 写入环形缓冲区，解码在loop()中进行
+  for (uint16_t i = 0; i < count; i++) {
+    sampleRing.push(words[i]);
+  }
+#else
+  // 在DMA中断中批量解码（须在DMA写满另一半区之前完成）
+  decoder.processPackedSamples(words, count);
+#endif
+  
+  PROFILE_END(PROFILE_STAGE_ISR, isrStart, count * PACKED_SAMPLES_PER_WORD);
 }
 
 // ============================================================================
@@ -146,7 +181,7 @@ bool initRadio() {
   DEBUG_PRINTLN("初始化SX1278射频模块...");
   
   // 初始化为FSK模式
-  // 频率: 434.0 MHz (测试), 比特率: 26.4 kbps
+  // 频率: 434.0 MHz (测试), 比特率: 采样率（AFSK 26.4 kbps，G3RUH 76.8 kbps）
   int state = radio.beginFSK(RF_FREQUENCY, RF_BITRATE, RF_DEVIATION);
   
   if (state != RADIOLIB_ERR_NONE) {
@@ -157,15 +192,22 @@ bool initRadio() {
   
   DEBUG_PRINTLN("SX1278初始化成功");
   
+#if MODEM_MODE == MODEM_G3RUH9600
+  // 9600波特：FSK直接模式，DIO2输出限幅后的基带数据，
+  // 不设置同步字（加扰后的前导没有固定图样）
+#else
   // 启用OOK模式用于直接解调
   radio.setOOK(true);
   
   // 设置直接模式同步字（AX.25前导码模式）
   // 0x3F03F03F 对应26.4kHz采样率下的AFSK模式
   radio.setDirectSyncWord(0x3F03F03F, 32);
+#endif
   
-  // 设置直接模式回调
+#if !USE_DMA_CAPTURE
+  // 设置直接模式回调（DMA采样时由定时器触发DMA读取DIO2，不使用逐采样回调）
   radio.setDirectAction(readBit);
+#endif
   
   // 启动直接模式接收
   radio.receiveDirect();
@@ -214,17 +256,77 @@ bool initUART() {
   delay(100);
   
   // 初始化APRS输出串口（UART1: PA9=TX, PA10=RX，9600 bps）
-  if (!aprsOutput.begin(Serial1, UART_BAUDRATE, USE_DMA)) {
+  if (!aprsOutput.begin(Serial1, UART_BAUDRATE)) {
     DEBUG_PRINTLN("UART初始化失败！");
     return false;
   }
   
+  // 输出格式：TNC2文本或KISS（可在运行时切换）
+  aprsOutput.setOutputFormat(UART_OUTPUT_FORMAT, KISS_PORT);
+  DEBUG_PRINTLN(UART_OUTPUT_FORMAT == UART_FORMAT_KISS ? "输出格式: KISS" : "输出格式: TNC2");
+  
   DEBUG_PRINTLN("UART初始化成功");
   DEBUG_PRINTLN("=================================");
   
   return true;
 }
 
+#if APRS_PROFILE
+/**
+ * 输出各阶段耗时（平均值为每个数据单位：采样/比特/事件/字节；百分位数为单次调用）
+ */
+void printProfile() {
+  DEBUG_PRINT("│ 耗时 (");
+  DEBUG_PRINT(PROFILE_UNIT);
+  DEBUG_PRINT(")，中断预算 ");
+  DEBUG_PRINT(PROFILE_ISR_BUDGET);
+  DEBUG_PRINTLN("");
+  
+  for (uint8_t i = 0; i < PROFILE_STAGE_COUNT; i++) {
+    ProfileSummary summary;
+    aprsProfileGetSummary(i, &summary);
+    if (summary.calls == 0) {
+      continue;
+    }
+    DEBUG_PRINT("│ ");
+    DEBUG_PRINT(aprsProfileStageName(i));
+    DEBUG_PRINT(": 平均/单位 ");
+    DEBUG_PRINT(summary.cyclesPerItemX100 / 100.0);
+    DEBUG_PRINT(", p50 ");
+    DEBUG_PRINT(summary.p50Cycles);
+    DEBUG_PRINT(", p99 ");
+    DEBUG_PRINT(summary.p99Cycles);
+    DEBUG_PRINT(", 最大 ");
+    DEBUG_PRINT(summary.maxCycles);
+    DEBUG_PRINTLN("");
+  }
+}
+#endif
+
+/**
+ * 输出静态内存预算（各部分大小、内存池使用量和总量）
+ */
+void printMemoryReport() {
+  DEBUG_PRINTLN("RAM预算:");
+  for (size_t i = 0; i < MEMORY_BUDGET_ENTRIES; i++) {
+    DEBUG_PRINT("  ");
+    DEBUG_PRINT(memoryBudget[i].name);
+    DEBUG_PRINT(": ");
+    DEBUG_PRINT(memoryBudget[i].bytes);
+    DEBUG_PRINTLN(memoryBudget[i].arena ? " 字节（内存池）" : " 字节");
+  }
+  DEBUG_PRINT("  内存池: ");
+  DEBUG_PRINT(memoryArena.getUsed());
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(memoryArena.getSize());
+  DEBUG_PRINTLN(" 字节");
+  DEBUG_PRINT("  合计: ");
+  DEBUG_PRINT(memoryBudgetTotal());
+  DEBUG_PRINT("/");
+  DEBUG_PRINT(MEMORY_BUDGET_BYTES);
+  DEBUG_PRINTLN(" 字节");
+}
+
 /**
  * 打印系统信息
  */
@@ -241,12 +343,15 @@ void printSystemInfo() {
   DEBUG_PRINT("解码器类型: ");
   DEBUG_PRINTLN(DECODER_TYPE);
   
+  DEBUG_PRINT("调制方式: ");
+  DEBUG_PRINTLN(MODEM_MODE == MODEM_G3RUH9600 ? "G3RUH 9600" : "AFSK 1200");
+  
   DEBUG_PRINT("采样率: ");
-  DEBUG_PRINT(AFSK_SAMPLE_RATE);
+  DEBUG_PRINT(MODEM_SAMPLE_RATE);
   DEBUG_PRINTLN(" Hz");
   
   DEBUG_PRINT("波特率: ");
-  DEBUG_PRINT(AFSK_BAUD_RATE);
+  DEBUG_PRINT(MODEM_BAUD_RATE);
   DEBUG_PRINTLN(" bps");
   
   #if HAS_FPU
@@ -257,10 +362,18 @@ void printSystemInfo() {
     DEBUG_PRINTLN("DSP: 已启用 (CMSIS-DSP)");
   #endif
   
-  #if USE_DMA
-    DEBUG_PRINTLN("DMA: 已启用");
+  #if USE_DMA_CAPTURE
+    DEBUG_PRINTLN("采样方式: 定时器触发DMA (GPIO)");
+  #else
+    DEBUG_PRINTLN("采样方式: 逐采样中断");
+  #endif
+  
+  #if USE_PACKED_SAMPLES
+    DEBUG_PRINTLN("采样格式: 位压缩 (32采样/字)");
   #endif
   
+  printMemoryReport();
+  
   DEBUG_PRINTLN("");
   DEBUG_PRINTLN("正在监听APRS信号...");
   DEBUG_PRINTLN("----------------------------------------");
@@ -276,6 +389,10 @@ void setup() {
     while (1) { delay(1000); }  // 停止运行
   }
   
+  #if APRS_PROFILE
+    aprsProfileBegin();
+  #endif
+  
   // 打印系统信息
   printSystemInfo();
   
@@ -292,14 +409,17 @@ void setup() {
   }
   
   // 启动采样定时器（备用方案，如果不使用RadioLib的直接回调）
-  // samplingTimer.begin(AFSK_SAMPLE_RATE, samplingTimerCallback);
+  // samplingTimer.begin(MODEM_SAMPLE_RATE, samplingTimerCallback);
   // samplingTimer.start();
   
-  // 初始化DMA（可选，用于批量处理）
-  #if USE_DMA
-    // dmaManager.begin(sampleBuffer1, sampleBuffer2, 
-    //                  SAMPLE_DMA_BUFFER_SIZE, dmaTransferCallback);
-    // dmaManager.start();
+  // DMA采样：定时器触发DMA读取DIO2，每半个缓冲区一次中断
+  #if USE_DMA_CAPTURE
+    if (!dmaManager.begin(MODEM_SAMPLE_RATE, SX127X_DIO2, dmaCaptureBuffer,
+                          DMA_CAPTURE_BUFFER_SIZE, dmaCaptureCallback)) {
+      DEBUG_PRINTLN("致命错误: DMA采样初始化失败！");
+      while (1) { delay(1000); }
+    }
+    dmaManager.start();
   #endif
   
   DEBUG_PRINTLN("系统就绪！");
@@ -309,13 +429,25 @@ void setup() {
 }
 
 void loop() {
-  // 检查是否有解码完成的帧
-  if (decoder.available()) {
+  #if USE_SAMPLE_RING
+    // 解码中断期间缓冲的采样
+    decoder.processRing(&sampleRing);
+  #endif
+  
+  // 输出队列中所有解码完成的帧
+  while (decoder.available()) {
     // 获取解码后的帧
     APRS_AX25Frame* frame = decoder.getFrame();
     
     if (frame != nullptr && frame->valid) {
-      // 发送到UART1
+      #if DUP_FILTER_ENABLE
+        // 时间窗口内的重复副本不输出
+        if (dupFilter.isDuplicate(frame, millis())) {
+          continue;
+        }
+      #endif
+      
+      // 写入UART1发送缓冲区（不阻塞）
       aprsOutput.sendAPRSFrame(frame);
       
       // 调试输出
@@ -325,37 +457,25 @@ void loop() {
       DEBUG_PRINTLN("╚════════════════════════════════════════╝");
       
       char callsign[16];
+      APRS_AX25Address addr;
       
       // 源呼号
       DEBUG_PRINT("源地址: ");
-      memset(callsign, 0, sizeof(callsign));
-      for (int i = 0; i < 7 && frame->source.callsign[i]; i++) {
-        callsign[i] = frame->source.callsign[i];
-      }
-      DEBUG_PRINT(callsign);
-      if (frame->source.ssid > 0) {
-        DEBUG_PRINT("-");
-        DEBUG_PRINT(frame->source.ssid);
-      }
-      DEBUG_PRINTLN("");
+      ax25GetSource(frame, &addr);
+      formatCallsign(callsign, &addr);
+      DEBUG_PRINTLN(callsign);
       
       // 目标呼号
       DEBUG_PRINT("目标地址: ");
-      memset(callsign, 0, sizeof(callsign));
-      for (int i = 0; i < 7 && frame->destination.callsign[i]; i++) {
-        callsign[i] = frame->destination.callsign[i];
-      }
-      DEBUG_PRINT(callsign);
-      if (frame->destination.ssid > 0) {
-        DEBUG_PRINT("-");
-        DEBUG_PRINT(frame->destination.ssid);
-      }
-      DEBUG_PRINTLN("");
+      ax25GetDestination(frame, &addr);
+      formatCallsign(callsign, &addr);
+      DEBUG_PRINTLN(callsign);
       
       // 信息字段
       DEBUG_PRINT("信息字段: ");
+      const uint8_t* info = ax25GetInfo(frame);
       for (uint16_t i = 0; i < frame->infoLen; i++) {
-        DEBUG_PRINT((char)frame->info[i]);
+        DEBUG_PRINT((char)info[i]);
       }
       DEBUG_PRINTLN("");
       
@@ -364,10 +484,18 @@ void loop() {
       DEBUG_PRINT(decoder.getSignalQuality());
       DEBUG_PRINTLN("%");
       
+      #if USE_MULTI_SLICER
+        DEBUG_PRINT("判决器: ");
+        DEBUG_PRINTLN(decoder.getFrameSlicer());
+      #endif
+      
       DEBUG_PRINTLN("----------------------------------------");
     }
   }
   
+  // 把发送缓冲区中的数据交给UART1
+  aprsOutput.service();
+  
   // 定期输出统计信息
   if (millis() - lastStatsTime >= STATS_INTERVAL) {
     DecoderStatistics* stats = decoder.getStatistics();
@@ -383,16 +511,86 @@ void loop() {
     DEBUG_PRINT("│ CRC错误: ");
     DEBUG_PRINT(stats->framesCRCError);
     DEBUG_PRINTLN("");
+    #if FIX_BITS_ENABLE
+      DEBUG_PRINT("│ 比特修复: ");
+      DEBUG_PRINT(stats->framesFixed);
+      DEBUG_PRINTLN("");
+    #endif
     DEBUG_PRINT("│ 接收字节: ");
     DEBUG_PRINT(stats->bytesReceived);
     DEBUG_PRINTLN("");
+    DEBUG_PRINT("│ 队列丢弃: ");
+    DEBUG_PRINT(stats->framesDropped);
+    DEBUG_PRINT(" 帧, 最大长度 ");
+    DEBUG_PRINT(stats->queueHighWater);
+    DEBUG_PRINT("/");
+    DEBUG_PRINT(FRAME_QUEUE_DEPTH);
+    DEBUG_PRINTLN("");
+    #if USE_SAMPLE_RING
+      DEBUG_PRINT("│ 采样溢出: ");
+      DEBUG_PRINT(stats->sampleOverflows);
+      DEBUG_PRINT(" 字, 最大占用 ");
+      DEBUG_PRINT(stats->ringHighWater);
+      DEBUG_PRINT("/");
+      DEBUG_PRINT(SAMPLE_RING_WORDS);
+      DEBUG_PRINTLN("");
+    #endif
+    #if USE_DMA_CAPTURE
+      DMACaptureStatistics* dmaStats = dmaManager.getStatistics();
+      DEBUG_PRINT("│ DMA采样: ");
+      DEBUG_PRINT(dmaStats->halfTransfers);
+      DEBUG_PRINT(" 半区, 溢出 ");
+      DEBUG_PRINT(dmaStats->overruns);
+      DEBUG_PRINTLN("");
+    #endif
+    #if ACTIVITY_GATE_ENABLE && !USE_MULTI_SLICER
+      ActivityStatistics* activity = decoder.getActivityStatistics();
+      DEBUG_PRINT("│ 活动占空比: ");
+      DEBUG_PRINT(decoder.getDutyCycle());
+      DEBUG_PRINT("%, 唤醒 ");
+      DEBUG_PRINT(activity->wakeups);
+      DEBUG_PRINTLN(" 次");
+    #endif
+    #if DUP_FILTER_ENABLE
+      DEBUG_PRINT("│ 重复抑制: ");
+      DEBUG_PRINT(dupFilter.getStatistics()->duplicates);
+      DEBUG_PRINTLN("");
+    #endif
+    UARTTxStatistics* txStats = aprsOutput.getStatistics();
+    DEBUG_PRINT("│ UART发送: ");
+    DEBUG_PRINT(txStats->bytesSent);
+    DEBUG_PRINT(" 字节, 丢弃 ");
+    DEBUG_PRINT(txStats->writesDropped);
+    DEBUG_PRINT(" 行, 最大占用 ");
+    DEBUG_PRINT(txStats->highWater);
+    DEBUG_PRINT("/");
+    DEBUG_PRINT(UART_TX_RING_SIZE);
+    DEBUG_PRINTLN("");
+    #if USE_MULTI_SLICER
+      // 各判决器的贡献：最先解出 / 独有
+      for (uint8_t i = 0; i < decoder.getNumSlicers(); i++) {
+        SlicerStatistics* ss = decoder.getSlicerStatistics(i);
+        DEBUG_PRINT("│ 判决器");
+        DEBUG_PRINT(i);
+        DEBUG_PRINT(": 最先 ");
+        DEBUG_PRINT(ss->framesFirst);
+        DEBUG_PRINT(" / 独有 ");
+        DEBUG_PRINT(ss->framesUnique);
+        DEBUG_PRINTLN("");
+      }
+    #endif
+    #if APRS_PROFILE
+      printProfile();
+    #endif
     DEBUG_PRINTLN("└────────────────────────────────────┘");
     DEBUG_PRINTLN("");
     
     lastStatsTime = millis();
   }
   
-  // 短暂延迟，避免CPU满载
-  delay(1);
+  #if !USE_SAMPLE_RING
+    // 短暂延迟，避免CPU满载
+    delay(1);
+  #endif
 }
 
@@ -0,0 +1,114 @@
+/**
+ * 信道活动检测实现
+ */
+
+#include "activity_detector.h"
+#include <string.h>
+
+ActivityDetector::ActivityDetector() {
+  begin(AFSK_SAMPLE_RATE, 2 * (AFSK_MARK_FREQ > AFSK_SPACE_FREQ ? AFSK_MARK_FREQ : AFSK_SPACE_FREQ));
+  resetStatistics();
+}
+
+void ActivityDetector::begin(uint32_t sampleRate, uint32_t signalRate) {
+  // 窗口内的跳变数：信号最多 signalRate / sampleRate 每采样，噪声约1/2每采样
+  uint32_t signalMax = (uint32_t)((uint64_t)ACTIVITY_WINDOW_SAMPLES * signalRate / sampleRate);
+  uint32_t noise = ACTIVITY_WINDOW_SAMPLES / 2;
+  if (signalMax > noise) {
+    signalMax = noise;
+  }
+  maxTransitions = (uint16_t)(signalMax + (((noise - signalMax) * ACTIVITY_NOISE_POSITION) >> 8));
+  minTransitions = (uint16_t)(signalMax / ACTIVITY_MIN_DIVISOR);
+  reset();
+}
+
+void ActivityDetector::reset() {
+  memset(counts, 0, sizeof(counts));
+  countPos = 0;
+  windowSum = 0;
+  lastWord = 0;
+  hangover = 0;
+  active = false;
+  lookbackPos = 0;
+  lookbackCount = 0;
+}
+
+bool ActivityDetector::update(uint32_t word) {
+  // 相邻采样的跳变：字内错位异或，最高位与上一个字的最后一个采样比较
+  uint8_t transitions = (uint8_t)popcount32(word ^ ((word >> 1) | (lastWord << 31)));
+  lastWord = word;
+
+  windowSum = (uint16_t)(windowSum - counts[countPos] + transitions);
+  counts[countPos] = transitions;
+  if (++countPos == ACTIVITY_WINDOW_WORDS) {
+    countPos = 0;
+  }
+  bool signal = windowSum >= minTransitions && windowSum <= maxTransitions;
+
+  if (active) {
+    stats.activeWords++;
+    if (signal) {
+      hangover = ACTIVITY_HANGOVER_WORDS;
+    } else if (hangover > 0 && --hangover == 0) {
+      active = false;
+      lookbackCount = 0;
+    }
+    return active;
+  }
+
+  // 空闲：保存历史，检测到信号时唤醒（该字随历史一起回放）
+  lookback[lookbackPos] = word;
+  if (++lookbackPos == ACTIVITY_LOOKBACK_WORDS) {
+    lookbackPos = 0;
+  }
+  if (lookbackCount < ACTIVITY_LOOKBACK_WORDS) {
+    lookbackCount++;
+  }
+
+  if (signal) {
+    active = true;
+    hangover = ACTIVITY_HANGOVER_WORDS;
+    stats.wakeups++;
+  } else {
+    stats.idleWords++;
+  }
+  return active;
+}
+
+bool ActivityDetector::isActive() {
+  return active;
+}
+
+uint8_t ActivityDetector::takeLookback(uint32_t* words) {
+  uint8_t n = lookbackCount;
+  uint8_t pos = (uint8_t)((lookbackPos + ACTIVITY_LOOKBACK_WORDS - n) % ACTIVITY_LOOKBACK_WORDS);
+  for (uint8_t i = 0; i < n; i++) {
+    words[i] = lookback[pos];
+    if (++pos == ACTIVITY_LOOKBACK_WORDS) {
+      pos = 0;
+    }
+  }
+
+  // 回放的字改计为活动时间（唤醒字之前未计入空闲）
+  uint32_t replayedIdle = (n > 1) ? (uint32_t)(n - 1) : 0;
+  stats.activeWords += n;
+  stats.idleWords -= (replayedIdle < stats.idleWords) ? replayedIdle : stats.idleWords;
+  lookbackCount = 0;
+  return n;
+}
+
+ActivityStatistics* ActivityDetector::getStatistics() {
+  return &stats;
+}
+
+void ActivityDetector::resetStatistics() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t ActivityDetector::getDutyCycle() {
+  uint32_t total = stats.activeWords + stats.idleWords;
+  if (total == 0) {
+    return 0;
+  }
+  return (uint8_t)((uint64_t)stats.activeWords * 100 / total);
+}
@@ -0,0 +1,124 @@
+/**
+ * 信道活动检测
+ *
+ * APRS信道大部分时间空闲，限幅后的1比特输入只有噪声（约每两个采样一次跳变）
+ * 或没有跳变（静噪、直流），解调器和解帧器却仍逐采样运行。
+ * 本检测器按位压缩字统计输入跳变数（每字一次异或和popcount），
+ * 在ACTIVITY_WINDOW_WORDS个字的滑动窗口内：
+ * - 跳变数低于下限：无信号（直流）
+ * - 跳变数高于上限：噪声（信号的跳变率受音调频率或波特率限制）
+ * - 介于两者之间：有信号，打开门控
+ * 空闲时保存最近ACTIVITY_LOOKBACK_WORDS个字，唤醒时先把这些采样送入解调器，
+ * 检测延迟期间的前导不会丢失；信号消失后保持ACTIVITY_HANGOVER_WORDS个字再关闭门控。
+ */
+
+#ifndef ACTIVITY_DETECTOR_H
+#define ACTIVITY_DETECTOR_H
+
+#include "aprs_config.h"
+#include "afsk_packed.h"
+#include <stdint.h>
+
+// 检测窗口（字）：8字 = 256个采样，26.4kHz下约10ms
+#ifndef ACTIVITY_WINDOW_WORDS
+  #define ACTIVITY_WINDOW_WORDS     8
+#endif
+
+// 唤醒时回放的历史（字）：须覆盖检测延迟（信号占窗口约1/3时唤醒）
+// 以及解调器滤波器和时钟恢复的建立时间，32字 = 1024个采样，1200波特下约46比特
+#ifndef ACTIVITY_LOOKBACK_WORDS
+  #define ACTIVITY_LOOKBACK_WORDS   32
+#endif
+
+// 信号消失后保持活动的字数（26.4kHz下约39ms，跨过帧内短暂的干扰）
+#ifndef ACTIVITY_HANGOVER_WORDS
+  #define ACTIVITY_HANGOVER_WORDS   32
+#endif
+
+// 跳变数上限在信号最大跳变数与噪声跳变数（窗口采样数/2）之间的位置 (Q8)
+// 偏向噪声一侧：低信噪比信号的跳变率高于干净信号
+#ifndef ACTIVITY_NOISE_POSITION
+  #define ACTIVITY_NOISE_POSITION   160
+#endif
+
+// 跳变数下限为信号最大跳变数的 1/ACTIVITY_MIN_DIVISOR
+#define ACTIVITY_MIN_DIVISOR        8
+
+#define ACTIVITY_WINDOW_SAMPLES     (ACTIVITY_WINDOW_WORDS * PACKED_SAMPLES_PER_WORD)
+
+// 活动统计（以字计，每字32个采样）
+typedef struct {
+  uint32_t activeWords;         // 送入解调器的字数（含唤醒时回放的历史）
+  uint32_t idleWords;           // 跳过的字数
+  uint32_t wakeups;             // 由空闲转为活动的次数
+} ActivityStatistics;
+
+class ActivityDetector {
+public:
+  ActivityDetector();
+
+  /**
+   * 按采样率和信号的跳变率计算门限
+   * @param sampleRate 采样率 (Hz)
+   * @param signalRate 有效信号在1比特输入上的最大跳变率（次/秒）
+   */
+  void begin(uint32_t sampleRate, uint32_t signalRate);
+
+  /**
+   * 清空窗口和历史，回到空闲状态（不清除统计）
+   */
+  void reset();
+
+  /**
+   * 输入一个字（最早的采样在最高位）
+   * 空闲时该字存入回放历史；返回true且之前为空闲时，调用者应取出历史送入解调器
+   * @return 输入该字之后是否处于活动状态
+   */
+  bool update(uint32_t word);
+
+  /**
+   * 是否处于活动状态
+   */
+  bool isActive();
+
+  /**
+   * 取出回放历史（从旧到新）并清空
+   * @param words 输出，容量至少ACTIVITY_LOOKBACK_WORDS
+   * @return 字数
+   */
+  uint8_t takeLookback(uint32_t* words);
+
+  /**
+   * 获取统计信息
+   */
+  ActivityStatistics* getStatistics();
+
+  /**
+   * 重置统计信息
+   */
+  void resetStatistics();
+
+  /**
+   * 活动时间占比
+   * @return 0-100
+   */
+  uint8_t getDutyCycle();
+
+protected:
+  uint8_t counts[ACTIVITY_WINDOW_WORDS];    // 窗口内各字的跳变数
+  uint8_t countPos;
+  uint16_t windowSum;
+  uint16_t minTransitions;
+  uint16_t maxTransitions;
+  uint32_t lastWord;                        // 上一个字（最后一个采样用于跨字跳变）
+  uint16_t hangover;
+  bool active;
+
+  uint32_t lookback[ACTIVITY_LOOKBACK_WORDS];
+  uint8_t lookbackPos;
+  uint8_t lookbackCount;
+
+  ActivityStatistics stats;
+};
+
+#endif // ACTIVITY_DETECTOR_H
@@ -0,0 +1,105 @@
+/**
+ * 滑动窗口相关AFSK解调器实现
+ */
+
+#include "afsk_correlator.h"
+
+// 正弦表（256点，Q7）
+const int8_t afskSineTable[256] = {
+     0,    3,    6,    9,   12,   16,   19,   22,   25,   28,   31,   34,   37,   40,   43,   46,
+    49,   51,   54,   57,   60,   63,   65,   68,   71,   73,   76,   78,   81,   83,   85,   88,
+    90,   92,   94,   96,   98,  100,  102,  104,  106,  107,  109,  111,  112,  113,  115,  116,
+   117,  118,  120,  121,  122,  122,  123,  124,  125,  125,  126,  126,  126,  127,  127,  127,
+   127,  127,  127,  127,  126,  126,  126,  125,  125,  124,  123,  122,  122,  121,  120,  118,
+   117,  116,  115,  113,  112,  111,  109,  107,  106,  104,  102,  100,   98,   96,   94,   92,
+    90,   88,   85,   83,   81,   78,   76,   73,   71,   68,   65,   63,   60,   57,   54,   51,
+    49,   46,   43,   40,   37,   34,   31,   28,   25,   22,   19,   16,   12,    9,    6,    3,
+     0,   -3,   -6,   -9,  -12,  -16,  -19,  -22,  -25,  -28,  -31,  -34,  -37,  -40,  -43,  -46,
+   -49,  -51,  -54,  -57,  -60,  -63,  -65,  -68,  -71,  -73,  -76,  -78,  -81,  -83,  -85,  -88,
+   -90,  -92,  -94,  -96,  -98, -100, -102, -104, -106, -107, -109, -111, -112, -113, -115, -116,
+  -117, -118, -120, -121, -122, -122, -123, -124, -125, -125, -126, -126, -126, -127, -127, -127,
+  -127, -127, -127, -127, -126, -126, -126, -125, -125, -124, -123, -122, -122, -121, -120, -118,
+  -117, -116, -115, -113, -112, -111, -109, -107, -106, -104, -102, -100,  -98,  -96,  -94,  -92,
+   -90,  -88,  -85,  -83,  -81,  -78,  -76,  -73,  -71,  -68,  -65,  -63,  -60,  -57,  -54,  -51,
+   -49,  -46,  -43,  -40,  -37,  -34,  -31,  -28,  -25,  -22,  -19,  -16,  -12,   -9,   -6,   -3,
+};
+
+AFSKCorrelatorDemodulator::AFSKCorrelatorDemodulator() : AFSKDemodulator() {
+  windowLen = SAMPLES_PER_BIT;
+  markGain = CORR_GAIN_UNITY;
+  clockOffset = 0;
+  markStep = spaceStep = 0;
+  markWindowBack = spaceWindowBack = 0;
+  clockStep = 0;
+  reset();
+}
+
+bool AFSKCorrelatorDemodulator::begin() {
+  AFSKDemodulator::begin();
+  
+  // 相位步进 = freq / sampleRate * 2^32
+  markStep = (uint32_t)(((uint64_t)AFSK_MARK_FREQ << 32) / AFSK_SAMPLE_RATE);
+  spaceStep = (uint32_t)(((uint64_t)AFSK_SPACE_FREQ << 32) / AFSK_SAMPLE_RATE);
+  clockStep = (uint32_t)(((uint64_t)AFSK_BAUD_RATE << 32) / AFSK_SAMPLE_RATE);
+  
+  if (windowLen > CORR_MAX_WINDOW) {
+    windowLen = CORR_MAX_WINDOW;
+  }
+  if (windowLen == 0) {
+    windowLen = SAMPLES_PER_BIT;
+  }
+  markWindowBack = markStep * windowLen;
+  spaceWindowBack = spaceStep * windowLen;
+  
+  reset();
+  return true;
+}
+
+void AFSKCorrelatorDemodulator::reset() {
+  AFSKDemodulator::reset();
+  markPhase = spacePhase = 0;
+  markI = markQ = 0;
+  spaceI = spaceQ = 0;
+  history = 0;
+  
+  // 复位后窗口内视为全为-1的采样：初始累加和须与之一致，
+  // 否则这些采样移出窗口时会留下永久偏差
+  for (uint8_t k = 0; k < windowLen; k++) {
+    uint32_t mOld = markPhase - markStep * k;
+    uint32_t sOld = spacePhase - spaceStep * k;
+    markI -= COS_LOOKUP(mOld); markQ -= SIN_LOOKUP(mOld);
+    spaceI -= COS_LOOKUP(sOld); spaceQ -= SIN_LOOKUP(sOld);
+  }
+  
+  clockPhase = 0;
+  softValue = 0;
+  lastSoftPositive = false;
+}
+
+void AFSKCorrelatorDemodulator::setParams(const CorrelatorParams* params) {
+  windowLen = params->windowLen;
+  markGain = params->markGain;
+  if (markGain > CORR_GAIN_MAX) {
+    markGain = CORR_GAIN_MAX;
+  }
+  clockOffset = params->clockOffset;
+}
+
+bool AFSKCorrelatorDemodulator::processSample(uint8_t sample) {
+  uint8_t bit;
+  return processSamples(&sample, 1, &bit) > 0;
+}
+
+uint16_t AFSKCorrelatorDemodulator::processSamples(const uint8_t* samples, uint16_t count, 
+                                                   uint8_t* bits) {
+  return correlateBlock(samples, count, bits, runtimeSteps());
+}
+
+uint16_t AFSKCorrelatorDemodulator::processPackedSamples(const uint32_t* words, uint16_t count,
+                                                         uint8_t* bits) {
+  return correlatePackedBlock(words, count, bits, runtimeSteps());
+}
+
+int32_t AFSKCorrelatorDemodulator::getSoftValue() {
+  return softValue;
+}
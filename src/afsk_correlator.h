@@ -0,0 +1,270 @@
+/**
+ * 滑动窗口相关AFSK解调器
+ * 
+ * 与块Goertzel解调器（每比特清空一次滤波器）不同，
+ * 本解调器在每个采样点上维护一个长度为一个比特的滑动窗口正交相关：
+ * - Mark/Space各自维护I/Q累加和，每个采样加入新项并减去移出窗口的旧项
+ * - 参考信号由相位累加器和8位正弦表产生，全部为整数运算
+ * - 每个采样输出软判决值 (Mark能量 - Space能量)
+ * - 时钟恢复在软判决值的过零点上调整相位，在比特中点采样
+ * 
+ * 适用于弱信号和定时偏移较大的数据包
+ */
+
+#ifndef AFSK_CORRELATOR_H
+#define AFSK_CORRELATOR_H
+
+#include "afsk_demod.h"
+#include <string.h>
+
+// 相关窗口最大长度（采样历史保存在64位移位寄存器中）
+#define CORR_MAX_WINDOW     64
+
+// 时钟恢复：检测到过零时将相位拉向目标的比例 (1 - 1/4)
+#define CORR_CLOCK_INERTIA_SHIFT  2
+
+// 每次调整最多前移半个比特的1/4即1/8比特，加上每比特至少8个采样，每个采样最多前进1/4比特
+static_assert(CORR_CLOCK_INERTIA_SHIFT >= 2, "时钟调整过大，输出比特数可能超过AFSK_MAX_BITS_PER_BLOCK");
+
+// Mark能量增益单位（Q8，256 = 1.0）
+#define CORR_GAIN_UNITY     256
+#define CORR_GAIN_MAX       (4 * CORR_GAIN_UNITY)   // 能量计算不溢出int32的上限
+
+// 正弦表（256点，Q7），由相位累加器的高8位索引
+extern const int8_t afskSineTable[256];
+
+// 相位累加器取表：高8位为索引，余弦超前90度（64点）
+#define SIN_LOOKUP(phase)   afskSineTable[(phase) >> 24]
+#define COS_LOOKUP(phase)   afskSineTable[(((phase) >> 24) + 64) & 0xFF]
+
+// 能量换算回以±1采样为单位（正弦表为Q7，能量为Q14）
+#define ENERGY_SHIFT        14
+
+// 运行时的步进参数（begin()中由aprs_config.h计算），与ModemProfile的同名编译期常量对应
+typedef struct {
+  uint32_t markStep;
+  uint32_t spaceStep;
+  uint32_t clockStep;
+  uint32_t markWindowBack;
+  uint32_t spaceWindowBack;
+  uint8_t windowLen;
+} CorrelatorSteps;
+
+// 解调参数（多判决器组中各变体的差异）
+typedef struct {
+  uint8_t windowLen;        // 相关窗口长度（采样），越短带宽越宽
+  uint16_t markGain;        // Mark能量增益 (Q8)，补偿加重造成的Mark/Space失衡
+  int32_t clockOffset;      // 判决时刻相对比特中点的偏移（2^32 = 一个比特周期）
+} CorrelatorParams;
+
+class AFSKCorrelatorDemodulator : public AFSKDemodulator {
+public:
+  AFSKCorrelatorDemodulator();
+  
+  /**
+   * 初始化解调器（计算相位步进）
+   */
+  bool begin() override;
+  
+  /**
+   * 处理单个采样点
+   */
+  bool processSample(uint8_t sample) override;
+  
+  /**
+   * 批量处理采样
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+  
+  /**
+   * 批量处理位压缩采样（逐字解包后直接进入相关核心，不经过虚函数）
+   */
+  uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) override;
+  
+  /**
+   * 重置解调器状态
+   */
+  void reset() override;
+  
+  /**
+   * 设置解调参数（在begin之前调用）
+   * @param params 解调参数
+   */
+  void setParams(const CorrelatorParams* params);
+  
+  /**
+   * 获取最近一个采样的软判决值
+   * @return Mark能量 - Space能量（正值倾向比特1）
+   */
+  int32_t getSoftValue();
+
+protected:
+  /**
+   * 时钟恢复（每个采样调用一次）
+   * 软判决值过零点应位于比特边界（相位0附近，加上偏移），
+   * 相位由正溢出到负时为比特中点
+   * @param positive 当前软判决值是否为正
+   * @param softPositive 上一个软判决值的符号（输入输出）
+   * @param clock 时钟相位（输入输出）
+   * @return 到达比特中点（应进行判决）时返回true
+   */
+  static inline bool clockRecovery(bool positive, bool& softPositive, uint32_t& clock,
+                                   uint32_t step, uint32_t offset) {
+    if (positive != softPositive) {
+      int32_t p = (int32_t)(clock - offset);
+      uint32_t adjusted = (uint32_t)(p - (p >> CORR_CLOCK_INERTIA_SHIFT)) + offset;
+      // 调整不得越过判决点（符号改变），否则偏移非0时会重复判决或漏判
+      if ((int32_t)(adjusted ^ clock) >= 0) {
+        clock = adjusted;
+      }
+      softPositive = positive;
+    }
+    uint32_t prev = clock;
+    clock += step;
+    return (int32_t)prev >= 0 && (int32_t)clock < 0;
+  }
+  
+  /**
+   * 相关核心：滑动窗口相关、软判决和时钟恢复
+   * Steps提供markStep、spaceStep、clockStep、markWindowBack、spaceWindowBack、windowLen：
+   * 运行时为CorrelatorSteps，AFSKProfileDemodulator传入ModemProfile，各量为编译期常量
+   */
+  template <class Steps>
+  inline uint16_t correlateBlock(const uint8_t* samples, uint16_t count, uint8_t* bits, const Steps& steps) {
+    // 将状态载入局部变量
+    uint32_t mPhase = markPhase, sPhase = spacePhase;
+    int32_t mI = markI, mQ = markQ;
+    int32_t sI = spaceI, sQ = spaceQ;
+    uint64_t hist = history;
+    uint32_t clock = clockPhase;
+    bool softPositive = lastSoftPositive;
+    int32_t soft = softValue;
+    
+    const uint8_t oldestShift = steps.windowLen - 1;
+    const uint32_t gain = markGain;
+    const uint32_t offset = (uint32_t)clockOffset;
+    const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+    uint16_t numBits = 0;
+    
+    for (uint16_t i = 0; i < count; i++) {
+      // 新采样和移出窗口的旧采样 (0或1)
+      uint8_t newSample = samples[i] ? 1 : 0;
+      uint8_t oldSample = (uint8_t)((hist >> oldestShift) & 1);
+      hist = (hist << 1) | newSample;
+      
+      mPhase += steps.markStep;
+      sPhase += steps.spaceStep;
+      uint32_t mOld = mPhase - steps.markWindowBack;
+      uint32_t sOld = sPhase - steps.spaceWindowBack;
+      
+      // 加入新项（采样为±1，直接加减参考值）
+      if (newSample) {
+        mI += COS_LOOKUP(mPhase); mQ += SIN_LOOKUP(mPhase);
+        sI += COS_LOOKUP(sPhase); sQ += SIN_LOOKUP(sPhase);
+      } else {
+        mI -= COS_LOOKUP(mPhase); mQ -= SIN_LOOKUP(mPhase);
+        sI -= COS_LOOKUP(sPhase); sQ -= SIN_LOOKUP(sPhase);
+      }
+      
+      // 减去移出窗口的旧项
+      if (oldSample) {
+        mI -= COS_LOOKUP(mOld); mQ -= SIN_LOOKUP(mOld);
+        sI -= COS_LOOKUP(sOld); sQ -= SIN_LOOKUP(sOld);
+      } else {
+        mI += COS_LOOKUP(mOld); mQ += SIN_LOOKUP(mOld);
+        sI += COS_LOOKUP(sOld); sQ += SIN_LOOKUP(sOld);
+      }
+      
+      // 软判决值
+      int32_t markE = (int32_t)(((int64_t)(mI * mI + mQ * mQ) * gain) >> 8);
+      int32_t spaceE = sI * sI + sQ * sQ;
+      soft = markE - spaceE;
+      
+      // 时钟恢复，在比特中点进行判决
+      bool positive = soft > 0;
+      if (clockRecovery(positive, softPositive, clock, steps.clockStep, offset) && numBits < maxBits) {
+        uint8_t newBit = positive ? 1 : 0;
+        updateDecision(newBit, (uint16_t)(markE >> ENERGY_SHIFT), (uint16_t)(spaceE >> ENERGY_SHIFT));
+        bits[numBits++] = newBit;
+      }
+    }
+    
+    // 写回状态
+    markPhase = mPhase; spacePhase = sPhase;
+    markI = mI; markQ = mQ;
+    spaceI = sI; spaceQ = sQ;
+    history = hist;
+    clockPhase = clock;
+    lastSoftPositive = softPositive;
+    softValue = soft;
+    
+    return numBits;
+  }
+  
+  /**
+   * 位压缩采样的相关核心：逐字解包后调用correlateBlock
+   */
+  template <class Steps>
+  inline uint16_t correlatePackedBlock(const uint32_t* words, uint16_t count, uint8_t* bits, const Steps& steps) {
+    uint8_t samples[32];
+    uint8_t wordBits[AFSK_MAX_BITS_PER_BLOCK(32)];
+    const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK((uint32_t)count * 32);
+    uint16_t numBits = 0;
+    
+    for (uint16_t w = 0; w < count; w++) {
+      uint32_t word = words[w];
+      for (uint8_t i = 0; i < 32; i++) {
+        samples[i] = (uint8_t)((word >> (31 - i)) & 1);
+      }
+      // 逐字的上限之和大于整块的上限，按整块的上限截断
+      uint16_t n = correlateBlock(samples, 32, wordBits, steps);
+      if (n > maxBits - numBits) {
+        n = maxBits - numBits;
+      }
+      memcpy(bits + numBits, wordBits, n);
+      numBits += n;
+    }
+    
+    return numBits;
+  }
+  
+  /**
+   * 当前的运行时步进参数
+   */
+  CorrelatorSteps runtimeSteps() const {
+    CorrelatorSteps steps = { markStep, spaceStep, clockStep, markWindowBack, spaceWindowBack, windowLen };
+    return steps;
+  }
+  
+  // 参考信号相位累加器（高8位为正弦表索引）
+  uint32_t markPhase;
+  uint32_t spacePhase;
+  uint32_t markStep;
+  uint32_t spaceStep;
+  
+  // 窗口起点相对当前相位的回退量 (windowLen * step)
+  uint32_t markWindowBack;
+  uint32_t spaceWindowBack;
+  
+  // 滑动窗口相关累加和
+  int32_t markI, markQ;
+  int32_t spaceI, spaceQ;
+  
+  // 采样历史（bit0为最新采样）
+  uint64_t history;
+  uint8_t windowLen;
+  
+  // Mark/Space增益平衡 (Q8)
+  uint16_t markGain;
+  
+  // 时钟恢复：相位从正溢出到负时在比特中点判决
+  uint32_t clockPhase;
+  uint32_t clockStep;
+  int32_t clockOffset;
+  
+  // 软判决输出
+  int32_t softValue;
+  bool lastSoftPositive;
+};
+
+#endif // AFSK_CORRELATOR_H
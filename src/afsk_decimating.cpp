@@ -0,0 +1,176 @@
+/**
+ * 降采样前端的滑动窗口相关解调器实现
+ */
+
+#include "afsk_decimating.h"
+#include <string.h>
+
+AFSKDecimatingDemodulator::AFSKDecimatingDemodulator() : AFSKCorrelatorDemodulator() {
+  decimation = AFSK_DECIMATION;
+  cicOrder = AFSK_CIC_ORDER;
+  windowLen = 0;    // begin时按抽取后的每比特采样数设置
+  energyShift = ENERGY_SHIFT;
+  reset();
+}
+
+void AFSKDecimatingDemodulator::setDecimation(uint8_t factor, uint8_t order) {
+  decimation = factor;
+  cicOrder = order;
+  windowLen = 0;
+}
+
+bool AFSKDecimatingDemodulator::begin() {
+  AFSKDemodulator::begin();
+  
+  if (!decimator.begin(decimation, cicOrder)) {
+    return false;
+  }
+  
+  // 抽取后的采样率须为波特率的整数倍，且每比特至少8个采样
+  uint32_t rate = AFSK_SAMPLE_RATE / decimation;
+  if (rate % AFSK_BAUD_RATE != 0 || rate / AFSK_BAUD_RATE < 8) {
+    return false;
+  }
+  
+  // 相位步进 = freq / rate * 2^32
+  markStep = (uint32_t)(((uint64_t)AFSK_MARK_FREQ << 32) / rate);
+  spaceStep = (uint32_t)(((uint64_t)AFSK_SPACE_FREQ << 32) / rate);
+  clockStep = (uint32_t)(((uint64_t)AFSK_BAUD_RATE << 32) / rate);
+  
+  if (windowLen > CORR_MAX_WINDOW) {
+    windowLen = CORR_MAX_WINDOW;
+  }
+  if (windowLen == 0) {
+    windowLen = (uint8_t)(rate / AFSK_BAUD_RATE);
+  }
+  markWindowBack = markStep * windowLen;
+  spaceWindowBack = spaceStep * windowLen;
+  
+  // 电平为±2^levelShift，能量按其平方归一化
+  energyShift = (uint8_t)(ENERGY_SHIFT + 2 * decimator.getLevelShift());
+  
+  reset();
+  return true;
+}
+
+void AFSKDecimatingDemodulator::reset() {
+  AFSKCorrelatorDemodulator::reset();
+  
+  // 窗口内为零电平（与抽取器复位后的输出一致），累加和从0开始
+  markI = markQ = 0;
+  spaceI = spaceQ = 0;
+  memset(levelHistory, 0, sizeof(levelHistory));
+  historyPos = 0;
+  decimator.reset();
+}
+
+bool AFSKDecimatingDemodulator::processSample(uint8_t sample) {
+  uint8_t bit;
+  return processSamples(&sample, 1, &bit) > 0;
+}
+
+uint16_t AFSKDecimatingDemodulator::processSamples(const uint8_t* samples, uint16_t count,
+                                                   uint8_t* bits) {
+  int16_t levels[DECIM_BATCH_LEVELS];
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numLevels = 0;
+  uint16_t numBits = 0;
+  
+  for (uint16_t i = 0; i < count; i++) {
+    if (decimator.push(samples[i] ? 1 : 0, &levels[numLevels])) {
+      if (++numLevels == DECIM_BATCH_LEVELS) {
+        numBits += processLevels(levels, numLevels, bits + numBits, maxBits - numBits);
+        numLevels = 0;
+      }
+    }
+  }
+  if (numLevels > 0) {
+    numBits += processLevels(levels, numLevels, bits + numBits, maxBits - numBits);
+  }
+  
+  return numBits;
+}
+
+uint16_t AFSKDecimatingDemodulator::processPackedSamples(const uint32_t* words, uint16_t count,
+                                                         uint8_t* bits) {
+  int16_t levels[DECIM_BATCH_WORDS * PACKED_SAMPLES_PER_WORD];
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK((uint32_t)count * PACKED_SAMPLES_PER_WORD);
+  uint16_t numBits = 0;
+  
+  while (count > 0) {
+    uint16_t n = count < DECIM_BATCH_WORDS ? count : DECIM_BATCH_WORDS;
+    uint16_t numLevels = decimator.process(words, n, levels);
+    numBits += processLevels(levels, numLevels, bits + numBits, maxBits - numBits);
+    words += n;
+    count -= n;
+  }
+  
+  return numBits;
+}
+
+uint16_t AFSKDecimatingDemodulator::processLevels(const int16_t* levels, uint16_t count,
+                                                  uint8_t* bits, uint16_t maxBits) {
+  // 将状态载入局部变量
+  uint32_t mPhase = markPhase, sPhase = spacePhase;
+  int32_t mI = markI, mQ = markQ;
+  int32_t sI = spaceI, sQ = spaceQ;
+  uint8_t pos = historyPos;
+  uint32_t clock = clockPhase;
+  bool softPositive = lastSoftPositive;
+  int32_t soft = softValue;
+  
+  const uint32_t mStep = markStep, sStep = spaceStep;
+  const uint32_t mBack = markWindowBack, sBack = spaceWindowBack;
+  const uint8_t window = windowLen;
+  const uint32_t gain = markGain;
+  const uint32_t offset = (uint32_t)clockOffset;
+  const uint8_t softShift = (uint8_t)(energyShift - ENERGY_SHIFT);
+  const uint8_t eShift = energyShift;
+  uint16_t numBits = 0;
+  
+  for (uint16_t i = 0; i < count; i++) {
+    // 新电平和移出窗口的旧电平
+    int32_t x = levels[i];
+    int32_t xOld = levelHistory[pos];
+    levelHistory[pos] = (int16_t)x;
+    if (++pos == window) {
+      pos = 0;
+    }
+    
+    mPhase += mStep;
+    sPhase += sStep;
+    uint32_t mOld = mPhase - mBack;
+    uint32_t sOld = sPhase - sBack;
+    
+    // 加入新项，减去旧项
+    mI += x * COS_LOOKUP(mPhase) - xOld * COS_LOOKUP(mOld);
+    mQ += x * SIN_LOOKUP(mPhase) - xOld * SIN_LOOKUP(mOld);
+    sI += x * COS_LOOKUP(sPhase) - xOld * COS_LOOKUP(sOld);
+    sQ += x * SIN_LOOKUP(sPhase) - xOld * SIN_LOOKUP(sOld);
+    
+    // 软判决值（电平为多位，能量以int64计算）
+    int64_t markE = (((int64_t)mI * mI + (int64_t)mQ * mQ) * gain) >> 8;
+    int64_t spaceE = (int64_t)sI * sI + (int64_t)sQ * sQ;
+    int64_t diff = markE - spaceE;
+    soft = (int32_t)(diff >> softShift);
+    
+    // 时钟恢复，在比特中点进行判决
+    bool positive = diff > 0;
+    if (clockRecovery(positive, softPositive, clock, clockStep, offset) && numBits < maxBits) {
+      uint8_t newBit = positive ? 1 : 0;
+      updateDecision(newBit, (uint16_t)(markE >> eShift), (uint16_t)(spaceE >> eShift));
+      bits[numBits++] = newBit;
+    }
+  }
+  
+  // 写回状态
+  markPhase = mPhase; spacePhase = sPhase;
+  markI = mI; markQ = mQ;
+  spaceI = sI; spaceQ = sQ;
+  historyPos = pos;
+  clockPhase = clock;
+  lastSoftPositive = softPositive;
+  softValue = soft;
+  
+  return numBits;
+}
@@ -0,0 +1,85 @@
+/**
+ * 降采样前端的滑动窗口相关解调器
+ *
+ * 输入为AFSK_SAMPLE_RATE的1比特采样，先经CICDecimator低通滤波并按因子R抽取为
+ * 多电平采样，再以 AFSK_SAMPLE_RATE / R 的采样率做与AFSKCorrelatorDemodulator
+ * 相同的正交相关、时钟恢复和判决：
+ * - 抽取前的低通滤波保留了1比特采样中的过零时刻信息，
+ *   比直接以低采样率采样（每个采样只有1比特）损失小
+ * - 相关解调（查表、乘加）只在抽取后的采样上进行，R = 2时每秒的相关运算减半
+ * 相关窗口中保存各电平采样（环形缓冲区），移出窗口时减去其贡献。
+ * 能量按电平增益归一化，置信度和载波检测与1比特相关解调器可比。
+ *
+ * 输入以位压缩格式处理最高效（DMA或ISR打包的字，每字一次抽取多个输出）；
+ * 每字节一个采样的输入逐个采样送入抽取器，每R个采样产生一个电平。
+ * getSampleRate()返回输入采样率，解码器的超时按输入采样计。
+ */
+
+#ifndef AFSK_DECIMATING_H
+#define AFSK_DECIMATING_H
+
+#include "afsk_correlator.h"
+#include "cic_decimator.h"
+
+// 每次抽取的压缩字数（限制栈上电平缓冲区的大小）
+#define DECIM_BATCH_WORDS   4
+
+// 每字节一个采样的输入：每次相关运算的电平数
+#define DECIM_BATCH_LEVELS  32
+
+class AFSKDecimatingDemodulator : public AFSKCorrelatorDemodulator {
+public:
+  AFSKDecimatingDemodulator();
+
+  /**
+   * 设置抽取参数（在begin之前调用）
+   * @param factor 抽取因子：1、2、4或8
+   * @param order CIC阶数 (1 - CIC_MAX_ORDER)
+   */
+  void setDecimation(uint8_t factor, uint8_t order);
+
+  /**
+   * 初始化解调器（按抽取后的采样率计算相位步进）
+   * @return 抽取参数无效，或抽取后每比特少于8个采样时返回false
+   */
+  bool begin() override;
+
+  /**
+   * 处理单个采样点
+   */
+  bool processSample(uint8_t sample) override;
+
+  /**
+   * 批量处理采样
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+
+  /**
+   * 批量处理压缩采样
+   */
+  uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) override;
+
+  /**
+   * 重置解调器状态
+   */
+  void reset() override;
+
+protected:
+  CICDecimator decimator;
+  uint8_t decimation;
+  uint8_t cicOrder;
+  uint8_t energyShift;                  // 能量归一化移位（ENERGY_SHIFT + 2 * 电平位数）
+
+  // 相关窗口中的电平采样（环形缓冲区）
+  int16_t levelHistory[CORR_MAX_WINDOW];
+  uint8_t historyPos;
+
+  /**
+   * 处理抽取后的电平采样
+   * @param maxBits 输出比特数组的剩余容量，超出的比特被丢弃
+   * @return 解调出的比特数
+   */
+  uint16_t processLevels(const int16_t* levels, uint16_t count, uint8_t* bits, uint16_t maxBits);
+};
+
+#endif // AFSK_DECIMATING_H
@@ -4,6 +4,7 @@
 
 #include "afsk_demod.h"
 #include <math.h>
+#include <string.h>
 
 // 数学常量
 #ifndef M_PI
@@ -11,6 +12,9 @@
 #endif
 
 AFSKDemodulator::AFSKDemodulator() {
+  confidenceOut = nullptr;
+  confidenceCount = 0;
+  confidenceCapacity = 0;
   reset();
 }
 
@@ -38,9 +42,15 @@ void AFSKDemodulator::reset() {
   bitReady = false;
   pllPhase = 0;
   pllDPhase = 0x10000 / SAMPLES_PER_BIT;  // 固定点数表示
+  midMarkQ1 = midMarkQ2 = 0;
+  midSpaceQ1 = midSpaceQ2 = 0;
+  lastSoft = 0;
+  midSoft = 0;
+  midPending = true;
   markEnergy = 0;
   spaceEnergy = 0;
   totalEnergy = 0;
+  bitConfidence = 0;
   carrierDetected = false;
   carrierLockCount = 0;
 }
@@ -53,70 +63,157 @@ void AFSKDemodulator::goertzelUpdate(float sample, float coeff, float &q1, float
 
 float AFSKDemodulator::goertzelMagnitude(float q1, float q2, float coeff) {
   // magnitude^2 = q1^2 + q2^2 - q1*q2*coeff
-  float real = q1 - q2 * coeff / 2.0f;
-  float imag = q2 * sin(acos(coeff / 2.0f));
-  return real * real + imag * imag;
+  // 与 (q1 - q2*coeff/2)^2 + (q2*sin(omega))^2 等价，无需每比特计算sin/acos
+  return q1 * q1 + q2 * q2 - q1 * q2 * coeff;
 }
 
 bool AFSKDemodulator::processSample(uint8_t sample) {
-  // 将样本转换为浮点数 (-1 或 +1)
-  float fsample = (sample == 0) ? -1.0f : 1.0f;
-  
-  // 更新Goertzel滤波器
-  goertzelUpdate(fsample, markCoeff, markQ1, markQ2);
-  goertzelUpdate(fsample, spaceCoeff, spaceQ1, spaceQ2);
-  
-  // 更新PLL相位
-  pllPhase += pllDPhase;
-  
-  // 采样计数
-  sampleCounter++;
+  uint8_t bit;
+  return processSamples(&sample, 1, &bit) != 0;
+}
+
+uint16_t AFSKDemodulator::processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) {
+  // 将状态载入局部变量，使编译器可以将其保存在寄存器中
+  const float mc = markCoeff;
+  const float sc = spaceCoeff;
+  float mq1 = markQ1, mq2 = markQ2;
+  float sq1 = spaceQ1, sq2 = spaceQ2;
+  float bm1 = midMarkQ1, bm2 = midMarkQ2;
+  float bs1 = midSpaceQ1, bs2 = midSpaceQ2;
+  int32_t phase = pllPhase;
+  bool pending = midPending;
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numBits = 0;
   
-  // 比特判决时刻
-  if (pllPhase >= 0x10000) {
-    pllPhase -= 0x10000;
+  for (uint16_t i = 0; i < count; i++) {
+    float fsample = (samples[i] == 0) ? -1.0f : 1.0f;
     
-    // 计算Mark和Space能量
-    float markMag = goertzelMagnitude(markQ1, markQ2, markCoeff);
-    float spaceMag = goertzelMagnitude(spaceQ1, spaceQ2, spaceCoeff);
+    float m0 = mc * mq1 - mq2 + fsample;
+    mq2 = mq1;
+    mq1 = m0;
     
-    // 判决：Mark能量大于Space能量 -> 比特1，否则 -> 比特0
-    uint8_t newBit = (markMag > spaceMag) ? 1 : 0;
+    float s0 = sc * sq1 - sq2 + fsample;
+    sq2 = sq1;
+    sq1 = s0;
     
-    // 检测跳变（用于PLL调整）
-    bool transition = (newBit != currentBit);
-    pllUpdate(transition);
+    float b0 = mc * bm1 - bm2 + fsample;
+    bm2 = bm1;
+    bm1 = b0;
     
-    currentBit = newBit;
-    bitReady = true;
+    b0 = sc * bs1 - bs2 + fsample;
+    bs2 = bs1;
+    bs1 = b0;
     
-    // 更新能量统计
-    markEnergy = (uint16_t)markMag;
-    spaceEnergy = (uint16_t)spaceMag;
-    totalEnergy = markEnergy + spaceEnergy;
+    phase += pllDPhase;
     
-    // 载波检测
-    if (totalEnergy > CARRIER_DETECT_THR) {
-      if (carrierLockCount < 255) carrierLockCount++;
-      if (carrierLockCount > 5) {
-        carrierDetected = true;
-      }
-    } else {
-      if (carrierLockCount > 0) carrierLockCount--;
-      if (carrierLockCount == 0) {
-        carrierDetected = false;
-      }
+    // 比特中点：结束跨边界窗口
+    if (pending && phase >= 0x8000) {
+      midSoft = softDecision(goertzelMagnitude(bm1, bm2, mc), goertzelMagnitude(bs1, bs2, sc));
+      bm1 = bm2 = 0;
+      bs1 = bs2 = 0;
+      pending = false;
     }
     
-    // 重置Goertzel状态（每比特周期）
-    markQ1 = markQ2 = 0;
-    spaceQ1 = spaceQ2 = 0;
-    sampleCounter = 0;
-    
-    return true;
+    if (phase >= 0x10000 && numBits < maxBits) {
+      phase -= 0x10000;
+      
+      // 比特判决（每比特一次）需要访问成员状态
+      markQ1 = mq1; markQ2 = mq2;
+      spaceQ1 = sq1; spaceQ2 = sq2;
+      pllPhase = phase;
+      
+      bits[numBits++] = decideBit();
+      
+      // 位同步可能调整了相位
+      phase = pllPhase;
+      pending = midPending;
+      mq1 = mq2 = 0;
+      sq1 = sq2 = 0;
+    }
+  }
+  
+  // 写回状态
+  markQ1 = mq1; markQ2 = mq2;
+  spaceQ1 = sq1; spaceQ2 = sq2;
+  midMarkQ1 = bm1; midMarkQ2 = bm2;
+  midSpaceQ1 = bs1; midSpaceQ2 = bs2;
+  pllPhase = phase;
+  midPending = pending;
+  sampleCounter = 0;
+  
+  return numBits;
+}
+
+uint16_t AFSKDemodulator::processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) {
+  uint8_t samples[32];
+  uint8_t wordBits[AFSK_MAX_BITS_PER_BLOCK(32)];
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK((uint32_t)count * 32);
+  uint16_t numBits = 0;
+  
+  for (uint16_t w = 0; w < count; w++) {
+    uint32_t word = words[w];
+    for (uint8_t i = 0; i < 32; i++) {
+      samples[i] = (uint8_t)((word >> (31 - i)) & 1);
+    }
+    // 逐字的上限之和大于整块的上限，按整块的上限截断
+    uint16_t n = processSamples(samples, 32, wordBits);
+    if (n > maxBits - numBits) {
+      n = maxBits - numBits;
+    }
+    memcpy(bits + numBits, wordBits, n);
+    numBits += n;
   }
   
-  return false;
+  return numBits;
+}
+
+uint8_t AFSKDemodulator::decideBit() {
+  // 计算Mark和Space能量
+  float markMag = goertzelMagnitude(markQ1, markQ2, markCoeff);
+  float spaceMag = goertzelMagnitude(spaceQ1, spaceQ2, spaceCoeff);
+  
+  // 判决：Mark能量大于Space能量 -> 比特1，否则 -> 比特0
+  uint8_t newBit = (markMag > spaceMag) ? 1 : 0;
+  
+  // 位同步
+  timingUpdate(softDecision(markMag, spaceMag));
+  updateDecision(newBit, (uint16_t)markMag, (uint16_t)spaceMag);
+  
+  // 重置Goertzel状态（每比特周期）
+  markQ1 = markQ2 = 0;
+  spaceQ1 = spaceQ2 = 0;
+  sampleCounter = 0;
+  
+  return newBit;
+}
+
+void AFSKDemodulator::updateDecision(uint8_t newBit, uint16_t markMag, uint16_t spaceMag) {
+  currentBit = newBit;
+  bitReady = true;
+  
+  // 置信度：能量差越小，判决越接近门限
+  bitConfidence = (markMag > spaceMag) ? (markMag - spaceMag) : (spaceMag - markMag);
+  if (confidenceOut != nullptr && confidenceCount < confidenceCapacity) {
+    confidenceOut[confidenceCount++] = bitConfidence;
+  }
+  
+  // 更新能量统计
+  markEnergy = markMag;
+  spaceEnergy = spaceMag;
+  totalEnergy = markEnergy + spaceEnergy;
+  
+  // 载波检测
+  if (totalEnergy > CARRIER_DETECT_THR) {
+    if (carrierLockCount < 255) carrierLockCount++;
+    if (carrierLockCount > 5) {
+      carrierDetected = true;
+    }
+  } else {
+    if (carrierLockCount > 0) carrierLockCount--;
+    if (carrierLockCount == 0) {
+      carrierDetected = false;
+    }
+  }
 }
 
 void AFSKDemodulator::pllUpdate(bool transition) {
@@ -133,17 +230,44 @@ void AFSKDemodulator::pllUpdate(bool transition) {
     }
     
     // 限制PLL频率调整范围
-    int16_t nominal = 0x10000 / SAMPLES_PER_BIT;
+    int32_t nominal = 0x10000 / SAMPLES_PER_BIT;
     if (pllDPhase < nominal - 100) pllDPhase = nominal - 100;
     if (pllDPhase > nominal + 100) pllDPhase = nominal + 100;
   }
 }
 
+int32_t AFSKDemodulator::softDecision(float markMag, float spaceMag) {
+  float total = markMag + spaceMag;
+  if (total <= 0) return 0;
+  return (int32_t)((markMag - spaceMag) / total * 32768.0f);
+}
+
+void AFSKDemodulator::timingUpdate(int32_t soft) {
+  // 只在跳变处调整：没有跳变时跨边界窗口不含定时信息
+  if ((soft ^ lastSoft) < 0) {
+    // Q15 × Q15 -> Q15，范围 ±2.0；窗口滞后时误差为负，相位前移使判决提前
+    int32_t error = (int32_t)(((int64_t)midSoft * (lastSoft - soft)) >> 15);
+    pllPhase -= error >> AFSK_GOERTZEL_TIMING_SHIFT;
+  }
+  lastSoft = soft;
+  midPending = true;
+}
+
 uint8_t AFSKDemodulator::getDemodulatedBit() {
   bitReady = false;
   return currentBit;
 }
 
+uint16_t AFSKDemodulator::getBitConfidence() {
+  return bitConfidence;
+}
+
+void AFSKDemodulator::setConfidenceOutput(uint16_t* buffer, uint16_t capacity) {
+  confidenceOut = buffer;
+  confidenceCount = 0;
+  confidenceCapacity = capacity;
+}
+
 uint8_t AFSKDemodulator::getSignalQuality() {
   if (totalEnergy == 0) return 0;
   
@@ -161,3 +285,10 @@ bool AFSKDemodulator::isCarrierDetected() {
   return carrierDetected;
 }
 
+uint32_t AFSKDemodulator::getSampleRate() {
+  return AFSK_SAMPLE_RATE;
+}
+
+uint32_t AFSKDemodulator::getTransitionRate() {
+  return 2 * (AFSK_MARK_FREQ > AFSK_SPACE_FREQ ? AFSK_MARK_FREQ : AFSK_SPACE_FREQ);
+}
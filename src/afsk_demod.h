@@ -11,6 +11,19 @@
 #include "aprs_config.h"
 #include <stdint.h>
 
+// 批量解调时输出比特数的上限
+// 相关解调器的时钟每次跳变最多前移半个比特的1/4，噪声中每个采样最多前进
+// 1/每比特采样数 + 1/8 比特。模板解调器的调制配置要求每比特至少8个采样
+// （见modem_profile.h），即每个采样最多1/4比特（Goertzel解调器约1/21）
+// 各解调器在批量输出达到该上限时丢弃多余的比特，保证不越过调用者的数组
+#define AFSK_MAX_BITS_PER_BLOCK(count)  ((count) / 4 + 2)
+
+// Goertzel位同步：跳变处按跨比特边界窗口的软判决调整相位，调整量为定时误差的 1/8
+// 定时误差（Q15）最大为2.0，对应每次调整最多1/8比特
+#define AFSK_GOERTZEL_TIMING_SHIFT  3
+
+static_assert(AFSK_GOERTZEL_TIMING_SHIFT >= 3, "时钟调整过大，输出比特数可能超过AFSK_MAX_BITS_PER_BLOCK");
+
 class AFSKDemodulator {
 public:
   AFSKDemodulator();
@@ -27,12 +40,46 @@ public:
    */
   virtual bool processSample(uint8_t sample);
   
+  /**
+   * 批量处理采样
+   * 滤波器和PLL状态在整个数据块内保存在局部变量中
+   * @param samples 采样数组 (0或1)
+   * @param count 采样数量
+   * @param bits 输出比特数组（每字节一个比特），
+   *             容量至少为 AFSK_MAX_BITS_PER_BLOCK(count)
+   * @return 解调出的比特数
+   */
+  virtual uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits);
+  
+  /**
+   * 批量处理位压缩采样（每个uint32_t含32个采样，最早的采样在最高位）
+   * 默认实现解包后调用processSamples，位压缩解调器直接在字上处理
+   * @param words 压缩采样数组
+   * @param count 字数
+   * @param bits 输出比特数组，容量至少为 AFSK_MAX_BITS_PER_BLOCK(count * 32)
+   * @return 解调出的比特数
+   */
+  virtual uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits);
+  
   /**
    * 获取解调后的比特
    * @return 解调后的比特值 (0或1)
    */
   uint8_t getDemodulatedBit();
   
+  /**
+   * 获取最近一次判决的置信度（Mark/Space能量差的绝对值）
+   */
+  uint16_t getBitConfidence();
+  
+  /**
+   * 设置批量解调时的置信度输出数组
+   * 设置后每判决出一个比特，其置信度依次写入该数组（与比特数组一一对应）
+   * @param buffer 置信度数组，容量同比特数组；nullptr表示不输出
+   * @param capacity 数组容量，超出部分不写入
+   */
+  void setConfidenceOutput(uint16_t* buffer, uint16_t capacity = 0);
+  
   /**
    * 重置解调器状态
    */
@@ -48,6 +95,17 @@ public:
    * 是否检测到载波
    */
   bool isCarrierDetected();
+  
+  /**
+   * 解调器的采样率（Hz），解码器据此换算以采样计的超时
+   */
+  virtual uint32_t getSampleRate();
+  
+  /**
+   * 有效信号在1比特输入上的最大跳变率（次/秒），用于活动检测
+   * AFSK为较高音调频率的2倍
+   */
+  virtual uint32_t getTransitionRate();
 
 protected:
   // Goertzel滤波器系数
@@ -58,6 +116,10 @@ protected:
   float markQ1, markQ2;
   float spaceQ1, spaceQ2;
   
+  // 跨比特边界的Goertzel滤波器（与判决窗口错开半个比特，用于位同步）
+  float midMarkQ1, midMarkQ2;
+  float midSpaceQ1, midSpaceQ2;
+  
   // 采样计数器
   uint8_t sampleCounter;
   
@@ -66,14 +128,23 @@ protected:
   bool bitReady;
   
   // PLL状态（用于比特同步）
-  int16_t pllPhase;
-  int16_t pllDPhase;
+  int32_t pllPhase;         // 相位累加器（0x10000 = 一个比特周期）
+  int32_t pllDPhase;        // 每个采样的相位增量
+  int32_t lastSoft;         // 上一比特的软判决（Q15）
+  int32_t midSoft;          // 最近一个跨边界窗口的软判决（Q15）
+  bool midPending;          // 本比特的跨边界窗口尚未结束
   
   // 信号检测
   uint16_t markEnergy;
   uint16_t spaceEnergy;
   uint16_t totalEnergy;
   
+  // 比特置信度
+  uint16_t bitConfidence;       // 最近一次判决的置信度
+  uint16_t* confidenceOut;      // 批量置信度输出（可为nullptr）
+  uint16_t confidenceCount;     // 已写入的置信度个数
+  uint16_t confidenceCapacity;  // 置信度数组容量
+  
   // 载波检测
   bool carrierDetected;
   uint8_t carrierLockCount;
@@ -94,9 +165,38 @@ protected:
   float goertzelMagnitude(float q1, float q2, float coeff);
   
   /**
-   * PLL位同步
+   * PLL位同步（APRSDecoderEnhanced使用）
    */
   void pllUpdate(bool transition);
+  
+  /**
+   * 软判决：(Mark - Space) / (Mark + Space)，Q15
+   */
+  static int32_t softDecision(float markMag, float spaceMag);
+  
+  /**
+   * 位同步（Gardner定时误差）
+   * 相邻比特跳变时，跨边界窗口正好居中于边界则其软判决为0；
+   * 窗口滞后时其中后一比特占多数，软判决与后一比特同号，反之与前一比特同号。
+   * 误差 = 跨边界软判决 × (前一比特 - 当前比特)，按比例调整pllPhase
+   * @param soft 当前比特的软判决（Q15）
+   */
+  void timingUpdate(int32_t soft);
+  
+  /**
+   * 比特判决（PLL相位溢出时调用）
+   * 根据当前Goertzel状态判决比特，调整位同步相位，更新载波检测，并清空滤波器
+   * @return 判决出的比特
+   */
+  uint8_t decideBit();
+  
+  /**
+   * 应用比特判决结果：更新当前比特、置信度、能量统计和载波检测
+   * @param newBit 判决出的比特
+   * @param markMag Mark能量（以±1采样为单位）
+   * @param spaceMag Space能量
+   */
+  void updateDecision(uint8_t newBit, uint16_t markMag, uint16_t spaceMag);
 };
 
 #endif // AFSK_DEMOD_H
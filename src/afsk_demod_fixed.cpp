@@ -0,0 +1,140 @@
+/**
+ * 定点AFSK解调器实现
+ */
+
+#include "afsk_demod_fixed.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 定点采样值
+#define SAMPLE_ONE   (1 << AFSK_FIXED_SAMPLE_SHIFT)
+
+// Goertzel迭代：q0 = coeff*q1 - q2 + x（乘积四舍五入回Q10）
+// 22个采样内状态幅度不超过约 60*1024，乘积不超过int32范围
+#define GOERTZEL_STEP_FIXED(x, coeff, q1, q2) do { \
+    int32_t q0 = ((coeff * q1 + (1 << (AFSK_FIXED_COEFF_SHIFT - 1))) >> AFSK_FIXED_COEFF_SHIFT) \
+                 - q2 + (x); \
+    q2 = q1; \
+    q1 = q0; \
+  } while (0)
+
+AFSKDemodulatorFixed::AFSKDemodulatorFixed() : AFSKDemodulator() {
+  markCoeffFixed = 0;
+  spaceCoeffFixed = 0;
+  reset();
+}
+
+bool AFSKDemodulatorFixed::begin() {
+  AFSKDemodulator::begin();
+  
+  // 系数只在初始化时计算一次
+  markCoeffFixed = (int32_t)lround(markCoeff * (1 << AFSK_FIXED_COEFF_SHIFT));
+  spaceCoeffFixed = (int32_t)lround(spaceCoeff * (1 << AFSK_FIXED_COEFF_SHIFT));
+  
+  reset();
+  return true;
+}
+
+void AFSKDemodulatorFixed::reset() {
+  AFSKDemodulator::reset();
+  markS1 = markS2 = 0;
+  spaceS1 = spaceS2 = 0;
+  midMarkS1 = midMarkS2 = 0;
+  midSpaceS1 = midSpaceS2 = 0;
+}
+
+int64_t AFSKDemodulatorFixed::goertzelEnergy(int32_t q1, int32_t q2, int32_t coeff) {
+  // magnitude^2 = q1^2 + q2^2 - q1*q2*coeff
+  int64_t cross = ((int64_t)q1 * q2 * coeff) >> AFSK_FIXED_COEFF_SHIFT;
+  return (int64_t)q1 * q1 + (int64_t)q2 * q2 - cross;
+}
+
+int32_t AFSKDemodulatorFixed::softDecisionFixed(int64_t markMag, int64_t spaceMag) {
+  int64_t total = markMag + spaceMag;
+  if (total <= 0) return 0;
+  // 每比特一次的64位除法
+  return (int32_t)(((markMag - spaceMag) << 15) / total);
+}
+
+uint8_t AFSKDemodulatorFixed::decideBitFixed() {
+  int64_t markMag = goertzelEnergy(markS1, markS2, markCoeffFixed);
+  int64_t spaceMag = goertzelEnergy(spaceS1, spaceS2, spaceCoeffFixed);
+  
+  uint8_t newBit = (markMag > spaceMag) ? 1 : 0;
+  timingUpdate(softDecisionFixed(markMag, spaceMag));
+  
+  // 能量统计换算回以±1采样为单位
+  updateDecision(newBit,
+                 (uint16_t)(markMag >> (2 * AFSK_FIXED_SAMPLE_SHIFT)),
+                 (uint16_t)(spaceMag >> (2 * AFSK_FIXED_SAMPLE_SHIFT)));
+  
+  markS1 = markS2 = 0;
+  spaceS1 = spaceS2 = 0;
+  sampleCounter = 0;
+  
+  return newBit;
+}
+
+bool AFSKDemodulatorFixed::processSample(uint8_t sample) {
+  uint8_t bit;
+  return processSamples(&sample, 1, &bit) != 0;
+}
+
+uint16_t AFSKDemodulatorFixed::processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) {
+  const int32_t mc = markCoeffFixed;
+  const int32_t sc = spaceCoeffFixed;
+  int32_t mq1 = markS1, mq2 = markS2;
+  int32_t sq1 = spaceS1, sq2 = spaceS2;
+  int32_t bm1 = midMarkS1, bm2 = midMarkS2;
+  int32_t bs1 = midSpaceS1, bs2 = midSpaceS2;
+  int32_t phase = pllPhase;
+  bool pending = midPending;
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numBits = 0;
+  
+  for (uint16_t i = 0; i < count; i++) {
+    int32_t x = (samples[i] == 0) ? -SAMPLE_ONE : SAMPLE_ONE;
+    
+    GOERTZEL_STEP_FIXED(x, mc, mq1, mq2);
+    GOERTZEL_STEP_FIXED(x, sc, sq1, sq2);
+    GOERTZEL_STEP_FIXED(x, mc, bm1, bm2);
+    GOERTZEL_STEP_FIXED(x, sc, bs1, bs2);
+    
+    phase += pllDPhase;
+    
+    if (pending && phase >= 0x8000) {
+      midSoft = softDecisionFixed(goertzelEnergy(bm1, bm2, mc), goertzelEnergy(bs1, bs2, sc));
+      bm1 = bm2 = 0;
+      bs1 = bs2 = 0;
+      pending = false;
+    }
+    
+    if (phase >= 0x10000 && numBits < maxBits) {
+      phase -= 0x10000;
+      
+      markS1 = mq1; markS2 = mq2;
+      spaceS1 = sq1; spaceS2 = sq2;
+      pllPhase = phase;
+      
+      bits[numBits++] = decideBitFixed();
+      
+      phase = pllPhase;
+      pending = midPending;
+      mq1 = mq2 = 0;
+      sq1 = sq2 = 0;
+    }
+  }
+  
+  markS1 = mq1; markS2 = mq2;
+  spaceS1 = sq1; spaceS2 = sq2;
+  midMarkS1 = bm1; midMarkS2 = bm2;
+  midSpaceS1 = bs1; midSpaceS2 = bs2;
+  pllPhase = phase;
+  midPending = pending;
+  sampleCounter = 0;
+  
+  return numBits;
+}
@@ -0,0 +1,74 @@
+/**
+ * 定点AFSK解调器
+ * 
+ * 针对无FPU的STM32（Cortex-M0+/M3）的Goertzel解调器：
+ * - 采样缩放为Q10（±1024），系数为Q14
+ * - 滤波器状态使用int32运算，每比特一次的能量计算使用int64
+ * - 比特判决、位同步和载波检测逻辑与浮点版本一致
+ * 
+ * 通过 AFSK_FIXED_POINT 在编译时选择
+ */
+
+#ifndef AFSK_DEMOD_FIXED_H
+#define AFSK_DEMOD_FIXED_H
+
+#include "afsk_demod.h"
+
+// 定点格式
+#define AFSK_FIXED_SAMPLE_SHIFT  10   // 采样幅度 Q10
+#define AFSK_FIXED_COEFF_SHIFT   14   // Goertzel系数 Q14
+
+class AFSKDemodulatorFixed : public AFSKDemodulator {
+public:
+  AFSKDemodulatorFixed();
+  
+  /**
+   * 初始化解调器（计算定点系数）
+   */
+  bool begin() override;
+  
+  /**
+   * 处理单个采样点（定点运算）
+   */
+  bool processSample(uint8_t sample) override;
+  
+  /**
+   * 批量处理采样（定点运算）
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+  
+  /**
+   * 重置解调器状态
+   */
+  void reset() override;
+
+protected:
+  // Goertzel系数 (Q14)
+  int32_t markCoeffFixed;
+  int32_t spaceCoeffFixed;
+  
+  // Goertzel滤波器状态 (Q10)
+  int32_t markS1, markS2;
+  int32_t spaceS1, spaceS2;
+  
+  // 跨比特边界的Goertzel滤波器状态 (Q10)
+  int32_t midMarkS1, midMarkS2;
+  int32_t midSpaceS1, midSpaceS2;
+  
+  /**
+   * 定点Goertzel能量 (Q20)
+   */
+  static int64_t goertzelEnergy(int32_t q1, int32_t q2, int32_t coeff);
+  
+  /**
+   * 软判决（定点版本，Q15）
+   */
+  static int32_t softDecisionFixed(int64_t markMag, int64_t spaceMag);
+  
+  /**
+   * 比特判决（定点版本）
+   */
+  uint8_t decideBitFixed();
+};
+
+#endif // AFSK_DEMOD_FIXED_H
@@ -0,0 +1,335 @@
+#include "afsk_generator.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+// 地址字段最多包含的地址数（目标、源和8个中继）
+#define GEN_MAX_ADDRESSES   10
+
+// 单个码元的抖动上限（码元周期的比例），保证码元边界单调
+#define GEN_MAX_JITTER      0.45f
+
+// G3RUH基带低通截止频率（波特率的比例）
+#define GEN_BASEBAND_BW     0.75
+
+// G3RUH加扰多项式抽头 (1 + x^12 + x^17)
+#define GEN_SCRAMBLE_TAP_A  12
+#define GEN_SCRAMBLE_TAP_B  17
+
+// CRC-16-CCITT（反转多项式0x8408），逐位计算，发生器不在热路径上
+static uint16_t crc16(const uint8_t* data, uint16_t length) {
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+    }
+  }
+  return (uint16_t)(crc ^ 0xFFFF);
+}
+
+/**
+ * 解析一个呼号（CALL[-SSID][*]）并编码为7字节地址
+ * @param text 呼号起始
+ * @param end 呼号结束（不含）
+ * @param output 地址输出
+ * @param command 目标地址的命令位（C位）
+ * @return 格式正确返回true
+ */
+static bool encodeAddress(const char* text, const char* end, uint8_t* output, bool command) {
+  bool repeated = false;
+  if (end > text && end[-1] == '*') {
+    repeated = true;
+    end--;
+  }
+
+  const char* dash = text;
+  while (dash < end && *dash != '-') {
+    dash++;
+  }
+  uint8_t callLen = (uint8_t)(dash - text);
+  if (callLen == 0 || callLen > 6) {
+    return false;
+  }
+
+  uint8_t ssid = 0;
+  if (dash < end) {
+    const char* p = dash + 1;
+    if (p == end || end - p > 2) {
+      return false;
+    }
+    for (; p < end; p++) {
+      if (*p < '0' || *p > '9') {
+        return false;
+      }
+      ssid = (uint8_t)(ssid * 10 + (*p - '0'));
+    }
+    if (ssid > 15) {
+      return false;
+    }
+  }
+
+  for (uint8_t i = 0; i < 6; i++) {
+    char c = (i < callLen) ? text[i] : ' ';
+    if (c >= 'a' && c <= 'z') {
+      c = (char)(c - 'a' + 'A');
+    }
+    output[i] = (uint8_t)(c << 1);
+  }
+  output[6] = (uint8_t)(0x60 | (ssid << 1));
+  if (command || repeated) {
+    output[6] |= 0x80;
+  }
+  return true;
+}
+
+AFSKGenerator::AFSKGenerator() {
+  begin();
+}
+
+void AFSKGenerator::begin(uint32_t seed) {
+  rngState = (seed != 0) ? seed : 1;
+  hasSpare = false;
+  spare = 0.0f;
+  phase = 0.0f;
+  level = 1;
+  symbol = 1;
+  scrambler = 0;
+  baseband = 0.0f;
+  output = nullptr;
+  outputMax = 0;
+  outputPos = 0;
+  symbolCount = 0;
+  samplesPerBit = SAMPLES_PER_BIT;
+  ampMark = 1.0f;
+  ampSpace = 1.0f;
+  sigma = 0.0f;
+  basebandAlpha = 1.0f;
+  defaultConfig(&config);
+}
+
+void AFSKGenerator::defaultConfig(AFSKGeneratorConfig* config) {
+  config->preambleFlags = 32;
+  config->tailFlags = 4;
+  config->snrDb = AFSK_GEN_SNR_CLEAN;
+  config->twistDb = 0.0f;
+  config->driftPpm = 0.0f;
+  config->jitter = 0.0f;
+  config->sampleRate = AFSK_SAMPLE_RATE;
+  config->baudRate = AFSK_BAUD_RATE;
+  config->markFreq = AFSK_MARK_FREQ;
+  config->spaceFreq = AFSK_SPACE_FREQ;
+  config->modulation = AFSK_GEN_AFSK;
+}
+
+void AFSKGenerator::setConfig(const AFSKGeneratorConfig* newConfig) {
+  config = *newConfig;
+}
+
+const AFSKGeneratorConfig* AFSKGenerator::getConfig() {
+  return &config;
+}
+
+uint32_t AFSKGenerator::nextRandom() {
+  uint32_t x = rngState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  rngState = x;
+  return x;
+}
+
+float AFSKGenerator::nextGaussian() {
+  if (hasSpare) {
+    hasSpare = false;
+    return spare;
+  }
+
+  // Box-Muller变换，u1取(0, 1]避免log(0)
+  float u1 = ((nextRandom() >> 8) + 1) * (1.0f / 16777216.0f);
+  float u2 = (nextRandom() >> 8) * (1.0f / 16777216.0f);
+  float r = sqrtf(-2.0f * logf(u1));
+  float theta = (float)(2.0 * M_PI) * u2;
+  spare = r * sinf(theta);
+  hasSpare = true;
+  return r * cosf(theta);
+}
+
+uint16_t AFSKGenerator::buildFrame(const char* tnc2, uint8_t* output, uint16_t maxLen) {
+  const char* colon = strchr(tnc2, ':');
+  const char* gt = strchr(tnc2, '>');
+  if (colon == nullptr || gt == nullptr || gt > colon) {
+    return 0;
+  }
+
+  // 地址：目标、源、中继路径
+  const char* start[GEN_MAX_ADDRESSES];
+  const char* end[GEN_MAX_ADDRESSES];
+  uint8_t count = 2;
+  start[1] = tnc2;
+  end[1] = gt;
+
+  const char* p = gt + 1;
+  start[0] = p;
+  while (p < colon && *p != ',') {
+    p++;
+  }
+  end[0] = p;
+  while (p < colon) {
+    if (count >= GEN_MAX_ADDRESSES) {
+      return 0;
+    }
+    start[count] = ++p;
+    while (p < colon && *p != ',') {
+      p++;
+    }
+    end[count++] = p;
+  }
+
+  uint16_t infoLen = (uint16_t)strlen(colon + 1);
+  uint16_t length = (uint16_t)(count * 7 + 2 + infoLen + 2);
+  if (length > maxLen || length > AX25_MAX_FRAME_LEN) {
+    return 0;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (!encodeAddress(start[i], end[i], &output[i * 7], i == 0)) {
+      return 0;
+    }
+  }
+  output[count * 7 - 1] |= 0x01;              // 地址扩展位：最后一个地址
+
+  uint16_t pos = (uint16_t)(count * 7);
+  output[pos++] = 0x03;                       // 控制字段：UI帧
+  output[pos++] = 0xF0;                       // PID：无第三层协议
+  memcpy(&output[pos], colon + 1, infoLen);
+  pos += infoLen;
+
+  uint16_t fcs = crc16(output, pos);
+  output[pos++] = (uint8_t)(fcs & 0xFF);      // FCS低字节先发
+  output[pos++] = (uint8_t)(fcs >> 8);
+  return pos;
+}
+
+uint32_t AFSKGenerator::getMaxSamples(uint16_t length) {
+  // 比特填充最多使数据增加1/5
+  uint32_t bits = (uint32_t)(config.preambleFlags + config.tailFlags) * 8 +
+                  (uint32_t)length * 8 * 6 / 5 + 8;
+  uint32_t nominal = (config.sampleRate + config.baudRate - 1) / config.baudRate;
+  double maxSamplesPerBit = (double)nominal * (1.0 + fabs(config.driftPpm) * 1e-6);
+  return (uint32_t)(bits * maxSamplesPerBit) + 2 * nominal;
+}
+
+bool AFSKGenerator::emitSymbol(float offset) {
+  double edge = (double)(symbolCount + 1) * samplesPerBit + offset;
+  float step = (float)(2.0 * M_PI * (symbol ? config.markFreq : config.spaceFreq) / config.sampleRate);
+  float amp = symbol ? ampMark : ampSpace;
+  float target = symbol ? 1.0f : -1.0f;
+
+  while ((double)outputPos < edge) {
+    if (outputPos >= outputMax) {
+      return false;
+    }
+    float value;
+    if (config.modulation == AFSK_GEN_G3RUH) {
+      baseband += basebandAlpha * (target - baseband);
+      value = baseband;
+    } else {
+      phase += step;
+      if (phase >= (float)(2.0 * M_PI)) {
+        phase -= (float)(2.0 * M_PI);
+      }
+      value = amp * sinf(phase);
+    }
+    if (sigma > 0.0f) {
+      value += sigma * nextGaussian();
+    }
+    output[outputPos++] = (value >= 0.0f) ? 1 : 0;
+  }
+  symbolCount++;
+  return true;
+}
+
+uint32_t AFSKGenerator::modulateFrame(const uint8_t* frame, uint16_t length,
+                                      uint8_t* samples, uint32_t maxSamples) {
+  output = samples;
+  outputMax = maxSamples;
+  outputPos = 0;
+  symbolCount = 0;
+  samplesPerBit = (double)config.sampleRate / (config.baudRate * (1.0 + config.driftPpm * 1e-6));
+  ampMark = powf(10.0f, config.twistDb / 40.0f);
+  ampSpace = 1.0f / ampMark;
+  basebandAlpha = (float)(1.0 - exp(-2.0 * M_PI * GEN_BASEBAND_BW * config.baudRate / config.sampleRate));
+
+  // 噪声：两个音调各占一半时间时的平均信号功率（基带信号为±1电平）
+  float signalPower = (config.modulation == AFSK_GEN_G3RUH) ? 1.0f
+                    : (ampMark * ampMark + ampSpace * ampSpace) / 4.0f;
+  sigma = (config.snrDb >= AFSK_GEN_SNR_CLEAN) ? 0.0f
+        : sqrtf(signalPower / powf(10.0f, config.snrDb / 10.0f));
+
+  float jitterRms = config.jitter * (float)samplesPerBit;
+  float jitterLimit = GEN_MAX_JITTER * (float)samplesPerBit;
+  uint32_t preambleBits = (uint32_t)config.preambleFlags * 8;
+  uint32_t flagBits = preambleBits + (uint32_t)config.tailFlags * 8;
+  uint32_t dataBits = (uint32_t)length * 8;
+  uint32_t flagPos = 0;             // 已输出的标志比特
+  uint32_t dataPos = 0;             // 已输出的数据比特
+  uint8_t ones = 0;                 // 连续1的个数（比特填充）
+
+  // 依次输出：前导标志、数据（比特填充）、结尾标志
+  for (;;) {
+    uint8_t bit;
+    if (flagPos < preambleBits || (dataPos == dataBits && ones < 5 && flagPos < flagBits)) {
+      bit = (0x7E >> (flagPos & 7)) & 1;
+      flagPos++;
+    } else if (ones == 5) {
+      bit = 0;                      // 连续5个1之后插入0
+      ones = 0;
+    } else if (dataPos < dataBits) {
+      bit = (frame[dataPos >> 3] >> (dataPos & 7)) & 1;
+      dataPos++;
+      ones = bit ? (uint8_t)(ones + 1) : 0;
+    } else {
+      break;
+    }
+
+    // NRZI：0翻转，1保持
+    if (bit == 0) {
+      level ^= 1;
+    }
+
+    // G3RUH加扰：y = x ^ y[-12] ^ y[-17]
+    symbol = level;
+    if (config.modulation == AFSK_GEN_G3RUH) {
+      symbol ^= (uint8_t)(((scrambler >> (GEN_SCRAMBLE_TAP_A - 1)) ^ (scrambler >> (GEN_SCRAMBLE_TAP_B - 1))) & 1);
+      scrambler = (scrambler << 1) | symbol;
+    }
+
+    float offset = 0.0f;
+    if (jitterRms > 0.0f) {
+      offset = jitterRms * nextGaussian();
+      if (offset > jitterLimit) offset = jitterLimit;
+      if (offset < -jitterLimit) offset = -jitterLimit;
+    }
+
+    if (!emitSymbol(offset)) {
+      return 0;
+    }
+  }
+
+  return outputPos;
+}
+
+void AFSKGenerator::generateNoise(uint8_t* samples, uint32_t count) {
+  uint32_t bits = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    if ((i & 31) == 0) {
+      bits = nextRandom();
+    }
+    samples[i] = bits & 1;
+    bits >>= 1;
+  }
+}
@@ -0,0 +1,153 @@
+/**
+ * Bell 202 AFSK测试信号发生器
+ *
+ * 将AX.25帧调制为与DIO2相同的1比特采样（默认采样率AFSK_SAMPLE_RATE），
+ * 用于解码率基准测试和回归测试，无需射频硬件或录音：
+ *
+ *   TNC2文本 → AX.25帧（含FCS） → 标志/比特填充 → NRZI → 相位连续AFSK
+ *            → 加性高斯噪声 → 过零判决（0/1采样）
+ *
+ * 可模拟的信道缺陷：
+ * - 信噪比：按整个采样带宽（0 - 采样率/2）计算，判决前加入高斯噪声
+ * - 预加重失衡（twist）：Mark与Space电平差
+ * - 时钟偏差：发送端码元速率偏离1200 bps（ppm）
+ * - 抖动：每个码元边界独立的随机偏移（码元周期的比例，均方根）
+ * - 前导长度：帧前后的标志数量
+ * - 调制参数：采样率、波特率和Mark/Space频率（默认为aprs_config.h的配置，
+ *   可改为modem_profile.h中的其他配置）
+ *
+ * 也可生成G3RUH 9600波特基带信号（modulation = AFSK_GEN_G3RUH）：NRZI之后经
+ * 1 + x^12 + x^17加扰，±1电平经一阶低通（模拟FM接收机的基带带宽）后加噪声判决，
+ * 此时Mark/Space频率和电平失衡不起作用。
+ *
+ * 随机数由内部的xorshift32生成，相同的种子和参数产生相同的采样序列。
+ * 发生器使用浮点运算，主要用于主机端；也可在带FPU的MCU上作为自检信号源。
+ */
+
+#ifndef AFSK_GENERATOR_H
+#define AFSK_GENERATOR_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+
+// 信噪比不低于此值时不加噪声
+#define AFSK_GEN_SNR_CLEAN      99.0f
+
+// 调制方式
+#define AFSK_GEN_AFSK           0       // Bell 202 AFSK
+#define AFSK_GEN_G3RUH          1       // G3RUH加扰基带FSK
+
+// 信道参数
+typedef struct {
+  uint16_t preambleFlags;   // 帧前标志数量
+  uint16_t tailFlags;       // 帧后标志数量
+  float snrDb;              // 信噪比（dB，全采样带宽），>= AFSK_GEN_SNR_CLEAN 时不加噪声
+  float twistDb;            // Mark相对Space的电平（dB，正值Mark更强）
+  float driftPpm;           // 码元时钟偏差（ppm，正值发送端偏快）
+  float jitter;             // 码元边界抖动（码元周期的比例，均方根）
+  uint32_t sampleRate;      // 采样率（Hz）
+  uint16_t baudRate;        // 波特率
+  uint16_t markFreq;        // Mark频率（Hz，逻辑1）
+  uint16_t spaceFreq;       // Space频率（Hz，逻辑0）
+  uint8_t modulation;       // 调制方式（AFSK_GEN_AFSK / AFSK_GEN_G3RUH）
+} AFSKGeneratorConfig;
+
+class AFSKGenerator {
+public:
+  AFSKGenerator();
+
+  /**
+   * 初始化随机数种子并恢复默认参数（无噪声、无失衡、32个前导标志）
+   * @param seed 随机数种子（0按1处理）
+   */
+  void begin(uint32_t seed = 1);
+
+  /**
+   * 设置信道参数
+   */
+  void setConfig(const AFSKGeneratorConfig* config);
+
+  /**
+   * 获取当前信道参数
+   */
+  const AFSKGeneratorConfig* getConfig();
+
+  /**
+   * 默认信道参数
+   */
+  static void defaultConfig(AFSKGeneratorConfig* config);
+
+  /**
+   * 由TNC2格式文本（SOURCE>DEST,PATH:INFO）构造AX.25 UI帧
+   * 路径中带'*'的地址置已转发（H）位
+   * @param tnc2 以'\0'结尾的TNC2文本
+   * @param output 帧缓冲区
+   * @param maxLen 缓冲区大小
+   * @return 帧长度（含FCS），格式错误或缓冲区不足时返回0
+   */
+  static uint16_t buildFrame(const char* tnc2, uint8_t* output, uint16_t maxLen);
+
+  /**
+   * 调制一帧（含前导和结尾标志）
+   * @param frame 帧数据（含FCS）
+   * @param length 帧长度
+   * @param samples 采样输出（每字节一个0/1采样）
+   * @param maxSamples 输出缓冲区容量，应不小于getMaxSamples(length)
+   * @return 写入的采样数，缓冲区不足时返回0
+   */
+  uint32_t modulateFrame(const uint8_t* frame, uint16_t length, uint8_t* samples, uint32_t maxSamples);
+
+  /**
+   * 生成无信号的信道噪声（静噪打开时的随机判决）
+   * @param samples 采样输出
+   * @param count 采样数
+   */
+  void generateNoise(uint8_t* samples, uint32_t count);
+
+  /**
+   * modulateFrame所需的最大采样数（按当前参数）
+   * @param length 帧长度（含FCS）
+   */
+  uint32_t getMaxSamples(uint16_t length);
+
+protected:
+  AFSKGeneratorConfig config;
+  uint32_t rngState;            // xorshift32状态
+  float spare;                  // Box-Muller产生的第二个正态随机数
+  bool hasSpare;
+  float phase;                  // 载波相位（弧度，调制帧之间连续）
+  uint8_t level;                // NRZI电平（1 = Mark）
+  uint8_t symbol;               // 当前发送的码元（AFSK为NRZI电平，G3RUH为加扰后的电平）
+  uint32_t scrambler;           // G3RUH加扰器移位寄存器（bit0为最近发送的码元）
+  float baseband;               // G3RUH基带低通滤波器状态
+
+  // 调制状态（只在modulateFrame内有效）
+  uint8_t* output;
+  uint32_t outputMax;
+  uint32_t outputPos;           // 已写入的采样数
+  uint32_t symbolCount;         // 已输出的码元数
+  double samplesPerBit;         // 含时钟偏差的码元长度（采样）
+  float ampMark;
+  float ampSpace;
+  float sigma;                  // 噪声标准差
+  float basebandAlpha;          // 基带低通滤波器系数
+
+  /**
+   * 均匀分布随机数 [0, 2^32)
+   */
+  uint32_t nextRandom();
+
+  /**
+   * 标准正态分布随机数
+   */
+  float nextGaussian();
+
+  /**
+   * 输出一个码元的采样（当前码元symbol）
+   * @param offset 码元结束边界的偏移（采样）
+   * @return 缓冲区不足时返回false
+   */
+  bool emitSymbol(float offset);
+};
+
+#endif // AFSK_GENERATOR_H
@@ -0,0 +1,172 @@
+/**
+ * 位压缩1比特采样解调器实现
+ */
+
+#include "afsk_packed.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 参考信号幅度大于该值的位置权重为2
+#define STRONG_THRESHOLD    0.5
+
+// 两个字的位数之和（Cortex-M没有popcount指令，编译器内建函数会调用库函数）
+// 两个字各自累加到4位一组后合并（每组不超过8），再完成剩余的并行求和
+static inline int32_t popcount2(uint32_t a, uint32_t b) {
+  a = a - ((a >> 1) & 0x55555555u);
+  a = (a & 0x33333333u) + ((a >> 2) & 0x33333333u);
+  b = b - ((b >> 1) & 0x55555555u);
+  b = (b & 0x33333333u) + ((b >> 2) & 0x33333333u);
+  uint32_t x = a + b;
+  x = ((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u;
+  return (int32_t)(x >> 24);
+}
+
+// 采样历史与参考图样的相关值
+// 一致的位置贡献 +权重，不一致的位置贡献 -权重
+static inline int32_t correlate(uint32_t hist, uint32_t mask, const PackedReference* ref) {
+  uint32_t diff = hist ^ ref->sign;
+  return ref->weight - 2 * popcount2(diff & mask, diff & ref->strong);
+}
+
+AFSKPackedDemodulator::AFSKPackedDemodulator() : AFSKCorrelatorDemodulator() {
+  markPeriod = spacePeriod = 1;
+  windowMask = 0;
+  reset();
+}
+
+uint8_t AFSKPackedDemodulator::buildReference(uint32_t freq, PackedReference* refI, 
+                                              PackedReference* refQ) {
+  // 参考信号周期 = 采样率 / gcd(采样率, 频率)，与表长度一致
+  uint32_t period = packedPeriod(freq);
+  
+  // 索引j对应最新采样的相位；bit k对应j之前第k个采样
+  for (uint32_t j = 0; j < period; j++) {
+    PackedReference* ri = &refI[j];
+    PackedReference* rq = &refQ[j];
+    ri->sign = ri->strong = 0;
+    rq->sign = rq->strong = 0;
+    ri->weight = rq->weight = windowLen;
+    
+    for (uint8_t k = 0; k < windowLen; k++) {
+      // 相位偏移1/4个采样：周期为偶数时参考值不会恰为0，图样保持零均值
+      double phase = 2.0 * M_PI * (double)freq * ((double)j - k + 0.25) / AFSK_SAMPLE_RATE;
+      double c = cos(phase), s = sin(phase);
+      uint32_t bit = 1UL << k;
+      
+      if (c >= 0) ri->sign |= bit;
+      if (s >= 0) rq->sign |= bit;
+      if (fabs(c) > STRONG_THRESHOLD) { ri->strong |= bit; ri->weight++; }
+      if (fabs(s) > STRONG_THRESHOLD) { rq->strong |= bit; rq->weight++; }
+    }
+  }
+  
+  return (uint8_t)period;
+}
+
+bool AFSKPackedDemodulator::begin() {
+  AFSKCorrelatorDemodulator::begin();
+  
+  if (windowLen > PACKED_MAX_WINDOW) {
+    windowLen = PACKED_MAX_WINDOW;
+  }
+  windowMask = (windowLen >= 32) ? 0xFFFFFFFFUL : ((1UL << windowLen) - 1);
+  
+  markPeriod = buildReference(AFSK_MARK_FREQ, markRefI, markRefQ);
+  spacePeriod = buildReference(AFSK_SPACE_FREQ, spaceRefI, spaceRefQ);
+  
+  reset();
+  return true;
+}
+
+void AFSKPackedDemodulator::reset() {
+  AFSKCorrelatorDemodulator::reset();
+  markIndex = 0;
+  spaceIndex = 0;
+}
+
+uint16_t AFSKPackedDemodulator::processWord(uint32_t word, uint8_t numSamples, uint8_t* bits,
+                                            uint16_t maxBits) {
+  // 将状态载入局部变量
+  uint32_t hist = (uint32_t)history;
+  uint32_t clock = clockPhase;
+  bool softPositive = lastSoftPositive;
+  int32_t soft = softValue;
+  uint8_t mIdx = markIndex, sIdx = spaceIndex;
+  
+  const uint32_t mask = windowMask;
+  const uint32_t gain = markGain;
+  const uint32_t offset = (uint32_t)clockOffset;
+  uint16_t numBits = 0;
+  
+  for (int8_t b = numSamples - 1; b >= 0; b--) {
+    hist = (hist << 1) | ((word >> b) & 1);
+    
+    if (++mIdx >= markPeriod) mIdx = 0;
+    if (++sIdx >= spacePeriod) sIdx = 0;
+    
+    int32_t mI = correlate(hist, mask, &markRefI[mIdx]);
+    int32_t mQ = correlate(hist, mask, &markRefQ[mIdx]);
+    int32_t sI = correlate(hist, mask, &spaceRefI[sIdx]);
+    int32_t sQ = correlate(hist, mask, &spaceRefQ[sIdx]);
+    
+    int32_t markE = (int32_t)(((mI * mI + mQ * mQ) * gain) >> 8);
+    int32_t spaceE = sI * sI + sQ * sQ;
+    soft = markE - spaceE;
+    
+    bool positive = soft > 0;
+    if (clockRecovery(positive, softPositive, clock, clockStep, offset) && numBits < maxBits) {
+      uint8_t newBit = positive ? 1 : 0;
+      updateDecision(newBit, (uint16_t)markE, (uint16_t)spaceE);
+      bits[numBits++] = newBit;
+    }
+  }
+  
+  // 写回状态
+  history = hist;
+  clockPhase = clock;
+  lastSoftPositive = softPositive;
+  softValue = soft;
+  markIndex = mIdx;
+  spaceIndex = sIdx;
+  
+  return numBits;
+}
+
+bool AFSKPackedDemodulator::processSample(uint8_t sample) {
+  uint8_t bit;
+  return processWord(sample ? 1 : 0, 1, &bit, 1) > 0;
+}
+
+uint16_t AFSKPackedDemodulator::processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) {
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numBits = 0;
+  
+  while (count > 0) {
+    uint8_t n = (count > PACKED_SAMPLES_PER_WORD) ? PACKED_SAMPLES_PER_WORD : (uint8_t)count;
+    
+    // 打包为高位在前的字
+    uint32_t word = 0;
+    for (uint8_t i = 0; i < n; i++) {
+      word = (word << 1) | (samples[i] ? 1 : 0);
+    }
+    
+    numBits += processWord(word, n, bits + numBits, maxBits - numBits);
+    samples += n;
+    count -= n;
+  }
+  
+  return numBits;
+}
+
+uint16_t AFSKPackedDemodulator::processPackedSamples(const uint32_t* words, uint16_t count, 
+                                                     uint8_t* bits) {
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK((uint32_t)count * PACKED_SAMPLES_PER_WORD);
+  uint16_t numBits = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    numBits += processWord(words[i], PACKED_SAMPLES_PER_WORD, bits + numBits, maxBits - numBits);
+  }
+  return numBits;
+}
@@ -0,0 +1,165 @@
+/**
+ * 位压缩1比特采样路径
+ * 
+ * DIO2每个采样只有1比特，压缩格式将32个采样存入一个uint32_t：
+ * 最早的采样位于最高位（bit31），即ISR只需执行 word = (word << 1) | bit，
+ * 每32个采样输出一个字。缓冲区占用为每采样一字节格式的1/8。
+ * 
+ * AFSKPackedDemodulator直接在压缩采样上工作：
+ * 采样历史保存在一个32位移位寄存器中，与预先计算的Mark/Space
+ * 正交参考比特图样按位异或后用popcount求相关，无逐采样浮点或查表乘加。
+ * 参考信号量化为两级幅度（|sin| > 0.5的位置权重为2，其余为1）：
+ * 单纯硬限幅的参考在弱信号下灵敏度损失明显，两级幅度只需多一次popcount
+ * 即可接近正弦参考的性能。
+ * 时钟恢复与判决器参数与滑动窗口相关解调器相同。
+ */
+
+#ifndef AFSK_PACKED_H
+#define AFSK_PACKED_H
+
+#include "afsk_correlator.h"
+
+// 每个压缩字包含的采样数
+#define PACKED_SAMPLES_PER_WORD   32
+
+// 相关窗口最大长度（参考图样为32位）
+#define PACKED_MAX_WINDOW         32
+
+/**
+ * 参考图样周期（采样数）= 采样率 / gcd(采样率, 频率)
+ * 26.4kHz下Mark为12、Space为22，9.6kHz下Mark为48，14.4kHz下Mark为72
+ */
+constexpr uint32_t packedGcd(uint32_t a, uint32_t b) {
+  return (b == 0) ? a : packedGcd(b, a % b);
+}
+
+constexpr uint32_t packedPeriod(uint32_t freq) {
+  return AFSK_SAMPLE_RATE / packedGcd(AFSK_SAMPLE_RATE, freq);
+}
+
+// 参考图样表按配置的采样率和音调频率定长
+#define PACKED_MARK_PERIOD        packedPeriod(AFSK_MARK_FREQ)
+#define PACKED_SPACE_PERIOD       packedPeriod(AFSK_SPACE_FREQ)
+
+static_assert(PACKED_MARK_PERIOD <= 255 && PACKED_SPACE_PERIOD <= 255,
+              "AFSK_SAMPLE_RATE与音调频率的最小公倍数过大：参考图样周期超过255个采样");
+
+// 两级幅度参考图样（bit0对应最新采样）
+typedef struct {
+  uint32_t sign;            // 参考信号符号位（1为正）
+  uint32_t strong;          // 幅度为2的位置（在窗口范围内）
+  int16_t weight;           // 全部采样一致时的相关值（窗口长度 + 强位数）
+} PackedReference;
+
+/**
+ * ISR端采样打包器
+ */
+typedef struct {
+  uint32_t word;            // 正在填充的字
+  uint8_t count;            // 已填充的采样数
+} SamplePacker;
+
+/**
+ * 向打包器加入一个采样
+ * @return 填满一个字时返回true，此时packer->word为完整的32个采样
+ */
+static inline bool packSample(SamplePacker* packer, uint8_t bit) {
+  packer->word = (packer->word << 1) | (bit & 1);
+  if (++packer->count >= PACKED_SAMPLES_PER_WORD) {
+    packer->count = 0;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * 打包GPIO输入寄存器的采样（DMA每个采样读取一次IDR的一个字节）
+ * @param raw 输入寄存器采样，每采样一字节（其他引脚的位被忽略）
+ * @param count 采样数（32的倍数）
+ * @param bit 采样引脚在字节中的位置 (0-7)
+ * @param words 输出压缩采样，count / 32个字
+ */
+static inline void packPinSamples(const uint8_t* raw, uint16_t count, uint8_t bit, uint32_t* words) {
+  for (uint16_t i = 0; i < count; i += PACKED_SAMPLES_PER_WORD) {
+    uint32_t word = 0;
+    for (uint8_t j = 0; j < PACKED_SAMPLES_PER_WORD; j++) {
+      word = (word << 1) | ((raw[i + j] >> bit) & 1);
+    }
+    *words++ = word;
+  }
+}
+
+/**
+ * 字中为1的位数
+ * Cortex-M没有popcount指令，编译器内建函数会调用库函数，这里用并行求和
+ */
+static inline uint32_t popcount32(uint32_t x) {
+  x = x - ((x >> 1) & 0x55555555u);
+  x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+  x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+  return (x * 0x01010101u) >> 24;
+}
+
+class AFSKPackedDemodulator : public AFSKCorrelatorDemodulator {
+public:
+  AFSKPackedDemodulator();
+  
+  /**
+   * 初始化解调器（生成参考图样）
+   */
+  bool begin() override;
+  
+  /**
+   * 处理单个采样点
+   */
+  bool processSample(uint8_t sample) override;
+  
+  /**
+   * 批量处理每字节一个采样的数据（内部按32个采样打包处理）
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+  
+  /**
+   * 批量处理压缩采样
+   */
+  uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) override;
+  
+  /**
+   * 重置解调器状态
+   */
+  void reset() override;
+
+protected:
+  // 正交参考图样，按最新采样的相位索引排列
+  PackedReference markRefI[PACKED_MARK_PERIOD];
+  PackedReference markRefQ[PACKED_MARK_PERIOD];
+  PackedReference spaceRefI[PACKED_SPACE_PERIOD];
+  PackedReference spaceRefQ[PACKED_SPACE_PERIOD];
+  uint8_t markPeriod;
+  uint8_t spacePeriod;
+  
+  // 当前相位索引
+  uint8_t markIndex;
+  uint8_t spaceIndex;
+  
+  // 窗口掩码
+  uint32_t windowMask;
+  
+  /**
+   * 处理一个压缩字中的采样
+   * @param word 采样字，采样位于bit[numSamples-1..0]，高位在前
+   * @param numSamples 采样数 (1-32)
+   * @param bits 输出比特数组
+   * @param maxBits 输出比特数组的剩余容量，超出的比特被丢弃
+   * @return 解调出的比特数
+   */
+  uint16_t processWord(uint32_t word, uint8_t numSamples, uint8_t* bits, uint16_t maxBits);
+  
+  /**
+   * 生成一个频率的参考图样（refI/refQ各有packedPeriod(freq)项）
+   * @return 图样周期（采样数）
+   */
+  uint8_t buildReference(uint32_t freq, PackedReference* refI, PackedReference* refQ);
+};
+
+#endif // AFSK_PACKED_H
@@ -0,0 +1,87 @@
+/**
+ * 编译期调制配置的滑动窗口相关解调器
+ *
+ * 与AFSKCorrelatorDemodulator共用相关核心（correlateBlock），但采样率、波特率和音调频率来自
+ * 模板参数Profile（见modem_profile.h）：相位步进、窗口回退量、窗口长度和时钟步进都是
+ * 编译期常量，热路径中的这些量被直接折叠进指令，不同配置的实例可以在同一个程序中共存：
+ *
+ *   AFSKProfileDemodulator<ModemProfile1200Half> demod;
+ *   decoder.setDemodulator(&demod);
+ *
+ * 相关窗口长度固定为一个比特（setParams中的windowLen被忽略），
+ * Mark增益和时钟偏移仍可通过setParams设置。
+ * HDLC解帧、AX.25解析只处理比特，与调制配置无关，不需要模板化。
+ * 固件中通过 AFSK_DEMOD_MODE = AFSK_DEMOD_PROFILE 选择（配置为ModemProfileDefault）。
+ */
+
+#ifndef AFSK_PROFILE_DEMOD_H
+#define AFSK_PROFILE_DEMOD_H
+
+#include "afsk_correlator.h"
+#include "modem_profile.h"
+
+template <class Profile>
+class AFSKProfileDemodulator : public AFSKCorrelatorDemodulator {
+public:
+  static_assert(Profile::samplesPerBit <= CORR_MAX_WINDOW, "每比特采样数超过相关窗口上限");
+
+  AFSKProfileDemodulator() : AFSKCorrelatorDemodulator() {
+    windowLen = Profile::samplesPerBit;
+    reset();
+  }
+
+  /**
+   * 初始化解调器（参数均来自Profile）
+   */
+  bool begin() override {
+    AFSKDemodulator::begin();
+
+    markStep = Profile::markStep;
+    spaceStep = Profile::spaceStep;
+    clockStep = Profile::clockStep;
+    windowLen = Profile::samplesPerBit;
+    markWindowBack = Profile::markWindowBack;
+    spaceWindowBack = Profile::spaceWindowBack;
+
+    reset();
+    return true;
+  }
+
+  /**
+   * 处理单个采样点
+   */
+  bool processSample(uint8_t sample) override {
+    uint8_t bit;
+    return correlateBlock(&sample, 1, &bit, Profile()) > 0;
+  }
+
+  /**
+   * 批量处理采样（与AFSKCorrelatorDemodulator共用相关核心，步进参数为编译期常量）
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override {
+    return correlateBlock(samples, count, bits, Profile());
+  }
+
+  /**
+   * 批量处理位压缩采样
+   */
+  uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) override {
+    return correlatePackedBlock(words, count, bits, Profile());
+  }
+
+  /**
+   * 解调器的采样率
+   */
+  uint32_t getSampleRate() override {
+    return Profile::sampleRate;
+  }
+
+  /**
+   * 信号的最大跳变率
+   */
+  uint32_t getTransitionRate() override {
+    return 2 * (Profile::markFreq > Profile::spaceFreq ? Profile::markFreq : Profile::spaceFreq);
+  }
+};
+
+#endif // AFSK_PROFILE_DEMOD_H
@@ -7,13 +7,13 @@
 #ifndef APRS_CONFIG_H
 #define APRS_CONFIG_H
 
-#include <Arduino.h>
+#include "aprs_platform.h"
 
 // ============================================================================
 // 射频配置
 // ============================================================================
 #define RF_FREQUENCY        434.0       // MHz - APRS频率 (实际使用时改为144.39/144.8等)
-#define RF_BITRATE          26.4        // kbps - 采样率
+#define RF_BITRATE          (MODEM_SAMPLE_RATE / 1000.0)  // kbps - 采样率（直接模式下DIO2的采样时钟）
 #define RF_DEVIATION        3.0         // kHz - FSK频率偏移
 
 // ============================================================================
@@ -22,13 +22,64 @@
 #define AFSK_MARK_FREQ      2200        // Hz - Mark频率 (逻辑1)
 #define AFSK_SPACE_FREQ     1200        // Hz - Space频率 (逻辑0)
 #define AFSK_BAUD_RATE      1200        // bps - 波特率
-#define AFSK_SAMPLE_RATE    26400       // Hz - 采样频率
+
+// DIO2采样频率：可降低为13200或9600以减少采样中断次数，解调器参数随之计算
+#ifndef AFSK_SAMPLE_RATE
+  #define AFSK_SAMPLE_RATE  26400       // Hz - 采样频率
+#endif
+
+// 降采样前端：以AFSK_SAMPLE_RATE采样（例如DMA），经CIC滤波抽取为
+// AFSK_SAMPLE_RATE / AFSK_DECIMATION 的多电平采样后再解调（1 = 不抽取）
+#ifndef AFSK_DECIMATION
+  #define AFSK_DECIMATION   1           // 抽取因子：1、2、4或8
+#endif
+#ifndef AFSK_CIC_ORDER
+  #define AFSK_CIC_ORDER    2           // CIC滤波器阶数 (1-3)
+#endif
+
+// 解调器工作的采样频率
+#define AFSK_DEMOD_RATE     (AFSK_SAMPLE_RATE / AFSK_DECIMATION)
+
+#if AFSK_SAMPLE_RATE % AFSK_BAUD_RATE != 0 || AFSK_DEMOD_RATE % AFSK_BAUD_RATE != 0
+  #error "AFSK采样频率必须为波特率的整数倍"
+#endif
+#if AFSK_DECIMATION != 1 && AFSK_DECIMATION != 2 && AFSK_DECIMATION != 4 && AFSK_DECIMATION != 8
+  #error "AFSK_DECIMATION必须为1、2、4或8"
+#endif
+#if AFSK_DEMOD_RATE / AFSK_BAUD_RATE < 8
+  #error "解调器每比特至少需要8个采样（见AFSK_MAX_BITS_PER_BLOCK）"
+#endif
 
 // 采样点数计算
 #define SAMPLES_PER_BIT     (AFSK_SAMPLE_RATE / AFSK_BAUD_RATE)  // 22
 #define SAMPLES_PER_MARK    (AFSK_SAMPLE_RATE / AFSK_MARK_FREQ)  // 12
 #define SAMPLES_PER_SPACE   (AFSK_SAMPLE_RATE / AFSK_SPACE_FREQ) // 22
 
+// ============================================================================
+// G3RUH 9600波特参数（基带加扰FSK）
+// ============================================================================
+#define G3RUH_BAUD_RATE     9600        // bps - 波特率
+#ifndef G3RUH_SAMPLE_RATE
+  #define G3RUH_SAMPLE_RATE 76800       // Hz - 采样频率（每比特8个采样）
+#endif
+#define G3RUH_SAMPLES_PER_BIT (G3RUH_SAMPLE_RATE / G3RUH_BAUD_RATE)
+
+// 调制方式（决定内置解调器、采样率和射频配置）
+#define MODEM_AFSK1200      0           // Bell 202 AFSK 1200波特
+#define MODEM_G3RUH9600     1           // G3RUH/K9NG 9600波特加扰FSK
+
+#ifndef MODEM_MODE
+  #define MODEM_MODE        MODEM_AFSK1200
+#endif
+
+#if MODEM_MODE == MODEM_G3RUH9600
+  #define MODEM_SAMPLE_RATE G3RUH_SAMPLE_RATE
+  #define MODEM_BAUD_RATE   G3RUH_BAUD_RATE
+#else
+  #define MODEM_SAMPLE_RATE AFSK_SAMPLE_RATE
+  #define MODEM_BAUD_RATE   AFSK_BAUD_RATE
+#endif
+
 // ============================================================================
 // AX.25协议参数
 // ============================================================================
@@ -46,10 +97,43 @@
 #define SAMPLE_BUFFER_SIZE  256         // 采样缓冲区大小
 #define BIT_BUFFER_SIZE     (AX25_MAX_FRAME_LEN * 8 + 64)  // 位缓冲区
 
+// 解码帧输出队列
+#ifndef FRAME_QUEUE_DEPTH
+  #define FRAME_QUEUE_DEPTH   4         // 队列容量（帧），1-14
+#endif
+// 排队帧的存储（字节）：每帧只占帧头和实际长度，典型APRS帧约100字节；
+// 至少能容纳一个最长帧，放不下时与队列满一样按策略丢弃
+#ifndef FRAME_QUEUE_BYTES
+  #define FRAME_QUEUE_BYTES   (FRAME_QUEUE_DEPTH * 128 + 256)
+#endif
+
+#define FRAME_QUEUE_DROP_OLDEST   0     // 队列满时丢弃最旧的帧（保留最新数据）
+#define FRAME_QUEUE_DROP_NEWEST   1     // 队列满时丢弃新到达的帧
+
+#ifndef FRAME_QUEUE_POLICY
+  #define FRAME_QUEUE_POLICY  FRAME_QUEUE_DROP_OLDEST
+#endif
+
 // ============================================================================
 // DMA配置
 // ============================================================================
-#define USE_DMA             1           // 启用DMA传输
+
+// DMA采样：定时器按采样率触发DMA，从GPIO输入寄存器把DIO2读入循环缓冲区，
+// 每半个缓冲区一次中断（打包后交给解码器），取代每个采样一次的中断
+// 关闭时由RadioLib直接模式的回调逐个采样读取（旧行为）
+#ifndef USE_DMA_CAPTURE
+  #define USE_DMA_CAPTURE   0
+#endif
+
+// DMA循环缓冲区大小（采样，每采样一字节），两个半区各为32的倍数
+// 1024 = 每半区512个采样，26.4kHz下约19ms一次中断
+#ifndef DMA_CAPTURE_BUFFER_SIZE
+  #define DMA_CAPTURE_BUFFER_SIZE  1024
+#endif
+
+#if DMA_CAPTURE_BUFFER_SIZE % 64 != 0
+  #error "DMA_CAPTURE_BUFFER_SIZE必须为64的倍数"
+#endif
 
 // ============================================================================
 // DSP配置
@@ -60,12 +144,87 @@
   #define HAS_FPU           1
   #define HAS_DSP           1
   #define USE_CMSIS_DSP     0  // 暂时禁用，避免链接错误
+#elif APRS_PLATFORM_HOST
+  #define HAS_FPU           1  // 主机构建：使用硬件浮点，不使用CMSIS-DSP
+  #define HAS_DSP           0
+  #define USE_CMSIS_DSP     0
 #else
   #define HAS_FPU           0
   #define HAS_DSP           0
   #define USE_CMSIS_DSP     0
 #endif
 
+// 定点解调器：无FPU的MCU上默认使用定点Goertzel（Q14系数/Q10采样），避免软件浮点
+#ifndef AFSK_FIXED_POINT
+  #define AFSK_FIXED_POINT  (!HAS_FPU)
+#endif
+
+// 解调模式
+#define AFSK_DEMOD_GOERTZEL     0       // 块Goertzel（每比特一次能量估计）
+#define AFSK_DEMOD_CORRELATOR   1       // 滑动窗口相关（每采样软判决，比特中点采样）
+#define AFSK_DEMOD_PACKED       2       // 位压缩相关（硬限幅参考图样，popcount求相关）
+#define AFSK_DEMOD_PROFILE      3       // 滑动窗口相关，步进参数为编译期常量（modem_profile.h）
+
+#ifndef AFSK_DEMOD_MODE
+  #define AFSK_DEMOD_MODE   AFSK_DEMOD_CORRELATOR
+#endif
+
+// 位压缩采样：ISR将32个采样打包为一个字，采样缓冲区缩小为1/8
+// 解码器通过processPackedSamples处理，建议与AFSK_DEMOD_PACKED一起使用
+#ifndef USE_PACKED_SAMPLES
+  #define USE_PACKED_SAMPLES  0
+#endif
+
+// 采样环形缓冲区：中断只打包采样并写入无锁环形缓冲区，解码在loop()中进行
+// 关闭时解码器在采样中断内直接运行（旧行为）
+#ifndef USE_SAMPLE_RING
+  #define USE_SAMPLE_RING   1
+#endif
+
+// 活动检测门控：信道空闲（输入只有噪声或没有跳变）时跳过解调和解帧，
+// 唤醒时回放最近的采样，不丢失前导（见activity_detector.h）
+#ifndef ACTIVITY_GATE_ENABLE
+  #define ACTIVITY_GATE_ENABLE  1
+#endif
+
+// 比特修复：CRC错误时翻转置信度最低的比特重试（每个解码器约增加650字节RAM）
+#ifndef FIX_BITS_ENABLE
+  #define FIX_BITS_ENABLE       1
+#endif
+#ifndef FIX_BITS_CANDIDATES
+  #define FIX_BITS_CANDIDATES   8       // 每帧记录的低置信度比特数
+#endif
+#ifndef FIX_BITS_MAX_FLIPS
+  #define FIX_BITS_MAX_FLIPS    2       // 同时翻转的最大比特数（1或2）
+#endif
+#ifndef FIX_BITS_MAX_ATTEMPTS
+  #define FIX_BITS_MAX_ATTEMPTS 4       // 每帧最多重新解帧的次数（校正子匹配的组合），超出时放弃该帧
+#endif
+
+// 重复帧抑制：同一源地址、目标地址和信息字段在时间窗口内只输出一次
+// （直接收到的帧和各数字中继转发的副本只是路径不同）
+#ifndef DUP_FILTER_ENABLE
+  #define DUP_FILTER_ENABLE     1
+#endif
+#ifndef DUP_FILTER_WINDOW_MS
+  #define DUP_FILTER_WINDOW_MS  30000   // 时间窗口（毫秒）
+#endif
+#ifndef DUP_FILTER_SIZE
+  #define DUP_FILTER_SIZE       64      // 记录容量（条），2的幂，每条8字节
+#endif
+
+// 多判决器模式：并行运行多个解调变体并合并结果（需要较多CPU，适用于F411等）
+#ifndef USE_MULTI_SLICER
+  #define USE_MULTI_SLICER  0
+#endif
+
+#if USE_MULTI_SLICER && MODEM_MODE == MODEM_G3RUH9600
+  #error "多判决器模式只支持AFSK 1200波特"
+#endif
+#if USE_MULTI_SLICER && AFSK_DECIMATION > 1
+  #error "多判决器模式不支持降采样前端"
+#endif
+
 // ============================================================================
 // 信号处理参数
 // ============================================================================
@@ -80,11 +239,38 @@
 #define UART_TX_PIN         PA9         // UART TX引脚
 #define UART_RX_PIN         PA10        // UART RX引脚
 
+// 输出格式
+#define UART_FORMAT_TNC2    0           // TNC2文本行: SOURCE>DEST,PATH:INFO
+#define UART_FORMAT_KISS    1           // KISS二进制帧（原始AX.25字节）
+
+#ifndef UART_OUTPUT_FORMAT
+  #define UART_OUTPUT_FORMAT  UART_FORMAT_TNC2
+#endif
+#ifndef KISS_PORT
+  #define KISS_PORT         0           // KISS端口号 (0-15)，多电台时区分来源
+#endif
+
+// 发送环形缓冲区（字节），必须为2的幂；1024字节在9600bps下约1秒的输出
+#ifndef UART_TX_RING_SIZE
+  #define UART_TX_RING_SIZE   1024
+#endif
+
 // ============================================================================
 // 调试配置
 // ============================================================================
-#define DEBUG_ENABLED       1           // 启用调试输出
-#define DEBUG_UART          Serial      // 调试串口
+#ifndef DEBUG_ENABLED
+  #if APRS_PLATFORM_HOST
+    #define DEBUG_ENABLED   0           // 主机构建默认关闭调试输出
+  #else
+    #define DEBUG_ENABLED   1           // 启用调试输出
+  #endif
+#endif
+
+#if APRS_PLATFORM_HOST
+  #define DEBUG_UART        HostDebug   // 主机构建：输出到stderr
+#else
+  #define DEBUG_UART        Serial      // 调试串口
+#endif
 
 #if DEBUG_ENABLED
   #define DEBUG_PRINT(...)    DEBUG_UART.print(__VA_ARGS__)
@@ -99,5 +285,10 @@
 // ============================================================================
 #define ENABLE_STATISTICS   1           // 启用统计功能
 
+// 热路径性能计数（各阶段耗时和直方图，见aprs_profile.h），关闭时不产生代码
+#ifndef APRS_PROFILE
+  #define APRS_PROFILE      0
+#endif
+
 #endif // APRS_CONFIG_H
 
@@ -3,23 +3,30 @@
  */
 
 #include "aprs_decoder.h"
+#include "aprs_profile.h"
 #include <string.h>
 
-// 超时常量（采样点数）
-#define SYNC_TIMEOUT    (AFSK_SAMPLE_RATE * 2)   // 2秒同步超时
-#define BYTE_TIMEOUT    (SAMPLES_PER_BIT * 20)   // 20比特超时
+// 超时常量
+#define SYNC_TIMEOUT_SECONDS  2                       // 2秒同步超时（按解调器采样率换算为采样数）
+#define BYTE_TIMEOUT          (SAMPLES_PER_BIT * 20)  // 20比特超时
 
 APRSDecoder::APRSDecoder() {
+  demod = &afskDemod;
+  syncTimeoutLimit = AFSK_SAMPLE_RATE * SYNC_TIMEOUT_SECONDS;
   reset();
 }
 
 bool APRSDecoder::begin() {
   // 初始化各模块
-  if (!afskDemod.begin()) {
+  if (!demod->begin()) {
     return false;
   }
+  syncTimeoutLimit = demod->getSampleRate() * SYNC_TIMEOUT_SECONDS;
+#if ACTIVITY_GATE_ENABLE
+  activity.begin(demod->getSampleRate(), demod->getTransitionRate());
+#endif
   
-  nrziDecoder.begin();
+  deframer.begin();
   ax25Parser.begin();
   
   reset();
@@ -28,101 +35,375 @@ bool APRSDecoder::begin() {
 }
 
 void APRSDecoder::reset() {
-  afskDemod.reset();
-  nrziDecoder.reset();
+  demod->reset();
+  deframer.reset();
   ax25Parser.reset();
   
+  frameQueue.reset();
+  ax25Parser.setBuffer(frameQueue.acquire());
+#if FIX_BITS_ENABLE
+  frameRepair.reset();
+#endif
+  
   state = STATE_IDLE;
-  frameAvailable = false;
   syncTimeout = 0;
   byteTimeout = 0;
   flagCount = 0;
   
   memset(&stats, 0, sizeof(stats));
+  
+#if ACTIVITY_GATE_ENABLE
+  activity.reset();
+  activity.resetStatistics();
+  gatePacker.word = 0;
+  gatePacker.count = 0;
+#endif
 }
 
+// 批量处理时每个数据块的采样数（限制局部缓冲区大小）
+#define BLOCK_SAMPLES   256
+#define BLOCK_WORDS     (BLOCK_SAMPLES / PACKED_SAMPLES_PER_WORD)
+
 void APRSDecoder::processSample(uint8_t sample) {
+#if ACTIVITY_GATE_ENABLE
+  processSamples(&sample, 1);
+#else
   // 1. AFSK解调
-  if (afskDemod.processSample(sample)) {
-    // 成功解调出一个比特
-    uint8_t bit = afskDemod.getDemodulatedBit();
+  PROFILE_BEGIN(t0);
+  bool ready = demod->processSample(sample);
+  PROFILE_END(PROFILE_STAGE_DEMOD, t0, 1);
+  if (ready) {
+    // 成功解调出一个比特，与批量接口共用解帧和状态机
+    uint8_t bit = demod->getDemodulatedBit();
+    uint16_t confidence = demod->getBitConfidence();
+    processBits(&bit, &confidence, 1);
+  }
+  
+  updateCarrierState(1);
+#endif
+}
+
+void APRSDecoder::processSamples(const uint8_t* samples, size_t count) {
+#if ACTIVITY_GATE_ENABLE
+  // 每32个采样检测一次；活动期间的采样按原顺序整段解调
+  size_t runStart = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!packSample(&gatePacker, samples[i])) {
+      continue;
+    }
+    bool wasActive = activity.isActive();
+    bool nowActive = activity.update(gatePacker.word);
+    if (wasActive && !nowActive) {
+      demodulateSamples(samples + runStart, i + 1 - runStart);
+      enterIdle();
+    } else if (!wasActive && nowActive) {
+      // 唤醒字及之前的采样在回放历史中
+      wakeUp();
+      runStart = i + 1;
+    }
+  }
+  if (activity.isActive()) {
+    demodulateSamples(samples + runStart, count - runStart);
+  }
+#else
+  demodulateSamples(samples, count);
+#endif
+}
+
+void APRSDecoder::processPackedSamples(const uint32_t* words, size_t count) {
+#if ACTIVITY_GATE_ENABLE
+  size_t runStart = 0;
+  for (size_t i = 0; i < count; i++) {
+    bool wasActive = activity.isActive();
+    bool nowActive = activity.update(words[i]);
+    if (wasActive && !nowActive) {
+      demodulatePacked(words + runStart, i + 1 - runStart);
+      enterIdle();
+    } else if (!wasActive && nowActive) {
+      wakeUp();
+      runStart = i + 1;
+    }
+  }
+  if (activity.isActive()) {
+    demodulatePacked(words + runStart, count - runStart);
+  }
+#else
+  demodulatePacked(words, count);
+#endif
+}
+
+void APRSDecoder::wakeUp() {
+#if ACTIVITY_GATE_ENABLE
+  uint32_t history[ACTIVITY_LOOKBACK_WORDS];
+  uint8_t n = activity.takeLookback(history);
+
+  // 解调器不复位：回放的历史足以冲刷滤波器和时钟恢复，复位会丢掉已收敛的载波检测
+  // 解帧器复位：丢弃门控关闭前未完成的帧
+  deframer.reset();
+  demodulatePacked(history, n);
+#endif
+}
+
+void APRSDecoder::enterIdle() {
+  // 挂起时间内信号仍未恢复：帧已无法完成，单独计数以便调整ACTIVITY_HANGOVER_WORDS。
+  // 信号结束后结束标志之后的噪声也会被解帧成字节，只计已收到完整目的和源地址的帧
+  // （地址字节左移1位编码，除最后一个地址字节外最低位都为0，噪声很少满足）
+  if (state == STATE_RECEIVING && ax25Parser.getLength() >= 2 * AX25_ADDR_LEN) {
+    const uint8_t* raw = ax25Parser.getFrame()->raw;
+    uint8_t i = 0;
+    while (i < 2 * AX25_ADDR_LEN - 1 && (raw[i] & 0x01) == 0) {
+      i++;
+    }
+    if (i == 2 * AX25_ADDR_LEN - 1) {
+      stats.gateAbortedFrames++;
+    }
+  }
+  state = STATE_IDLE;
+  flagCount = 0;
+  syncTimeout = 0;
+}
+
+void APRSDecoder::demodulateSamples(const uint8_t* samples, size_t count) {
+  uint8_t bits[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  uint16_t confidence[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  
+  while (count > 0) {
+    uint16_t n = (count > BLOCK_SAMPLES) ? BLOCK_SAMPLES : (uint16_t)count;
     
-    // 2. NRZI解码和比特去填充
-    if (nrziDecoder.processBit(bit)) {
-      // 成功解码出一个字节
-      uint8_t byte = nrziDecoder.getDecodedByte();
-      
-      // 状态机处理
-      switch (state) {
-        case STATE_IDLE:
-        case STATE_SYNC:
-          // 在空闲或同步状态，检查帧标志
-          if (nrziDecoder.isFlagDetected()) {
-            flagCount++;
-            if (flagCount >= 1) {  // 至少1个标志后开始接收
-              state = STATE_RECEIVING;
-              ax25Parser.startFrame();
-              byteTimeout = 0;
-              DEBUG_PRINTLN("Frame Start");
-            }
-          }
-          break;
-          
-        case STATE_RECEIVING:
-          // 接收状态
-          if (nrziDecoder.isFlagDetected()) {
-            // 检测到帧结束标志
-            if (ax25Parser.endFrame()) {
-              // 帧接收成功
-              state = STATE_COMPLETE;
-              frameAvailable = true;
-              stats.framesReceived++;
-              stats.framesValid++;
-              DEBUG_PRINTLN("Frame Complete");
-            } else {
-              // CRC错误
-              stats.framesReceived++;
-              stats.framesCRCError++;
-              state = STATE_IDLE;
-              flagCount = 0;
-              DEBUG_PRINTLN("Frame CRC Error");
-            }
-          } else {
-            // 正常数据字节
-            ax25Parser.addByte(byte);
-            stats.bytesReceived++;
-            byteTimeout = 0;
-          }
-          break;
-          
-        case STATE_COMPLETE:
-          // 帧已完成，等待用户读取
-          // 如果检测到新的标志，准备接收下一帧
-          if (nrziDecoder.isFlagDetected()) {
-            if (!frameAvailable) {  // 上一帧已被读取
-              state = STATE_SYNC;
-              flagCount = 1;
-            }
-          }
-          break;
-      }
+    // 1. AFSK解调（整块）
+    PROFILE_BEGIN(t0);
+    demod->setConfidenceOutput(confidence, (uint16_t)(sizeof(confidence) / sizeof(confidence[0])));
+    uint16_t numBits = demod->processSamples(samples, n, bits);
+    demod->setConfidenceOutput(nullptr);
+    PROFILE_END(PROFILE_STAGE_DEMOD, t0, n);
+    processBits(bits, confidence, numBits);
+    updateCarrierState(n);
+    
+    samples += n;
+    count -= n;
+  }
+}
+
+void APRSDecoder::demodulatePacked(const uint32_t* words, size_t count) {
+  uint8_t bits[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  uint16_t confidence[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  
+  while (count > 0) {
+    uint16_t n = (count > BLOCK_WORDS) ? BLOCK_WORDS : (uint16_t)count;
+    
+    PROFILE_BEGIN(t0);
+    demod->setConfidenceOutput(confidence, (uint16_t)(sizeof(confidence) / sizeof(confidence[0])));
+    uint16_t numBits = demod->processPackedSamples(words, n, bits);
+    demod->setConfidenceOutput(nullptr);
+    PROFILE_END(PROFILE_STAGE_DEMOD, t0, (uint32_t)n * PACKED_SAMPLES_PER_WORD);
+    processBits(bits, confidence, numBits);
+    updateCarrierState((uint32_t)n * PACKED_SAMPLES_PER_WORD);
+    
+    words += n;
+    count -= n;
+  }
+}
+
+void APRSDecoder::processRing(SampleRing* ring) {
+  const uint32_t* words;
+  uint16_t n;
+  
+  while ((n = ring->peek(&words)) > 0) {
+    processPackedSamples(words, n);
+    ring->consume(n);
+  }
+  
+  stats.sampleOverflows = ring->getOverflows();
+  stats.ringHighWater = ring->getHighWater();
+}
+
+void APRSDecoder::processBits(const uint8_t* bits, const uint16_t* confidence, uint16_t numBits) {
+  uint16_t events[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  uint8_t run[AFSK_MAX_BITS_PER_BLOCK(BLOCK_SAMPLES)];
+  
+  if (numBits == 0) {
+    return;
+  }
+  
+#if FIX_BITS_ENABLE
+  frameRepair.addBits(bits, confidence, numBits);
+#else
+  (void)confidence;
+#endif
+  
+  // 2. HDLC解帧：NRZI解码、比特去填充和标志检测（整块）
+  PROFILE_BEGIN(t0);
+  uint16_t numEvents = deframer.processBits(bits, numBits, events);
+  PROFILE_END(PROFILE_STAGE_DEFRAME, t0, numBits);
+  
+  byteTimeout += numBits;
+  
+  // 3. 状态机：接收状态下连续的数据字节整段交给AX.25解析器
+  PROFILE_BEGIN(t1);
+  uint16_t runLen = 0;
+  for (uint16_t i = 0; i < numEvents; i++) {
+    uint16_t event = events[i];
+    
+    if (state == STATE_RECEIVING && !DEFRAMER_IS_EVENT(event)) {
+      run[runLen++] = (uint8_t)event;
+      continue;
     }
     
-    // 超时处理
-    byteTimeout++;
-    if (state == STATE_RECEIVING && byteTimeout > BYTE_TIMEOUT) {
-      // 接收超时，帧不完整
-      DEBUG_PRINTLN("Frame Timeout");
-      state = STATE_IDLE;
-      flagCount = 0;
-      stats.syncTimeout++;
+    if (runLen > 0) {
+      ax25Parser.addBytes(run, runLen);
+      stats.bytesReceived += runLen;
+      byteTimeout = 0;
+      runLen = 0;
     }
+    
+    if (event == DEFRAMER_EVENT_FLAG) {
+      handleFlag();
+    } else if (event == DEFRAMER_EVENT_ABORT) {
+      handleAbort();
+    } else {
+      handleByte((uint8_t)event);
+    }
+  }
+  
+  if (runLen > 0) {
+    ax25Parser.addBytes(run, runLen);
+    stats.bytesReceived += runLen;
+    byteTimeout = 0;
   }
+  PROFILE_END(PROFILE_STAGE_PARSE, t1, numEvents);
   
+  // 超时处理
+  if (state == STATE_RECEIVING && byteTimeout > BYTE_TIMEOUT) {
+    DEBUG_PRINTLN("Frame Timeout");
+    state = STATE_IDLE;
+    flagCount = 0;
+    stats.syncTimeout++;
+  }
+}
+
+void APRSDecoder::handleFlag() {
+  switch (state) {
+    case STATE_IDLE:
+    case STATE_SYNC:
+      flagCount++;
+      if (flagCount >= 1) {  // 至少1个标志后开始接收
+        state = STATE_RECEIVING;
+        startFrame();
+        DEBUG_PRINTLN("Frame Start");
+      }
+      break;
+      
+    case STATE_RECEIVING: {
+      // 前导码中的连续标志：尚未收到足够字节，重新开始接收
+      if (ax25Parser.getLength() < AX25_MIN_FRAME_LEN) {
+        startFrame();
+        break;
+      }
+      
+      // 检测到帧结束标志，CRC错误时尝试比特修复
+      uint8_t fixedBits = 0;
+      PROFILE_BEGIN(t0);
+      bool valid = ax25Parser.endFrame();
+      PROFILE_END(PROFILE_STAGE_END_FRAME, t0, ax25Parser.getLength());
+      if (!valid) {
+        PROFILE_BEGIN(t1);
+        fixedBits = repairFrame();
+        PROFILE_END(PROFILE_STAGE_REPAIR, t1, ax25Parser.getLength());
+        valid = fixedBits > 0;
+      }
+      
+      if (valid) {
+        // 帧接收成功：接收槽位中的帧（帧头和实际长度）复制进输出队列，解析器继续使用该槽位
+        ax25Parser.getFrame()->fixedBits = fixedBits;
+        frameQueue.commit();
+        stats.framesReceived++;
+        stats.framesValid++;
+        if (fixedBits > 0) {
+          stats.framesFixed++;
+        }
+        stats.framesDropped = frameQueue.getDropped();
+        stats.queueHighWater = frameQueue.getHighWater();
+        DEBUG_PRINTLN("Frame Complete");
+        
+        // 结束标志同时可作为下一帧的起始标志，立即继续接收
+        state = STATE_RECEIVING;
+        startFrame();
+      } else {
+        // CRC错误：噪声也会被解帧成字节，此时的标志可能是下一帧唯一完整的起始标志
+        // （前导很短时，例如G3RUH解扰器同步后只剩1个标志），继续接收
+        stats.framesReceived++;
+        stats.framesCRCError++;
+        state = STATE_RECEIVING;
+        startFrame();
+        DEBUG_PRINTLN("Frame CRC Error");
+      }
+      break;
+    }
+      
+    case STATE_COMPLETE:
+      // 完成的帧已进入输出队列，不会停留在此状态
+      state = STATE_SYNC;
+      flagCount = 1;
+      break;
+  }
+}
+
+void APRSDecoder::startFrame() {
+  ax25Parser.startFrame();
+#if FIX_BITS_ENABLE
+  frameRepair.startFrame();
+#endif
+  byteTimeout = 0;
+}
+
+uint8_t APRSDecoder::repairFrame() {
+#if FIX_BITS_ENABLE
+  uint16_t length = ax25Parser.getLength();
+  if (!frameRepair.prepare(length, ax25Parser.getCRCSyndrome())) {
+    return 0;
+  }
+  
+  // 修复后的数据写回接收槽位，再由解析器重新校验CRC并定位字段
+  APRS_AX25Frame* frame = ax25Parser.getFrame();
+  uint8_t flips;
+  while ((flips = frameRepair.next(frame->raw)) > 0) {
+    ax25Parser.startFrame();
+    ax25Parser.addBytes(frame->raw, length);
+    if (ax25Parser.endFrame() && frame->control == AX25_CONTROL && frame->pid == AX25_PID) {
+      return flips;
+    }
+  }
+  if (frameRepair.isAbandoned()) {
+    stats.framesRepairAbandoned++;
+  }
+#endif
+  return 0;
+}
+
+void APRSDecoder::handleByte(uint8_t byte) {
+  if (state == STATE_RECEIVING) {
+    // 正常数据字节
+    ax25Parser.addByte(byte);
+    stats.bytesReceived++;
+    byteTimeout = 0;
+  }
+}
+
+void APRSDecoder::handleAbort() {
+  if (state == STATE_RECEIVING) {
+    // 帧内不会出现连续7个1：丢弃正在接收的帧，继续查找下一个标志
+    DEBUG_PRINTLN("Frame Abort");
+    state = STATE_SYNC;
+    syncTimeout = 0;
+    flagCount = 0;
+  }
+}
+
+void APRSDecoder::updateCarrierState(uint32_t samples) {
   // 载波检测
   if (state == STATE_SYNC) {
-    syncTimeout++;
-    if (syncTimeout > SYNC_TIMEOUT) {
+    syncTimeout += samples;
+    if (syncTimeout > syncTimeoutLimit) {
       state = STATE_IDLE;
       flagCount = 0;
       stats.syncTimeout++;
@@ -131,38 +412,40 @@ void APRSDecoder::processSample(uint8_t sample) {
   
   // 在空闲状态检测载波
   if (state == STATE_IDLE) {
-    if (afskDemod.isCarrierDetected()) {
+    if (demod->isCarrierDetected()) {
       state = STATE_SYNC;
       syncTimeout = 0;
       flagCount = 0;
-      nrziDecoder.reset();
+      deframer.reset();
     }
   }
 }
 
 bool APRSDecoder::available() {
-  return frameAvailable;
+  return frameQueue.available();
 }
 
 APRS_AX25Frame* APRSDecoder::getFrame() {
-  frameAvailable = false;
-  return ax25Parser.getFrame();
+  return frameQueue.pop();
+}
+
+void APRSDecoder::setQueuePolicy(uint8_t policy) {
+  frameQueue.setPolicy(policy);
 }
 
 uint16_t APRSDecoder::getAPRSMessage(char* buffer, uint16_t maxLen) {
-  if (!frameAvailable) {
+  uint16_t len;
+  const uint8_t* info = frameQueue.peekInfo(&len);
+  if (info == nullptr) {
     return 0;
   }
   
-  APRS_AX25Frame* frame = ax25Parser.getFrame();
-  
   // 复制信息字段到输出缓冲区
-  uint16_t len = frame->infoLen;
   if (len > maxLen - 1) {
     len = maxLen - 1;
   }
   
-  memcpy(buffer, frame->info, len);
+  memcpy(buffer, info, len);
   buffer[len] = '\0';  // 添加字符串结束符
   
   return len;
@@ -176,7 +459,33 @@ DecoderStatistics* APRSDecoder::getStatistics() {
   return &stats;
 }
 
+void APRSDecoder::setDemodulator(AFSKDemodulator* demodulator) {
+  demod = (demodulator != nullptr) ? demodulator : &afskDemod;
+  demod->begin();
+  syncTimeoutLimit = demod->getSampleRate() * SYNC_TIMEOUT_SECONDS;
+#if ACTIVITY_GATE_ENABLE
+  activity.begin(demod->getSampleRate(), demod->getTransitionRate());
+#endif
+  reset();
+}
+
 uint8_t APRSDecoder::getSignalQuality() {
-  return afskDemod.getSignalQuality();
+  return demod->getSignalQuality();
+}
+
+ActivityStatistics* APRSDecoder::getActivityStatistics() {
+#if ACTIVITY_GATE_ENABLE
+  return activity.getStatistics();
+#else
+  return nullptr;
+#endif
+}
+
+uint8_t APRSDecoder::getDutyCycle() {
+#if ACTIVITY_GATE_ENABLE
+  return activity.getDutyCycle();
+#else
+  return 100;
+#endif
 }
 
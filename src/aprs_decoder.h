@@ -1,7 +1,7 @@
 /**
  * APRS基础解码器
  * 
- * 整合AFSK解调、NRZI解码和AX.25解析
+ * 整合AFSK解调、HDLC解帧和AX.25解析
  * 适用于所有STM32平台
  */
 
@@ -10,26 +10,44 @@
 
 #include "aprs_config.h"
 #include "afsk_demod.h"
-#include "nrzi_decoder.h"
+#include "afsk_demod_fixed.h"
+#include "afsk_correlator.h"
+#include "afsk_profile_demod.h"
+#include "afsk_packed.h"
+#include "afsk_decimating.h"
+#include "g3ruh_demod.h"
+#include "hdlc_deframer.h"
+#include "sample_ring.h"
 #include "ax25_parser.h"
+#include "frame_queue.h"
+#include "frame_repair.h"
+#include "activity_detector.h"
 #include <stdint.h>
+#include <stddef.h>
 
 // 解码器状态
 enum DecoderState {
   STATE_IDLE,           // 空闲，等待载波
   STATE_SYNC,           // 同步，查找帧标志
   STATE_RECEIVING,      // 接收数据
-  STATE_COMPLETE        // 帧接收完成
+  STATE_COMPLETE        // 帧接收完成（帧进入输出队列后立即转入接收，不在此状态停留）
 };
 
 // 统计信息
 typedef struct {
   uint32_t framesReceived;      // 接收到的帧数
   uint32_t framesValid;         // 有效帧数
-  uint32_t framesCRCError;      // CRC错误帧数
+  uint32_t framesCRCError;      // CRC错误帧数（不含修复成功的帧）
+  uint32_t framesFixed;         // 经比特修复后通过CRC的帧数（计入有效帧数）
+  uint32_t framesRepairAbandoned; // 重新解帧次数用尽而放弃修复的帧数（计入CRC错误帧数）
   uint32_t bytesReceived;       // 接收到的字节数
   uint32_t carrierLost;         // 载波丢失次数
   uint32_t syncTimeout;         // 同步超时次数
+  uint32_t gateAbortedFrames;   // 活动门控在帧接收中途关闭而放弃的帧数
+  uint32_t sampleOverflows;     // 采样环形缓冲区溢出丢弃的字数（每字32个采样）
+  uint16_t ringHighWater;       // 采样环形缓冲区占用的历史最大值（字）
+  uint32_t framesDropped;       // 输出队列满而丢弃的帧数
+  uint8_t queueHighWater;       // 输出队列长度的历史最大值（帧）
 } DecoderStatistics;
 
 class APRSDecoder {
@@ -44,22 +62,52 @@ public:
   
   /**
    * 处理来自射频模块的采样数据
+   * 启用活动检测门控时采样按32个一组检测，解码结果最多延迟32个采样
    * @param sample 采样值 (0或1)
    */
   void processSample(uint8_t sample);
   
   /**
-   * 检查是否有可用的解码帧
+   * 批量处理采样数据（适用于DMA双缓冲）
+   * 解调器、HDLC解帧器和AX.25解析器均按数据块处理，
+   * 状态机检查和超时计数按块进行，而不是逐个采样
+   * @param samples 采样数组 (0或1)
+   * @param count 采样数量
+   */
+  void processSamples(const uint8_t* samples, size_t count);
+  
+  /**
+   * 批量处理位压缩采样（见afsk_packed.h，最早的采样在最高位）
+   * @param words 压缩采样数组
+   * @param count 字数（每字32个采样）
+   */
+  void processPackedSamples(const uint32_t* words, size_t count);
+  
+  /**
+   * 处理采样环形缓冲区中的全部数据（在loop()中调用）
+   * 同时将缓冲区的溢出计数和最大占用记入统计信息
+   * @param ring 由采样中断写入的环形缓冲区
+   */
+  void processRing(SampleRing* ring);
+  
+  /**
+   * 检查输出队列中是否有解码帧
    * @return 如果有新帧，返回true
    */
   bool available();
   
   /**
-   * 获取解码后的AX.25帧
-   * @return 指向帧的指针
+   * 从输出队列取出最早的解码帧
+   * @return 指向帧的指针，在下一次getFrame()之前有效；无帧时返回nullptr
    */
   APRS_AX25Frame* getFrame();
   
+  /**
+   * 设置输出队列满时的丢弃策略
+   * @param policy FRAME_QUEUE_DROP_OLDEST 或 FRAME_QUEUE_DROP_NEWEST
+   */
+  void setQueuePolicy(uint8_t policy);
+  
   /**
    * 获取APRS消息（信息字段）
    * @param buffer 输出缓冲区
@@ -83,44 +131,129 @@ public:
    */
   DecoderStatistics* getStatistics();
   
+  /**
+   * 更换解调器（运行时选择解调模式）
+   * 解调器会被初始化，解码器状态被重置
+   * @param demodulator 解调器实例，nullptr表示恢复内置解调器
+   */
+  void setDemodulator(AFSKDemodulator* demodulator);
+  
   /**
    * 获取信号质量
    * @return 信号质量 0-100
    */
   uint8_t getSignalQuality();
+  
+  /**
+   * 获取活动检测统计（空闲/活动时间）
+   * @return 未启用ACTIVITY_GATE_ENABLE时返回nullptr
+   */
+  ActivityStatistics* getActivityStatistics();
+  
+  /**
+   * 活动时间占比（解调器实际运行的采样比例）
+   * @return 0-100，未启用门控时为100
+   */
+  uint8_t getDutyCycle();
 
 protected:
+#if MODEM_MODE == MODEM_G3RUH9600
+  G3RUHDemodulator afskDemod;           // 9600波特基带解调器（G3RUH解扰）
+#elif AFSK_DECIMATION > 1
+  AFSKDecimatingDemodulator afskDemod;  // AFSK解调器（CIC抽取前端 + 滑动窗口相关）
+#elif AFSK_DEMOD_MODE == AFSK_DEMOD_PACKED
+  AFSKPackedDemodulator afskDemod;      // AFSK解调器（位压缩相关）
+#elif AFSK_DEMOD_MODE == AFSK_DEMOD_CORRELATOR
+  AFSKCorrelatorDemodulator afskDemod;  // AFSK解调器（滑动窗口相关）
+#elif AFSK_DEMOD_MODE == AFSK_DEMOD_PROFILE
+  AFSKProfileDemodulator<ModemProfileDefault> afskDemod;  // AFSK解调器（编译期配置的滑动窗口相关）
+#elif AFSK_FIXED_POINT
+  AFSKDemodulatorFixed afskDemod;   // AFSK解调器（定点）
+#else
   AFSKDemodulator afskDemod;    // AFSK解调器
-  NRZIDecoder nrziDecoder;      // NRZI解码器
+#endif
+  AFSKDemodulator* demod;       // 当前使用的解调器（默认指向afskDemod）
+  HDLCDeframer deframer;        // HDLC解帧器（NRZI解码、去填充、标志检测）
   AX25Parser ax25Parser;        // AX.25解析器
   
+  FrameQueue frameQueue;        // 解码帧输出队列
+#if FIX_BITS_ENABLE
+  FrameRepair frameRepair;      // CRC错误帧的比特修复
+#endif
+  
   DecoderState state;           // 当前状态
-  bool frameAvailable;          // 帧可用标志
-  uint16_t syncTimeout;         // 同步超时计数
+  uint32_t syncTimeout;         // 同步超时计数
+  uint32_t syncTimeoutLimit;    // 同步超时（采样数，由解调器采样率决定）
   uint16_t byteTimeout;         // 字节超时计数
   uint8_t flagCount;            // 帧标志计数
   
   DecoderStatistics stats;      // 统计信息
   
+#if ACTIVITY_GATE_ENABLE
+  ActivityDetector activity;    // 活动检测门控
+  SamplePacker gatePacker;      // 每字节一个采样的输入按字检测
+#endif
+  
+  /**
+   * 状态机：处理帧标志
+   */
+  void handleFlag();
+  
+  /**
+   * 状态机：处理数据字节
+   */
+  void handleByte(uint8_t byte);
+  
+  /**
+   * 状态机：处理中止序列（丢弃正在接收的帧）
+   */
+  void handleAbort();
+  
+  /**
+   * 开始接收新帧
+   */
+  void startFrame();
+  
+  /**
+   * 尝试修复CRC错误的帧
+   * 修复后的帧还须是APRS UI帧，降低CRC碰撞导致误修复的概率
+   * @return 翻转的比特数，修复失败返回0
+   */
+  uint8_t repairFrame();
+  
+  /**
+   * 解调输出的比特块经HDLC解帧后送入状态机和AX.25解析器
+   * @param bits 比特数组
+   * @param confidence 各比特的置信度（用于比特修复）
+   * @param numBits 比特数
+   */
+  void processBits(const uint8_t* bits, const uint16_t* confidence, uint16_t numBits);
+  
+  /**
+   * 按块更新同步超时和载波检测
+   * @param samples 自上次调用以来处理的采样数
+   */
+  void updateCarrierState(uint32_t samples);
+  
   /**
-   * 状态机处理
+   * 解调采样块并送入解帧器和状态机（不经门控）
    */
-  void stateMachine();
+  void demodulateSamples(const uint8_t* samples, size_t count);
   
   /**
-   * 处理空闲状态
+   * 解调压缩采样块并送入解帧器和状态机（不经门控）
    */
-  void handleIdleState();
+  void demodulatePacked(const uint32_t* words, size_t count);
   
   /**
-   * 处理同步状态
+   * 门控打开：重置解帧器，把空闲期间保存的历史送入解调器
    */
-  void handleSyncState();
+  void wakeUp();
   
   /**
-   * 处理接收状态
+   * 门控关闭：放弃正在接收的帧（计入gateAbortedFrames），状态机回到空闲
    */
-  void handleReceivingState();
+  void enterIdle();
 };
 
 #endif // APRS_DECODER_H
@@ -170,6 +170,18 @@ bool AFSKDemodulatorEnhanced::processSample(uint8_t sample) {
   return false;
 }
 
+uint16_t AFSKDemodulatorEnhanced::processSamples(const uint8_t* samples, uint16_t count, 
+                                                uint8_t* bits) {
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numBits = 0;
+  for (uint16_t i = 0; i < count; i++) {
+    if (processSample(samples[i]) && numBits < maxBits) {
+      bits[numBits++] = getDemodulatedBit();
+    }
+  }
+  return numBits;
+}
+
 // ============================================================================
 // APRSDecoderEnhanced 实现
 // ============================================================================
@@ -183,8 +195,9 @@ bool APRSDecoderEnhanced::begin() {
   if (!afskDemodEnhanced.begin()) {
     return false;
   }
+  demod = &afskDemodEnhanced;
   
-  nrziDecoder.begin();
+  deframer.begin();
   ax25Parser.begin();
   
   // 初始化FFT
@@ -197,11 +210,9 @@ bool APRSDecoderEnhanced::begin() {
   return true;
 }
 
-void APRSDecoderEnhanced::processSampleBatch(uint8_t* samples, uint16_t length) {
+void APRSDecoderEnhanced::processSampleBatch(const uint8_t* samples, uint16_t length) {
   // 批量处理采样（适用于DMA传输）
-  for (uint16_t i = 0; i < length; i++) {
-    processSample(samples[i]);
-  }
+  processSamples(samples, length);
 }
 
 void APRSDecoderEnhanced::enableAdaptiveEqualizer(bool enable) {
@@ -36,6 +36,11 @@ public:
    */
   bool processSample(uint8_t sample) override;
   
+  /**
+   * 批量处理采样（逐个调用DSP优化的processSample）
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+  
   /**
    * 重置
    */
@@ -90,7 +95,7 @@ public:
    * @param samples 采样缓冲区
    * @param length 采样数量
    */
-  void processSampleBatch(uint8_t* samples, uint16_t length);
+  void processSampleBatch(const uint8_t* samples, uint16_t length);
   
   /**
    * 使用自适应均衡器
@@ -0,0 +1,111 @@
+/**
+ * APRS帧格式化实现
+ */
+
+#include "aprs_format.h"
+
+uint8_t formatCallsign(char* output, const APRS_AX25Address* addr) {
+  // 格式化呼号为 "CALL-SSID" 格式
+  uint8_t len = 0;
+  for (int i = 0; i < 7 && addr->callsign[i] != '\0'; i++) {
+    output[len++] = addr->callsign[i];
+  }
+  
+  if (addr->ssid > 0) {
+    output[len++] = '-';
+    if (addr->ssid >= 10) {
+      output[len++] = '0' + (addr->ssid / 10);
+    }
+    output[len++] = '0' + (addr->ssid % 10);
+  }
+  
+  output[len] = '\0';
+  return len;
+}
+
+uint16_t formatTNC2(const APRS_AX25Frame* frame, char* output, uint16_t maxLen) {
+  char call[16];  // 单个呼号缓冲区
+  APRS_AX25Address addr;
+  uint16_t pos = 0;
+  
+  if (maxLen == 0) {
+    return 0;
+  }
+  
+  // 追加字符串（超出缓冲区时截断）
+  #define APPEND_STR(str) \
+    for (const char* p = (str); *p != '\0' && pos < maxLen - 1; p++) { \
+      output[pos++] = *p; \
+    }
+  
+  ax25GetSource(frame, &addr);
+  formatCallsign(call, &addr);
+  APPEND_STR(call);
+  APPEND_STR(">");
+  ax25GetDestination(frame, &addr);
+  formatCallsign(call, &addr);
+  APPEND_STR(call);
+  
+  // 中继路径：最后一个已转发（H位）的中继后加'*'
+  uint8_t lastRepeated = 0xFF;
+  for (uint8_t i = 0; i < frame->numDigipeaters; i++) {
+    if (ax25IsRepeated(frame, i)) {
+      lastRepeated = i;
+    }
+  }
+  for (uint8_t i = 0; i < frame->numDigipeaters; i++) {
+    APPEND_STR(",");
+    ax25GetDigipeater(frame, i, &addr);
+    formatCallsign(call, &addr);
+    APPEND_STR(call);
+    if (i == lastRepeated) {
+      APPEND_STR("*");
+    }
+  }
+  
+  APPEND_STR(":");
+  
+  #undef APPEND_STR
+  
+  // 信息字段
+  const uint8_t* info = ax25GetInfo(frame);
+  for (uint16_t i = 0; i < frame->infoLen && pos < maxLen - 1; i++) {
+    output[pos++] = info[i];
+  }
+  
+  output[pos] = '\0';
+  return pos;
+}
+
+uint16_t formatKISS(const APRS_AX25Frame* frame, uint8_t port, uint8_t* output, uint16_t maxLen) {
+  uint16_t pos = 0;
+  uint16_t length = (frame->length >= 2) ? frame->length - 2 : 0;   // 去掉FCS
+  
+  // 追加一个字节并转义FEND/FESC（保留结尾FEND的空间）
+  #define APPEND_ESCAPED(b) \
+    do { \
+      uint8_t c_ = (b); \
+      if (c_ == KISS_FEND || c_ == KISS_FESC) { \
+        if (pos + 3 > maxLen) return 0; \
+        output[pos++] = KISS_FESC; \
+        output[pos++] = (c_ == KISS_FEND) ? KISS_TFEND : KISS_TFESC; \
+      } else { \
+        if (pos + 2 > maxLen) return 0; \
+        output[pos++] = c_; \
+      } \
+    } while (0)
+  
+  if (maxLen < 3) {
+    return 0;
+  }
+  output[pos++] = KISS_FEND;
+  APPEND_ESCAPED((uint8_t)(((port & 0x0F) << 4) | KISS_CMD_DATA));
+  for (uint16_t i = 0; i < length; i++) {
+    APPEND_ESCAPED(frame->raw[i]);
+  }
+  
+  #undef APPEND_ESCAPED
+  
+  output[pos++] = KISS_FEND;
+  return pos;
+}
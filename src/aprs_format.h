@@ -0,0 +1,55 @@
+/**
+ * APRS帧格式化
+ *
+ * 将AX.25帧转换为TNC2文本格式: SOURCE>DEST[,PATH]:INFO，
+ * 或KISS二进制帧: FEND 命令字节 原始AX.25字节（转义） FEND
+ * 与平台无关，供UART输出和主机端工具共用
+ */
+
+#ifndef APRS_FORMAT_H
+#define APRS_FORMAT_H
+
+#include "aprs_config.h"
+#include "ax25_parser.h"
+#include <stdint.h>
+
+// KISS特殊字节
+#define KISS_FEND           0xC0        // 帧定界
+#define KISS_FESC           0xDB        // 转义
+#define KISS_TFEND          0xDC        // 转义后的FEND
+#define KISS_TFESC          0xDD        // 转义后的FESC
+#define KISS_CMD_DATA       0x00        // 数据帧命令（低4位），高4位为端口号
+
+// KISS帧的最大长度：两个FEND、命令字节和不含FCS的帧内容，全部转义时长度加倍
+#define KISS_MAX_ENCODED_LEN  (2 + 2 * (1 + AX25_MAX_FRAME_LEN - 2))
+
+/**
+ * 格式化呼号为 "CALL-SSID" 格式
+ * @param output 输出缓冲区（至少10字节）
+ * @param addr AX.25地址
+ * @return 输出长度（不含结束符）
+ */
+uint8_t formatCallsign(char* output, const APRS_AX25Address* addr);
+
+/**
+ * 格式化TNC2文本行（不含换行符）
+ * 路径中最后一个已转发的中继后加'*'（例如 "N0CALL>APRS,WIDE1-1*,WIDE2-1:..."）
+ * @param frame AX.25帧
+ * @param output 输出缓冲区
+ * @param maxLen 缓冲区大小（含结束符）
+ * @return 输出长度（不含结束符），信息字段超出缓冲区时截断
+ */
+uint16_t formatTNC2(const APRS_AX25Frame* frame, char* output, uint16_t maxLen);
+
+/**
+ * 编码KISS数据帧（不含FCS）
+ * 直接转义帧的原始字节，不解码呼号
+ * @param frame AX.25帧
+ * @param port KISS端口号 (0-15)
+ * @param output 输出缓冲区
+ * @param maxLen 缓冲区大小（KISS_MAX_ENCODED_LEN总是足够）
+ * @return 输出长度，缓冲区不足时返回0（二进制帧不截断）
+ */
+uint16_t formatKISS(const APRS_AX25Frame* frame, uint8_t port, uint8_t* output, uint16_t maxLen);
+
+#endif // APRS_FORMAT_H
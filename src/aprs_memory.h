@@ -0,0 +1,172 @@
+/**
+ * 静态内存预算
+ *
+ * 固件的RAM全部静态分配，大小由配置决定（队列深度、判决器数量、缓冲区大小等）。
+ * 本文件集中列出各部分的大小：
+ * - 解码器、重复帧抑制、采样环形缓冲区和DMA采样缓冲区从同一个静态内存池
+ *   （StaticArena）分配，内存池大小由下表求和得到，分配不会失败
+ * - UART输出、DMA管理等HAL对象是stm32_hal.cpp中的全局对象，只计入预算
+ * - MEMORY_SYSTEM_RESERVE为栈、堆和框架（RadioLib、串口缓冲区）保留
+ * 总量超过MEMORY_BUDGET_BYTES时编译失败；固件启动时输出各部分大小，
+ * 主机上aprs_memory工具按主机的类型大小输出同一张表（指针为8字节，略大于目标；
+ * HAL类使用aprs_platform.h中的HardwareSerial替身编译）。
+ */
+
+#ifndef APRS_MEMORY_H
+#define APRS_MEMORY_H
+
+#include "aprs_config.h"
+#include "aprs_decoder.h"
+#include "aprs_format.h"
+#include "dup_filter.h"
+#include "sample_ring.h"
+#include "stm32_hal.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <new>
+
+// 根据配置和是否支持DSP选择解码器
+#if USE_MULTI_SLICER
+  #include "aprs_multi_decoder.h"
+  typedef APRSMultiDecoder APRSDecoderType;
+  #define DECODER_TYPE "Multi-Slicer"
+#elif USE_CMSIS_DSP
+  #include "aprs_decoder_enhanced.h"
+  typedef APRSDecoderEnhanced APRSDecoderType;
+  #define DECODER_TYPE "Enhanced (CMSIS-DSP)"
+#else
+  typedef APRSDecoder APRSDecoderType;
+  #define DECODER_TYPE "Standard"
+#endif
+
+// RAM预算（字节），默认为各系列中最小型号的SRAM
+#ifndef MEMORY_BUDGET_BYTES
+  #if defined(STM32F4xx)
+    #define MEMORY_BUDGET_BYTES     (64 * 1024UL)   // STM32F401
+  #elif defined(STM32G4xx)
+    #define MEMORY_BUDGET_BYTES     (32 * 1024UL)   // STM32G431
+  #else
+    #define MEMORY_BUDGET_BYTES     (40 * 1024UL)   // STM32L412（主机构建按L412检查）
+  #endif
+#endif
+
+// 不在下表中的RAM：栈（含解码器处理数据块的局部缓冲区）、堆、RadioLib和框架的全局对象
+#ifndef MEMORY_SYSTEM_RESERVE
+  #define MEMORY_SYSTEM_RESERVE     (8 * 1024UL)
+#endif
+
+// 内存池中每个对象的对齐（字节）
+#define MEMORY_ARENA_ALIGN          8
+#define MEMORY_ALIGN(bytes)         (((bytes) + MEMORY_ARENA_ALIGN - 1) & ~(size_t)(MEMORY_ARENA_ALIGN - 1))
+
+// 预算表的一项
+typedef struct {
+  const char* name;
+  uint32_t bytes;
+  bool arena;                   // 是否从内存池分配
+} MemoryBudgetEntry;
+
+static constexpr MemoryBudgetEntry memoryBudget[] = {
+  { "解码器",         (uint32_t)sizeof(APRSDecoderType),          true },
+#if DUP_FILTER_ENABLE
+  { "重复帧抑制",     (uint32_t)sizeof(DuplicateFilter),          true },
+#endif
+#if USE_SAMPLE_RING
+  { "采样环形缓冲区", (uint32_t)sizeof(SampleRing),               true },
+#endif
+#if USE_DMA_CAPTURE
+  { "DMA采样缓冲区",  DMA_CAPTURE_BUFFER_SIZE,                    true },
+#endif
+  { "UART输出",       (uint32_t)sizeof(UARTOutput),               false },
+  { "DMA管理",        (uint32_t)sizeof(DMAManager),               false },
+  { "系统保留",       MEMORY_SYSTEM_RESERVE,                      false },
+};
+
+#define MEMORY_BUDGET_ENTRIES       (sizeof(memoryBudget) / sizeof(memoryBudget[0]))
+
+/**
+ * 内存池大小（各项按MEMORY_ARENA_ALIGN向上取整）
+ */
+constexpr size_t memoryArenaSize() {
+  size_t total = 0;
+  for (size_t i = 0; i < MEMORY_BUDGET_ENTRIES; i++) {
+    if (memoryBudget[i].arena) {
+      total += MEMORY_ALIGN(memoryBudget[i].bytes);
+    }
+  }
+  return total;
+}
+
+/**
+ * 预算表总量
+ */
+constexpr size_t memoryBudgetTotal() {
+  size_t total = memoryArenaSize();
+  for (size_t i = 0; i < MEMORY_BUDGET_ENTRIES; i++) {
+    if (!memoryBudget[i].arena) {
+      total += memoryBudget[i].bytes;
+    }
+  }
+  return total;
+}
+
+static_assert(memoryBudgetTotal() <= MEMORY_BUDGET_BYTES,
+              "RAM超出MEMORY_BUDGET_BYTES：减小FRAME_QUEUE_DEPTH、MULTI_SLICER_MAX、"
+              "DUP_FILTER_SIZE、UART_TX_RING_SIZE等，或调整MEMORY_BUDGET_BYTES");
+
+/**
+ * 静态内存池
+ * 只分配不释放；对象在静态初始化阶段创建，之后不再分配
+ */
+template <size_t Size>
+class StaticArena {
+public:
+  constexpr StaticArena() : storage(), used(0) {}
+
+  /**
+   * 在内存池中构造一个对象
+   * @return 空间不足时返回nullptr
+   */
+  template <typename T>
+  T* create() {
+    static_assert(alignof(T) <= MEMORY_ARENA_ALIGN, "对象的对齐要求超过MEMORY_ARENA_ALIGN");
+    uint8_t* p = allocate(sizeof(T));
+    return (p != nullptr) ? new (p) T() : nullptr;
+  }
+
+  /**
+   * 分配一块原始内存（已清零）
+   * @return 空间不足时返回nullptr
+   */
+  uint8_t* allocate(size_t bytes) {
+    if (bytes > Size - used) {
+      return nullptr;
+    }
+    uint8_t* p = storage + used;
+    used += MEMORY_ALIGN(bytes);
+    if (used > Size) {
+      used = Size;
+    }
+    return p;
+  }
+
+  /**
+   * 已分配的字节数
+   */
+  size_t getUsed() const {
+    return used;
+  }
+
+  /**
+   * 内存池大小
+   */
+  size_t getSize() const {
+    return Size;
+  }
+
+protected:
+  alignas(MEMORY_ARENA_ALIGN) uint8_t storage[Size];
+  size_t used;
+};
+
+#endif // APRS_MEMORY_H
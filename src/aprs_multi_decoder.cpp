@@ -0,0 +1,243 @@
+/**
+ * 多判决器APRS解码器实现
+ */
+
+#include "aprs_multi_decoder.h"
+#include <string.h>
+
+// 批量处理时每个数据块的采样数（所有判决器处理同一块后再收集帧）
+#define MULTI_BLOCK_SAMPLES   256
+
+// 默认判决器变体（按预期收益排序，判决器数量较少时保留前面的变体）
+// 依次为：标称、窄带宽（长窗口）、Mark +6dB（去加重失衡）、滞后1/8比特、
+//         Mark -3dB、提前1/8比特、宽带宽（短窗口）、Mark +3dB
+static const CorrelatorParams defaultParams[MULTI_SLICER_MAX] = {
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY,     0 },
+  { SAMPLES_PER_BIT * 5 / 4,         CORR_GAIN_UNITY,     0 },
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY * 4, 0 },
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY,     0x20000000 },
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY / 2, 0 },
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY,     -0x20000000 },
+  { SAMPLES_PER_BIT * 3 / 4,         CORR_GAIN_UNITY,     0 },
+  { SAMPLES_PER_BIT,                 CORR_GAIN_UNITY * 2, 0 },
+};
+
+APRSMultiDecoder::APRSMultiDecoder() {
+  numSlicers = 0;
+  for (uint8_t i = 0; i < MULTI_SLICER_MAX; i++) {
+    params[i] = defaultParams[i];
+  }
+  memset(slicerStats, 0, sizeof(slicerStats));
+  memset(recent, 0, sizeof(recent));
+  memset(&stats, 0, sizeof(stats));
+  recentNext = 0;
+  lastSlicer = 0;
+  sampleTime = 0;
+}
+
+bool APRSMultiDecoder::begin(uint8_t count) {
+  if (count == 0 || count > MULTI_SLICER_MAX) {
+    return false;
+  }
+  numSlicers = count;
+  
+  for (uint8_t i = 0; i < numSlicers; i++) {
+    if (!decoders[i].begin()) {
+      return false;
+    }
+    demods[i].setParams(&params[i]);
+    decoders[i].setDemodulator(&demods[i]);
+  }
+  
+  memset(slicerStats, 0, sizeof(slicerStats));
+  memset(recent, 0, sizeof(recent));
+  memset(&stats, 0, sizeof(stats));
+  recentNext = 0;
+  outputQueue.reset();
+  sampleTime = 0;
+  
+  return true;
+}
+
+void APRSMultiDecoder::setSlicerParams(uint8_t index, const CorrelatorParams* slicerParams) {
+  if (index < MULTI_SLICER_MAX) {
+    params[index] = *slicerParams;
+  }
+}
+
+void APRSMultiDecoder::processSample(uint8_t sample) {
+  for (uint8_t i = 0; i < numSlicers; i++) {
+    decoders[i].processSample(sample);
+  }
+  sampleTime++;
+  collectFrames();
+}
+
+void APRSMultiDecoder::processSamples(const uint8_t* samples, size_t count) {
+  while (count > 0) {
+    size_t n = (count > MULTI_BLOCK_SAMPLES) ? MULTI_BLOCK_SAMPLES : count;
+    
+    for (uint8_t i = 0; i < numSlicers; i++) {
+      decoders[i].processSamples(samples, n);
+    }
+    sampleTime += n;
+    collectFrames();
+    
+    samples += n;
+    count -= n;
+  }
+}
+
+void APRSMultiDecoder::processPackedSamples(const uint32_t* words, size_t count) {
+  const size_t blockWords = MULTI_BLOCK_SAMPLES / PACKED_SAMPLES_PER_WORD;
+  
+  while (count > 0) {
+    size_t n = (count > blockWords) ? blockWords : count;
+    
+    for (uint8_t i = 0; i < numSlicers; i++) {
+      decoders[i].processPackedSamples(words, n);
+    }
+    sampleTime += n * PACKED_SAMPLES_PER_WORD;
+    collectFrames();
+    
+    words += n;
+    count -= n;
+  }
+}
+
+void APRSMultiDecoder::processRing(SampleRing* ring) {
+  const uint32_t* words;
+  uint16_t n;
+  
+  while ((n = ring->peek(&words)) > 0) {
+    processPackedSamples(words, n);
+    ring->consume(n);
+  }
+  
+  stats.sampleOverflows = ring->getOverflows();
+  stats.ringHighWater = ring->getHighWater();
+}
+
+uint32_t APRSMultiDecoder::frameHash(const APRS_AX25Frame* frame) {
+  // FNV-1a，覆盖目标/源地址的原始字节和信息字段
+  uint32_t h = 2166136261u;
+  const uint8_t* p = frame->raw;
+  for (uint8_t i = 0; i < 2 * AX25_ADDR_LEN; i++) { h = (h ^ p[i]) * 16777619u; }
+  p = ax25GetInfo(frame);
+  for (uint16_t i = 0; i < frame->infoLen; i++) { h = (h ^ p[i]) * 16777619u; }
+  return h ^ frame->infoLen;
+}
+
+void APRSMultiDecoder::retireRecent(RecentFrame* entry) {
+  if (!entry->used) {
+    return;
+  }
+  // 仅一个判决器解出：该判决器的独有贡献
+  uint8_t mask = entry->slicerMask;
+  if (mask != 0 && (mask & (mask - 1)) == 0) {
+    slicerStats[entry->firstSlicer].framesUnique++;
+  }
+  entry->used = false;
+}
+
+void APRSMultiDecoder::collectFrames() {
+  for (uint8_t s = 0; s < numSlicers; s++) {
+    while (decoders[s].available()) {
+      APRS_AX25Frame* frame = decoders[s].getFrame();
+      if (frame == nullptr || !frame->valid) {
+        continue;
+      }
+      
+      slicerStats[s].framesDecoded++;
+      uint32_t hash = frameHash(frame);
+      
+      // 在去重窗口内查找同一帧
+      RecentFrame* match = nullptr;
+      for (uint8_t i = 0; i < MULTI_RECENT_DEPTH; i++) {
+        RecentFrame* r = &recent[i];
+        if (!r->used) {
+          continue;
+        }
+        if (sampleTime - r->sampleTime > MULTI_DEDUP_WINDOW) {
+          retireRecent(r);
+          continue;
+        }
+        if (r->fcs == frame->fcs && r->hash == hash) {
+          match = r;
+          break;
+        }
+      }
+      
+      if (match != nullptr) {
+        match->slicerMask |= (1 << s);
+        continue;
+      }
+      
+      // 新帧：记录并输出
+      RecentFrame* r = &recent[recentNext];
+      retireRecent(r);
+      r->hash = hash;
+      r->fcs = frame->fcs;
+      r->sampleTime = sampleTime;
+      r->slicerMask = (1 << s);
+      r->firstSlicer = s;
+      r->used = true;
+      recentNext = (recentNext + 1) % MULTI_RECENT_DEPTH;
+      
+      slicerStats[s].framesFirst++;
+      stats.framesReceived++;
+      stats.framesValid++;
+      if (frame->fixedBits > 0) {
+        stats.framesFixed++;
+      }
+      
+      outputQueue.push(frame, s);
+    }
+  }
+}
+
+bool APRSMultiDecoder::available() {
+  return outputQueue.available();
+}
+
+APRS_AX25Frame* APRSMultiDecoder::getFrame() {
+  return outputQueue.pop(&lastSlicer);
+}
+
+uint8_t APRSMultiDecoder::getFrameSlicer() {
+  return lastSlicer;
+}
+
+uint8_t APRSMultiDecoder::getNumSlicers() {
+  return numSlicers;
+}
+
+SlicerStatistics* APRSMultiDecoder::getSlicerStatistics(uint8_t index) {
+  // 先结算已过期的去重记录
+  for (uint8_t i = 0; i < MULTI_RECENT_DEPTH; i++) {
+    if (recent[i].used && sampleTime - recent[i].sampleTime > MULTI_DEDUP_WINDOW) {
+      retireRecent(&recent[i]);
+    }
+  }
+  return &slicerStats[index < MULTI_SLICER_MAX ? index : 0];
+}
+
+uint8_t APRSMultiDecoder::getSignalQuality() {
+  return (numSlicers > 0) ? decoders[0].getSignalQuality() : 0;
+}
+
+DecoderStatistics* APRSMultiDecoder::getStatistics() {
+  // 字节、CRC错误（含放弃修复）、超时和门控放弃计数取自第一个判决器，帧数（含修复帧数）为去重后的结果
+  if (numSlicers > 0) {
+    DecoderStatistics* first = decoders[0].getStatistics();
+    stats.framesCRCError = first->framesCRCError;
+    stats.framesRepairAbandoned = first->framesRepairAbandoned;
+    stats.bytesReceived = first->bytesReceived;
+    stats.carrierLost = first->carrierLost;
+    stats.syncTimeout = first->syncTimeout;
+    stats.gateAbortedFrames = first->gateAbortedFrames;
+  }
+  stats.framesDropped = outputQueue.getDropped();
+  stats.queueHighWater = outputQueue.getHighWater();
+  return &stats;
+}
@@ -0,0 +1,163 @@
+/**
+ * 多判决器APRS解码器
+ * 
+ * 在同一采样流上并行运行N个解调/判决变体，每个变体拥有独立的
+ * 滑动窗口相关解调器、NRZI解码器和AX.25解析器。变体之间在
+ * Mark/Space增益平衡、时钟相位偏移和相关窗口长度（滤波带宽）上不同。
+ * 
+ * 多个判决器解出的同一帧按FCS+内容合并，每个数据包只输出一次，
+ * 并记录是哪个判决器最先解出，以便根据统计裁剪判决器组。
+ */
+
+#ifndef APRS_MULTI_DECODER_H
+#define APRS_MULTI_DECODER_H
+
+#include "aprs_config.h"
+#include "aprs_decoder.h"
+#include "afsk_correlator.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// 判决器组配置
+#ifndef MULTI_SLICER_MAX
+  #define MULTI_SLICER_MAX      8       // 最大判决器数量
+#endif
+#ifndef MULTI_SLICER_DEFAULT
+  #define MULTI_SLICER_DEFAULT  4       // 默认判决器数量
+#endif
+#define MULTI_RECENT_DEPTH      8       // 去重记录数量
+#define MULTI_DEDUP_WINDOW      (AFSK_SAMPLE_RATE / 4)  // 去重时间窗口（采样数）
+
+// 单个判决器的统计信息
+typedef struct {
+  uint32_t framesDecoded;       // 解出的有效帧数（含重复）
+  uint32_t framesFirst;         // 最先解出的帧数（被输出的帧）
+  uint32_t framesUnique;        // 仅由该判决器解出的帧数
+} SlicerStatistics;
+
+class APRSMultiDecoder {
+public:
+  APRSMultiDecoder();
+  
+  /**
+   * 初始化判决器组
+   * 未通过setSlicerParams设置的判决器使用内置的默认变体
+   * @param numSlicers 判决器数量 (1 - MULTI_SLICER_MAX)
+   * @return 成功返回true
+   */
+  bool begin(uint8_t numSlicers = MULTI_SLICER_DEFAULT);
+  
+  /**
+   * 设置判决器参数（在begin之前调用）
+   * @param index 判决器索引
+   * @param params 解调参数
+   */
+  void setSlicerParams(uint8_t index, const CorrelatorParams* params);
+  
+  /**
+   * 处理单个采样
+   */
+  void processSample(uint8_t sample);
+  
+  /**
+   * 批量处理采样
+   * @param samples 采样数组 (0或1)
+   * @param count 采样数量
+   */
+  void processSamples(const uint8_t* samples, size_t count);
+  
+  /**
+   * 批量处理位压缩采样
+   * @param words 压缩采样数组（每字32个采样，最早的采样在最高位）
+   * @param count 字数
+   */
+  void processPackedSamples(const uint32_t* words, size_t count);
+  
+  /**
+   * 处理采样环形缓冲区中的全部数据（在loop()中调用）
+   * @param ring 由采样中断写入的环形缓冲区
+   */
+  void processRing(SampleRing* ring);
+  
+  /**
+   * 检查是否有可用的（已去重的）帧
+   */
+  bool available();
+  
+  /**
+   * 获取下一帧
+   * 返回的指针在下一次调用getFrame()之前有效
+   * @return 指向帧的指针，无帧时返回nullptr
+   */
+  APRS_AX25Frame* getFrame();
+  
+  /**
+   * 获取最近一次getFrame返回的帧由哪个判决器解出
+   */
+  uint8_t getFrameSlicer();
+  
+  /**
+   * 获取判决器数量
+   */
+  uint8_t getNumSlicers();
+  
+  /**
+   * 获取判决器统计信息
+   * @param index 判决器索引
+   */
+  SlicerStatistics* getSlicerStatistics(uint8_t index);
+  
+  /**
+   * 获取信号质量（取自第一个判决器）
+   * @return 信号质量 0-100
+   */
+  uint8_t getSignalQuality();
+  
+  /**
+   * 获取合并后的解码统计（帧数为去重后的结果）
+   */
+  DecoderStatistics* getStatistics();
+
+protected:
+  // 去重记录
+  typedef struct {
+    uint32_t hash;              // 帧内容哈希
+    uint32_t sampleTime;        // 首次解出的采样时刻
+    uint16_t fcs;               // 帧校验序列
+    uint8_t slicerMask;         // 解出该帧的判决器位掩码
+    uint8_t firstSlicer;        // 最先解出的判决器
+    bool used;
+  } RecentFrame;
+  
+  APRSDecoder decoders[MULTI_SLICER_MAX];
+  AFSKCorrelatorDemodulator demods[MULTI_SLICER_MAX];
+  CorrelatorParams params[MULTI_SLICER_MAX];
+  SlicerStatistics slicerStats[MULTI_SLICER_MAX];
+  uint8_t numSlicers;
+  
+  RecentFrame recent[MULTI_RECENT_DEPTH];
+  uint8_t recentNext;
+  
+  FrameQueue outputQueue;       // 去重后的输出队列（标签为判决器编号）
+  uint8_t lastSlicer;
+  
+  uint32_t sampleTime;
+  DecoderStatistics stats;
+  
+  /**
+   * 收集各判决器解出的帧并去重
+   */
+  void collectFrames();
+  
+  /**
+   * 计算帧内容哈希
+   */
+  static uint32_t frameHash(const APRS_AX25Frame* frame);
+  
+  /**
+   * 记录过期时统计仅由单个判决器解出的帧
+   */
+  void retireRecent(RecentFrame* entry);
+};
+
+#endif // APRS_MULTI_DECODER_H
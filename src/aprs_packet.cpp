@@ -0,0 +1,842 @@
+/**
+ * APRS信息字段解码实现
+ */
+
+#include "aprs_packet.h"
+#include <string.h>
+
+// 压缩格式速度：1.08^n - 1 节（n = s - 33）
+static const uint16_t compressedSpeed[90] = {
+  0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,   1,   2,   2,   2,
+  2,   2,   3,   3,   3,   4,   4,   4,   5,   5,   6,   6,   7,   8,   8,
+  9,  10,  11,  12,  13,  14,  15,  16,  18,  19,  21,  22,  24,  26,  29,
+  31,  33,  36,  39,  42,  46,  50,  54,  58,  63,  68,  73,  79,  86,  93,
+  100, 108, 117, 127, 137, 148, 160, 173, 186, 201, 218, 235, 254, 274, 296,
+  320, 346, 374, 404, 436, 471, 509, 549, 594, 641, 692, 748, 808, 873, 942
+};
+
+// 压缩格式高度：1.002^cs 英尺，cs = c' * 91 + s'
+// 分解为 1.002^(91*c')（Q8）与 1.002^s'（Q15）的乘积
+static const uint32_t altitudeCoarse[90] = {
+  256,        307,        368,        442,        530,        635,
+  762,        914,       1096,       1315,       1577,       1892,
+  2269,       2721,       3264,       3915,       4695,       5631,
+  6754,       8101,       9716,      11653,      13977,      16764,
+  20107,      24116,      28925,      34692,      41610,      49906,
+  59858,      71793,      86108,     103278,     123871,     148571,
+  178195,     213726,     256343,     307457,     368762,     442292,
+  530483,     636260,     763127,     915292,    1097798,    1316694,
+  1579238,    1894132,    2271815,    2724806,    3268122,    3919773,
+  4701361,    5638794,    6763148,    8111694,    9729134,   11669087,
+  13995858,   16786578,   20133758,   24148352,   28963441,   34738641,
+  41665393,   49973313,   59937800,   71889168,   86223594,  103416248,
+  124037053,  148769566,  178433649,  214012636,  256685937,  307868131,
+  369255858,  442884064,  531193452,  637111394,  764148969,  916517350,
+  1099267403, 1318457118, 1581352424, 1896668048, 2274856402, 2728454066
+};
+static const uint16_t altitudeFine[91] = {
+  32768, 32834, 32899, 32965, 33031, 33097, 33163, 33230, 33296, 33363,
+  33429, 33496, 33563, 33630, 33698, 33765, 33832, 33900, 33968, 34036,
+  34104, 34172, 34240, 34309, 34378, 34446, 34515, 34584, 34653, 34723,
+  34792, 34862, 34931, 35001, 35071, 35141, 35212, 35282, 35353, 35423,
+  35494, 35565, 35636, 35708, 35779, 35851, 35922, 35994, 36066, 36138,
+  36211, 36283, 36356, 36428, 36501, 36574, 36647, 36721, 36794, 36868,
+  36941, 37015, 37089, 37163, 37238, 37312, 37387, 37462, 37537, 37612,
+  37687, 37762, 37838, 37913, 37989, 38065, 38141, 38218, 38294, 38371,
+  38447, 38524, 38601, 38679, 38756, 38833, 38911, 38989, 39067, 39145,
+  39223
+};
+
+#define MICRO_DEGREES   1000000L
+
+static inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+static inline bool isAlnum(char c) {
+  return isDigit(c) || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+}
+
+/**
+ * 消息编号：1-5个字母或数字
+ */
+static bool isMessageId(const char* p, uint16_t len) {
+  if (len < 1 || len > 5) {
+    return false;
+  }
+  for (uint16_t i = 0; i < len; i++) {
+    if (!isAlnum(p[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static inline bool isBase91(char c) {
+  return c >= '!' && c <= '{';
+}
+
+/**
+ * 压缩位置以符号表标识开头，未压缩位置以数字（或模糊度空格）开头
+ */
+static inline bool isCompressedStart(char c) {
+  return c == '/' || c == '\\' || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'j');
+}
+
+/**
+ * 压缩格式的cs字节是否为航向/速度（T的NMEA来源不是GGA）
+ */
+static inline bool isCompressedCourseSpeed(char c, char s, char t) {
+  return c >= '!' && c <= 'z' && s >= '!' && s - 33 < 90 &&
+         isBase91(t) && (((t - 33) >> 3) & 3) != 2;
+}
+
+/**
+ * 解析固定位数的十进制数
+ */
+static bool parseNumber(const char* p, uint8_t digits, int32_t* value) {
+  int32_t v = 0;
+  for (uint8_t i = 0; i < digits; i++) {
+    if (!isDigit(p[i])) {
+      return false;
+    }
+    v = v * 10 + (p[i] - '0');
+  }
+  *value = v;
+  return true;
+}
+
+/**
+ * 解析base91数
+ */
+static bool parseBase91(const char* p, uint8_t digits, uint32_t* value) {
+  uint32_t v = 0;
+  for (uint8_t i = 0; i < digits; i++) {
+    if (!isBase91(p[i])) {
+      return false;
+    }
+    v = v * 91 + (uint32_t)(p[i] - 33);
+  }
+  *value = v;
+  return true;
+}
+
+/**
+ * 解析未压缩坐标 "DDMM.hh" 或 "DDDMM.hh"（不含半球标识）
+ * 模糊度空格按0处理
+ * @param p 坐标文本
+ * @param degDigits 度的位数（纬度2，经度3）
+ * @param micro 输出：微度
+ * @param spaces 输出：空格个数
+ */
+static bool parseCoordinate(const char* p, uint8_t degDigits, int32_t* micro, uint8_t* spaces) {
+  int32_t deg = 0, minHund = 0;
+  uint8_t n = 0;
+
+  if (p[degDigits + 2] != '.') {
+    return false;
+  }
+
+  for (uint8_t i = 0; i < degDigits + 5; i++) {
+    if (i == degDigits + 2) {
+      continue;                           // 小数点
+    }
+    char c = p[i];
+    uint8_t d;
+    if (isDigit(c)) {
+      d = c - '0';
+    } else if (c == ' ' && i >= degDigits) {
+      d = 0;
+      n++;
+    } else {
+      return false;
+    }
+    if (i < degDigits) {
+      deg = deg * 10 + d;
+    } else {
+      minHund = minHund * 10 + d;         // 分 × 100
+    }
+  }
+
+  if (minHund >= 6000) {
+    return false;
+  }
+  *micro = deg * MICRO_DEGREES + (minHund * 1000 + 3) / 6;
+  *spaces = n;
+  return true;
+}
+
+/**
+ * 解析天气字段值：可带负号的数字；全为'.'或空格表示缺失
+ * @return 1有值，0缺失，-1格式错误
+ */
+static int8_t parseWeatherValue(const char* p, uint8_t digits, int32_t* value) {
+  int32_t v = 0;
+  bool negative = false;
+  uint8_t missing = 0;
+
+  for (uint8_t i = 0; i < digits; i++) {
+    char c = p[i];
+    if (isDigit(c)) {
+      v = v * 10 + (c - '0');
+    } else if (c == '-' && i == 0) {
+      negative = true;
+    } else if (c == '.' || c == ' ') {
+      missing++;
+    } else {
+      return -1;
+    }
+  }
+
+  if (missing == digits) {
+    return 0;
+  }
+  if (missing > 0) {
+    return -1;
+  }
+  *value = negative ? -v : v;
+  return 1;
+}
+
+/**
+ * 天气字段的数据位数，0表示不是天气字段
+ */
+static uint8_t weatherFieldWidth(char key) {
+  switch (key) {
+    case 'c': case 's': case 'g': case 't':
+    case 'r': case 'p': case 'P': case 'L': case 'l':
+      return 3;
+    case 'h':
+      return 2;
+    case 'b':
+      return 5;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * 解析十进制小数，结果以千分之一为单位
+ * @param p 输入，返回时指向数字之后
+ * @param end 输入结束位置
+ */
+static bool parseFixed(const char** p, const char* end, int32_t* value) {
+  const char* s = *p;
+  bool negative = false;
+  int32_t v = 0;
+  uint8_t intDigits = 0, fracDigits = 0;
+
+  if (s < end && *s == '-') {
+    negative = true;
+    s++;
+  }
+  while (s < end && isDigit(*s)) {
+    if (++intDigits > 6) {
+      return false;
+    }
+    v = v * 10 + (*s++ - '0');
+  }
+  v *= 1000;
+  if (s < end && *s == '.') {
+    s++;
+    int32_t scale = 100;
+    while (s < end && isDigit(*s)) {
+      if (fracDigits++ < 3) {
+        v += (*s - '0') * scale;
+        scale /= 10;
+      }
+      s++;
+    }
+  }
+  if (intDigits == 0 && fracDigits == 0) {
+    return false;
+  }
+
+  *value = negative ? -v : v;
+  *p = s;
+  return true;
+}
+
+APRSPacket::APRSPacket() {
+  frame = nullptr;
+  info = nullptr;
+  infoLen = 0;
+  type = APRS_TYPE_UNKNOWN;
+  bodyOffset = 0;
+  nameLen = 0;
+}
+
+bool APRSPacket::parse(const APRS_AX25Frame* ax25Frame) {
+  frame = ax25Frame;
+  info = (const char*)ax25GetInfo(ax25Frame);
+  infoLen = ax25Frame->infoLen;
+  type = APRS_TYPE_UNKNOWN;
+  bodyOffset = 0;
+  nameLen = 0;
+
+  if (infoLen == 0) {
+    return false;
+  }
+
+  switch (info[0]) {
+    case '!':
+    case '=':
+      type = APRS_TYPE_POSITION;
+      bodyOffset = 1;
+      break;
+
+    case '/':
+    case '@':
+      // 7字符时间戳之后为位置
+      if (infoLen >= 8) {
+        type = APRS_TYPE_POSITION;
+        bodyOffset = 8;
+      }
+      break;
+
+    case '`':
+    case '\'':
+    case 0x1C:
+    case 0x1D:
+      if (infoLen >= 9) {
+        type = APRS_TYPE_MIC_E;
+        bodyOffset = 1;
+      }
+      break;
+
+    case ':':
+      // 9字符收信人，以':'结束
+      if (infoLen >= 11 && info[10] == ':') {
+        type = APRS_TYPE_MESSAGE;
+        bodyOffset = 11;
+      }
+      break;
+
+    case ';':
+      // 9字符名称、状态（'*'有效/'_'删除）、7字符时间戳之后为位置
+      if (infoLen >= 18 && (info[10] == '*' || info[10] == '_')) {
+        type = APRS_TYPE_OBJECT;
+        nameLen = 9;
+        bodyOffset = 18;
+      }
+      break;
+
+    case ')':
+      // 3-9字符名称，以'!'（有效）或'_'（删除）结束
+      for (uint8_t i = 4; i <= 10 && i < infoLen; i++) {
+        if (info[i] == '!' || info[i] == '_') {
+          type = APRS_TYPE_ITEM;
+          nameLen = i - 1;
+          bodyOffset = i + 1;
+          break;
+        }
+      }
+      break;
+
+    case '_':
+      // 8字符时间戳（MMDDhhmm）之后为天气数据
+      if (infoLen >= 9) {
+        type = APRS_TYPE_WEATHER;
+        bodyOffset = 9;
+      }
+      break;
+
+    case 'T':
+      if (infoLen >= 2 && info[1] == '#') {
+        type = APRS_TYPE_TELEMETRY;
+        bodyOffset = 2;
+      }
+      break;
+
+    case '>':
+      type = APRS_TYPE_STATUS;
+      bodyOffset = 1;
+      break;
+  }
+
+  return type != APRS_TYPE_UNKNOWN;
+}
+
+APRSPacketType APRSPacket::getType() {
+  return type;
+}
+
+bool APRSPacket::decodeUncompressed(const char* p, APRSPosition* position) {
+  uint8_t latSpaces, lonSpaces;
+
+  // DDMM.hhN/DDDMM.hhW$
+  if (!parseCoordinate(p, 2, &position->latitude, &latSpaces) ||
+      !parseCoordinate(p + 9, 3, &position->longitude, &lonSpaces)) {
+    return false;
+  }
+  if (position->latitude > 90 * MICRO_DEGREES || position->longitude > 180 * MICRO_DEGREES) {
+    return false;
+  }
+
+  if (p[7] == 'S') {
+    position->latitude = -position->latitude;
+  } else if (p[7] != 'N') {
+    return false;
+  }
+  if (p[17] == 'W') {
+    position->longitude = -position->longitude;
+  } else if (p[17] != 'E') {
+    return false;
+  }
+
+  position->symbolTable = p[8];
+  position->symbolCode = p[18];
+  position->ambiguity = latSpaces;
+  position->compressed = false;
+  position->hasCourseSpeed = false;
+  position->course = 0;
+  position->speed = 0;
+  return true;
+}
+
+bool APRSPacket::decodeCompressed(const char* p, APRSPosition* position) {
+  uint32_t y, x;
+
+  // /YYYYXXXX$csT
+  if (!parseBase91(p + 1, 4, &y) || !parseBase91(p + 5, 4, &x)) {
+    return false;
+  }
+
+  position->latitude = 90 * MICRO_DEGREES - (int32_t)(((int64_t)y * MICRO_DEGREES + 190463) / 380926);
+  position->longitude = (int32_t)(((int64_t)x * MICRO_DEGREES + 95231) / 190463) - 180 * MICRO_DEGREES;
+  if (position->latitude < -90 * MICRO_DEGREES || position->longitude > 180 * MICRO_DEGREES) {
+    return false;
+  }
+
+  // 叠加字符a-j表示数字0-9
+  char table = p[0];
+  position->symbolTable = (table >= 'a' && table <= 'j') ? (char)('0' + table - 'a') : table;
+  position->symbolCode = p[9];
+  position->ambiguity = 0;
+  position->compressed = true;
+  position->hasCourseSpeed = false;
+  position->course = 0;
+  position->speed = 0;
+
+  if (isCompressedCourseSpeed(p[10], p[11], p[12])) {
+    uint16_t course = (uint16_t)(p[10] - 33) * 4;
+    position->course = (course == 0) ? 360 : course;
+    position->speed = compressedSpeed[p[11] - 33];
+    position->hasCourseSpeed = true;
+  }
+  return true;
+}
+
+bool APRSPacket::decodeMicE(APRSPosition* position) {
+  const uint8_t* dest = ax25GetAddressField(frame, AX25_ADDR_DESTINATION);
+  uint8_t digits[6];
+  uint8_t spaces = 0;
+
+  // 目标地址6个字符：纬度数字，第1-3个字符同时携带消息位，第4-6个字符携带北/南、经度偏移、东/西标志
+  // 'A'-'K'（自定义消息位）只用于第1-3个字符，'L'只用于第4-6个字符
+  for (uint8_t i = 0; i < 6; i++) {
+    char c = (char)(dest[i] >> 1);
+    bool messageByte = i < 3;
+    if (c >= '0' && c <= '9') {
+      digits[i] = c - '0';
+    } else if (messageByte && c >= 'A' && c <= 'J') {
+      digits[i] = c - 'A';
+    } else if (c >= 'P' && c <= 'Y') {
+      digits[i] = c - 'P';
+    } else if ((messageByte && c == 'K') || (!messageByte && c == 'L') || c == 'Z') {
+      digits[i] = 0;                      // 模糊度空格
+      spaces++;
+    } else {
+      return false;
+    }
+  }
+  bool north = (dest[3] >> 1) >= 'P';
+  bool lonOffset = (dest[4] >> 1) >= 'P';
+  bool west = (dest[5] >> 1) >= 'P';
+
+  int32_t latDeg = digits[0] * 10 + digits[1];
+  int32_t latMinHund = digits[2] * 1000 + digits[3] * 100 + digits[4] * 10 + digits[5];
+  if (latDeg > 90 || latMinHund >= 6000 || (latDeg == 90 && latMinHund > 0)) {
+    return false;
+  }
+
+  // 信息字段：经度3字节、速度/航向3字节、符号、符号表
+  const uint8_t* p = (const uint8_t*)info;
+  int32_t lonDeg = p[1] - 28;
+  if (lonOffset) {
+    lonDeg += 100;
+  }
+  if (lonDeg >= 180 && lonDeg <= 189) {
+    lonDeg -= 80;
+  } else if (lonDeg >= 190 && lonDeg <= 199) {
+    lonDeg -= 190;
+  }
+  int32_t lonMin = p[2] - 28;
+  if (lonMin >= 60) {
+    lonMin -= 60;
+  }
+  int32_t lonHund = p[3] - 28;
+  if (lonDeg < 0 || lonDeg > 179 || lonMin < 0 || lonMin > 59 || lonHund < 0 || lonHund > 99) {
+    return false;
+  }
+
+  position->latitude = latDeg * MICRO_DEGREES + (latMinHund * 1000 + 3) / 6;
+  position->longitude = lonDeg * MICRO_DEGREES + ((lonMin * 100 + lonHund) * 1000 + 3) / 6;
+  if (!north) {
+    position->latitude = -position->latitude;
+  }
+  if (west) {
+    position->longitude = -position->longitude;
+  }
+
+  // 速度 = SP*10 + DC/10，航向 = (DC%10)*100 + SE
+  int32_t sp = p[4] - 28, dc = p[5] - 28, se = p[6] - 28;
+  int32_t speed = sp * 10 + dc / 10;
+  int32_t course = (dc % 10) * 100 + se;
+  if (speed >= 800) {
+    speed -= 800;
+  }
+  if (course >= 400) {
+    course -= 400;
+  }
+
+  position->symbolCode = (char)p[7];
+  position->symbolTable = (char)p[8];
+  position->ambiguity = spaces;
+  position->compressed = false;
+  position->hasCourseSpeed = speed >= 0 && course >= 0 && course <= 360;
+  position->course = position->hasCourseSpeed ? (uint16_t)course : 0;
+  position->speed = position->hasCourseSpeed ? (uint16_t)speed : 0;
+  return true;
+}
+
+bool APRSPacket::getPosition(APRSPosition* position) {
+  switch (type) {
+    case APRS_TYPE_POSITION:
+    case APRS_TYPE_OBJECT:
+    case APRS_TYPE_ITEM: {
+      const char* p = info + bodyOffset;
+      uint16_t remaining = infoLen - bodyOffset;
+
+      if (remaining >= 13 && isCompressedStart(p[0])) {
+        return decodeCompressed(p, position);
+      }
+      if (remaining < 19 || !decodeUncompressed(p, position)) {
+        return false;
+      }
+
+      // 航向/速度扩展 "CCC/SSS"（天气符号时为风向/风速，由getWeather解码）
+      int32_t course, speed;
+      if (remaining >= 26 && p[22] == '/' && position->symbolCode != '_' &&
+          parseNumber(p + 19, 3, &course) && parseNumber(p + 23, 3, &speed) && course <= 360) {
+        position->course = (uint16_t)course;
+        position->speed = (uint16_t)speed;
+        position->hasCourseSpeed = true;
+      }
+      return true;
+    }
+
+    case APRS_TYPE_MIC_E:
+      return decodeMicE(position);
+
+    default:
+      return false;
+  }
+}
+
+uint16_t APRSPacket::getPositionEnd() {
+  const char* p = info + bodyOffset;
+  uint16_t remaining = infoLen - bodyOffset;
+
+  if (remaining >= 13 && isCompressedStart(p[0])) {
+    return bodyOffset + 13;
+  }
+  if (remaining < 19) {
+    return 0;
+  }
+
+  uint16_t end = bodyOffset + 19;
+  if (remaining >= 26) {
+    // 7字符数据扩展：CCC/SSS、PHGphgd、RNGrrrr、DFSshgd
+    const char* e = p + 19;
+    if ((e[3] == '/' && isDigit(e[0]) && isDigit(e[4])) ||
+        memcmp(e, "PHG", 3) == 0 || memcmp(e, "RNG", 3) == 0 || memcmp(e, "DFS", 3) == 0) {
+      end += 7;
+    }
+  }
+  return end;
+}
+
+bool APRSPacket::getComment(const char** text, uint16_t* len) {
+  uint16_t start;
+
+  switch (type) {
+    case APRS_TYPE_POSITION:
+    case APRS_TYPE_OBJECT:
+    case APRS_TYPE_ITEM:
+      start = getPositionEnd();
+      if (start == 0) {
+        return false;
+      }
+      break;
+
+    case APRS_TYPE_MIC_E:
+      start = 9;
+      break;
+
+    case APRS_TYPE_STATUS:
+      start = 1;
+      break;
+
+    default:
+      return false;
+  }
+
+  *text = info + start;
+  *len = infoLen - start;
+  return true;
+}
+
+bool APRSPacket::getAltitude(int32_t* feet) {
+  const char* comment;
+  uint16_t len;
+
+  if (type == APRS_TYPE_POSITION || type == APRS_TYPE_OBJECT || type == APRS_TYPE_ITEM) {
+    // 压缩格式：T的NMEA来源为GGA时cs为高度
+    const char* p = info + bodyOffset;
+    if (infoLen - bodyOffset >= 13 && isCompressedStart(p[0])) {
+      char c = p[10], s = p[11], t = p[12];
+      if (c >= '!' && c <= 'z' && s >= '!' && s <= '{' && isBase91(t) &&
+          (((t - 33) >> 3) & 3) == 2) {
+        *feet = (int32_t)(((uint64_t)altitudeCoarse[c - 33] * altitudeFine[s - 33]) >> 23);
+        return true;
+      }
+    }
+  } else if (type == APRS_TYPE_MIC_E) {
+    // Mic-E：状态文本开头（可有1个类型字符）的 "xxx}"，单位米，偏移10000
+    for (uint16_t i = 9; i <= 10 && i + 4 <= infoLen; i++) {
+      uint32_t meters;
+      if (info[i + 3] == '}' && parseBase91(info + i, 3, &meters)) {
+        *feet = ((int32_t)meters - 10000) * 3281 / 1000;
+        return true;
+      }
+    }
+  }
+
+  // 注释中的 "/A=nnnnnn"（英尺，可为负）
+  if (!getComment(&comment, &len)) {
+    return false;
+  }
+  for (uint16_t i = 0; i + 9 <= len; i++) {
+    if (comment[i] == '/' && comment[i + 1] == 'A' && comment[i + 2] == '=') {
+      const char* v = comment + i + 3;
+      int32_t value;
+      if (v[0] == '-' && parseNumber(v + 1, 5, &value)) {
+        *feet = -value;
+        return true;
+      }
+      if (parseNumber(v, 6, &value)) {
+        *feet = value;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool APRSPacket::getObject(APRSObject* object) {
+  if (type != APRS_TYPE_OBJECT && type != APRS_TYPE_ITEM) {
+    return false;
+  }
+
+  uint8_t len = nameLen;
+  while (len > 0 && info[len] == ' ') {
+    len--;                                // 去除填充空格
+  }
+  object->name = info + 1;
+  object->nameLen = len;
+  object->alive = (type == APRS_TYPE_OBJECT) ? (info[10] == '*') : (info[bodyOffset - 1] == '!');
+  return true;
+}
+
+bool APRSPacket::getMessage(APRSMessage* message) {
+  if (type != APRS_TYPE_MESSAGE) {
+    return false;
+  }
+
+  uint8_t len = 9;
+  while (len > 0 && info[len] == ' ') {
+    len--;
+  }
+  message->addressee = info + 1;
+  message->addresseeLen = len;
+
+  const char* text = info + bodyOffset;
+  uint16_t textLen = infoLen - bodyOffset;
+
+  // 确认/拒绝："ackNNNNN" / "rejNNNNN"，其后只能是消息编号；
+  // 其他以ack/rej开头的文本（如"acknowledged"）是普通消息
+  if (textLen >= 3 && (memcmp(text, "ack", 3) == 0 || memcmp(text, "rej", 3) == 0) &&
+      isMessageId(text + 3, textLen - 3)) {
+    message->kind = (text[0] == 'a') ? APRS_MESSAGE_ACK : APRS_MESSAGE_REJ;
+    message->id = text + 3;
+    message->idLen = (uint8_t)(textLen - 3);
+    message->text = text;
+    message->textLen = 0;
+    return true;
+  }
+
+  // 消息编号：末尾的 "{NNNNN"（回复确认格式 "{MM}AA" 只取MM）
+  message->kind = APRS_MESSAGE_TEXT;
+  message->id = nullptr;
+  message->idLen = 0;
+  uint16_t limit = (textLen > 7) ? textLen - 7 : 0;
+  for (uint16_t i = textLen; i > limit; i--) {
+    if (text[i - 1] == '{') {
+      uint8_t idLen = 0;
+      while (i + idLen < textLen && text[i + idLen] != '}' && idLen < 5) {
+        idLen++;
+      }
+      message->id = text + i;
+      message->idLen = idLen;
+      textLen = i - 1;
+      break;
+    }
+  }
+
+  message->text = text;
+  message->textLen = textLen;
+  return true;
+}
+
+bool APRSPacket::getWeather(APRSWeather* weather) {
+  const char* p;
+  const char* end = info + infoLen;
+
+  memset(weather, 0, sizeof(APRSWeather));
+
+  if (type == APRS_TYPE_WEATHER) {
+    p = info + bodyOffset;
+  } else if (type == APRS_TYPE_POSITION || type == APRS_TYPE_OBJECT || type == APRS_TYPE_ITEM) {
+    // 符号为'_'的位置报告：风向/风速紧跟位置（压缩格式在cs中）
+    const char* pos = info + bodyOffset;
+    uint16_t remaining = infoLen - bodyOffset;
+    int32_t value;
+
+    if (remaining >= 13 && isCompressedStart(pos[0])) {
+      if (pos[9] != '_') {
+        return false;
+      }
+      if (isCompressedCourseSpeed(pos[10], pos[11], pos[12])) {
+        weather->windDirection = (uint16_t)(pos[10] - 33) * 4;
+        weather->windSpeed = (uint16_t)(compressedSpeed[pos[11] - 33] * 115 / 100);  // 节→英里/小时
+        weather->fields |= APRS_WX_WIND_DIR | APRS_WX_WIND_SPEED;
+      }
+      p = pos + 13;
+    } else {
+      if (remaining < 19 || pos[18] != '_') {
+        return false;
+      }
+      p = pos + 19;
+      if (remaining >= 26 && p[3] == '/') {
+        if (parseWeatherValue(p, 3, &value) > 0) {
+          weather->windDirection = (uint16_t)value;
+          weather->fields |= APRS_WX_WIND_DIR;
+        }
+        if (parseWeatherValue(p + 4, 3, &value) > 0) {
+          weather->windSpeed = (uint16_t)value;
+          weather->fields |= APRS_WX_WIND_SPEED;
+        }
+        p += 7;
+      }
+    }
+  } else {
+    return false;
+  }
+
+  // 字段序列：单字符标识 + 定长数值，遇到其他字符（注释、软件类型）结束
+  while (p < end) {
+    char key = *p;
+    uint8_t width = weatherFieldWidth(key);
+    int32_t value;
+    if (width == 0 || p + 1 + width > end) {
+      break;
+    }
+    int8_t result = parseWeatherValue(p + 1, width, &value);
+    if (result < 0) {
+      break;
+    }
+    p += 1 + width;
+    if (result == 0) {
+      continue;
+    }
+
+    switch (key) {
+      case 'c': weather->windDirection = (uint16_t)value; weather->fields |= APRS_WX_WIND_DIR; break;
+      case 's': weather->windSpeed = (uint16_t)value; weather->fields |= APRS_WX_WIND_SPEED; break;
+      case 'g': weather->windGust = (uint16_t)value; weather->fields |= APRS_WX_WIND_GUST; break;
+      case 't': weather->temperature = (int16_t)value; weather->fields |= APRS_WX_TEMPERATURE; break;
+      case 'r': weather->rain1h = (uint16_t)value; weather->fields |= APRS_WX_RAIN_1H; break;
+      case 'p': weather->rain24h = (uint16_t)value; weather->fields |= APRS_WX_RAIN_24H; break;
+      case 'P': weather->rainMidnight = (uint16_t)value; weather->fields |= APRS_WX_RAIN_MIDNIGHT; break;
+      case 'h':
+        weather->humidity = (uint8_t)((value == 0) ? 100 : value);   // h00表示100%
+        weather->fields |= APRS_WX_HUMIDITY;
+        break;
+      case 'b': weather->pressure = (uint16_t)value; weather->fields |= APRS_WX_PRESSURE; break;
+      case 'L': weather->luminosity = (uint16_t)value; weather->fields |= APRS_WX_LUMINOSITY; break;
+      case 'l': weather->luminosity = (uint16_t)(value + 1000); weather->fields |= APRS_WX_LUMINOSITY; break;
+    }
+  }
+
+  return weather->fields != 0;
+}
+
+bool APRSPacket::getTelemetry(APRSTelemetry* telemetry) {
+  if (type != APRS_TYPE_TELEMETRY) {
+    return false;
+  }
+
+  const char* p = info + bodyOffset;
+  const char* end = info + infoLen;
+
+  memset(telemetry, 0, sizeof(APRSTelemetry));
+
+  // 序号（数字或"MIC"）
+  if (end - p >= 3 && memcmp(p, "MIC", 3) == 0) {
+    p += 3;
+  } else {
+    uint8_t digits = 0;
+    while (p < end && isDigit(*p) && digits < 5) {
+      telemetry->sequence = telemetry->sequence * 10 + (*p++ - '0');
+      digits++;
+    }
+    if (digits == 0) {
+      return false;
+    }
+  }
+
+  // 至多5个模拟量
+  while (telemetry->numAnalog < APRS_TELEMETRY_ANALOG && p < end && *p == ',') {
+    p++;
+    if (!parseFixed(&p, end, &telemetry->analog[telemetry->numAnalog])) {
+      return telemetry->numAnalog > 0;
+    }
+    telemetry->numAnalog++;
+  }
+
+  // 8个数字量
+  if (telemetry->numAnalog == APRS_TELEMETRY_ANALOG && end - p >= 9 && *p == ',') {
+    uint8_t bits = 0;
+    uint8_t i;
+    for (i = 0; i < 8 && (p[1 + i] == '0' || p[1 + i] == '1'); i++) {
+      bits = (uint8_t)((bits << 1) | (p[1 + i] - '0'));
+    }
+    if (i == 8) {
+      telemetry->digital = bits;
+      telemetry->hasDigital = true;
+    }
+  }
+
+  return telemetry->numAnalog > 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * APRS信息字段解码
+ *
+ * 在帧的原始字节上原地解析APRS信息字段，不使用堆、sscanf或strtod：
+ * - parse()只根据数据类型标识确定类型和各部分的位置，不解码字段
+ * - 各get函数只解码调用者需要的字段，文本字段以指向帧内的指针和长度返回
+ * - 所有循环的次数以信息字段长度或固定常数为上限
+ *
+ * 支持的数据类型：
+ * - 位置（无/有时间戳，未压缩和压缩格式，含航向/速度扩展和 /A= 高度）
+ * - Mic-E（纬度和标志位编码在目标地址中）
+ * - 消息、确认（ack）和拒绝（rej）
+ * - 对象和条目
+ * - 天气（无位置的天气报告，或符号为'_'的位置报告）
+ * - 遥测（T#）
+ * - 状态
+ *
+ * 经纬度以整数微度（1e-6度）表示，北纬和东经为正。
+ */
+
+#ifndef APRS_PACKET_H
+#define APRS_PACKET_H
+
+#include "aprs_config.h"
+#include "ax25_parser.h"
+#include <stdint.h>
+
+// 数据类型
+enum APRSPacketType {
+  APRS_TYPE_UNKNOWN,        // 未识别的数据类型
+  APRS_TYPE_POSITION,       // 位置报告（! = / @）
+  APRS_TYPE_MIC_E,          // Mic-E位置报告（` '）
+  APRS_TYPE_MESSAGE,        // 消息、确认或拒绝（:）
+  APRS_TYPE_OBJECT,         // 对象（;）
+  APRS_TYPE_ITEM,           // 条目（)）
+  APRS_TYPE_WEATHER,        // 无位置的天气报告（_）
+  APRS_TYPE_TELEMETRY,      // 遥测（T#）
+  APRS_TYPE_STATUS          // 状态（>）
+};
+
+// 位置
+typedef struct {
+  int32_t latitude;         // 纬度（微度，北纬为正）
+  int32_t longitude;        // 经度（微度，东经为正）
+  char symbolTable;         // 符号表（'/'、'\\'或叠加字符）
+  char symbolCode;          // 符号
+  uint8_t ambiguity;        // 位置模糊度（以空格代替的末尾数字个数，0-4）
+  bool compressed;          // 压缩格式
+  bool hasCourseSpeed;      // 航向和速度有效
+  uint16_t course;          // 航向（度，1-360，0表示未知）
+  uint16_t speed;           // 速度（节）
+} APRSPosition;
+
+// 消息类别
+#define APRS_MESSAGE_TEXT     0       // 普通消息
+#define APRS_MESSAGE_ACK      1       // 确认
+#define APRS_MESSAGE_REJ      2       // 拒绝
+
+// 消息（文本字段指向帧内，不以'\0'结尾）
+typedef struct {
+  const char* addressee;    // 收信人（已去除填充空格）
+  uint8_t addresseeLen;
+  const char* text;         // 消息文本（确认/拒绝时为空）
+  uint16_t textLen;
+  const char* id;           // 消息编号（确认/拒绝时为被确认的编号）
+  uint8_t idLen;            // 0表示无编号
+  uint8_t kind;             // APRS_MESSAGE_TEXT / ACK / REJ
+} APRSMessage;
+
+// 对象或条目
+typedef struct {
+  const char* name;         // 名称（已去除填充空格）
+  uint8_t nameLen;
+  bool alive;               // false表示已删除
+} APRSObject;
+
+// 天气字段掩码
+#define APRS_WX_WIND_DIR      0x0001
+#define APRS_WX_WIND_SPEED    0x0002
+#define APRS_WX_WIND_GUST     0x0004
+#define APRS_WX_TEMPERATURE   0x0008
+#define APRS_WX_RAIN_1H       0x0010
+#define APRS_WX_RAIN_24H      0x0020
+#define APRS_WX_RAIN_MIDNIGHT 0x0040
+#define APRS_WX_HUMIDITY      0x0080
+#define APRS_WX_PRESSURE      0x0100
+#define APRS_WX_LUMINOSITY    0x0200
+
+// 天气（只有fields中对应位被置位的字段有效）
+typedef struct {
+  uint16_t fields;          // 有效字段掩码（APRS_WX_*）
+  uint16_t windDirection;   // 风向（度）
+  uint16_t windSpeed;       // 持续风速（英里/小时）
+  uint16_t windGust;        // 阵风（英里/小时）
+  int16_t temperature;      // 温度（华氏度）
+  uint16_t rain1h;          // 过去1小时降雨（0.01英寸）
+  uint16_t rain24h;         // 过去24小时降雨（0.01英寸）
+  uint16_t rainMidnight;    // 午夜以来降雨（0.01英寸）
+  uint8_t humidity;         // 湿度（%）
+  uint16_t pressure;        // 气压（0.1 hPa）
+  uint16_t luminosity;      // 光照（W/m²）
+} APRSWeather;
+
+// 遥测
+#define APRS_TELEMETRY_ANALOG 5
+
+typedef struct {
+  uint16_t sequence;                      // 序号
+  int32_t analog[APRS_TELEMETRY_ANALOG];  // 模拟量（千分之一单位）
+  uint8_t numAnalog;                      // 有效的模拟量个数
+  uint8_t digital;                        // 8个数字量，bit7为第一个
+  bool hasDigital;
+} APRSTelemetry;
+
+class APRSPacket {
+public:
+  APRSPacket();
+
+  /**
+   * 绑定帧并识别数据类型（不解码字段）
+   * 解码结果中的指针指向帧内，在帧有效期间有效
+   * @param frame 有效的AX.25帧
+   * @return 识别出数据类型时返回true
+   */
+  bool parse(const APRS_AX25Frame* frame);
+
+  /**
+   * 获取数据类型
+   */
+  APRSPacketType getType();
+
+  /**
+   * 解码位置（位置报告、Mic-E、对象和条目）
+   * @param position 输出
+   * @return 成功返回true
+   */
+  bool getPosition(APRSPosition* position);
+
+  /**
+   * 解码高度（注释中的 /A=、压缩格式高度或Mic-E高度）
+   * @param feet 输出：高度（英尺）
+   * @return 有高度信息时返回true
+   */
+  bool getAltitude(int32_t* feet);
+
+  /**
+   * 获取注释（位置之后的文本）或状态文本
+   * @param text 输出：指向帧内的文本
+   * @param len 输出：文本长度
+   * @return 成功返回true（注释可能为空）
+   */
+  bool getComment(const char** text, uint16_t* len);
+
+  /**
+   * 解码对象或条目的名称和状态
+   */
+  bool getObject(APRSObject* object);
+
+  /**
+   * 解码消息
+   */
+  bool getMessage(APRSMessage* message);
+
+  /**
+   * 解码天气数据
+   */
+  bool getWeather(APRSWeather* weather);
+
+  /**
+   * 解码遥测数据
+   */
+  bool getTelemetry(APRSTelemetry* telemetry);
+
+protected:
+  const APRS_AX25Frame* frame;
+  const char* info;             // 信息字段
+  uint16_t infoLen;
+  APRSPacketType type;
+  uint16_t bodyOffset;          // 位置（或天气、遥测数据）在信息字段中的起始位置
+  uint8_t nameLen;              // 对象/条目名称长度（含填充）
+
+  /**
+   * 位置字段（含数据扩展）之后的位置
+   * @return 信息字段中的偏移，位置无效时返回0
+   */
+  uint16_t getPositionEnd();
+
+  /**
+   * 解码未压缩位置
+   */
+  bool decodeUncompressed(const char* p, APRSPosition* position);
+
+  /**
+   * 解码压缩位置
+   */
+  bool decodeCompressed(const char* p, APRSPosition* position);
+
+  /**
+   * 解码Mic-E位置
+   */
+  bool decodeMicE(APRSPosition* position);
+};
+
+#endif // APRS_PACKET_H
@@ -0,0 +1,130 @@
+/**
+ * 平台适配层实现（仅主机环境）
+ */
+
+#include "aprs_platform.h"
+
+#if APRS_PLATFORM_HOST
+
+#include <stdio.h>
+#include <time.h>
+
+HostDebugPort HostDebug;
+
+void HostDebugPort::print(const char* str)       { fputs(str, stderr); }
+void HostDebugPort::print(char c)                { fputc(c, stderr); }
+void HostDebugPort::print(int value)             { fprintf(stderr, "%d", value); }
+void HostDebugPort::print(unsigned int value)    { fprintf(stderr, "%u", value); }
+void HostDebugPort::print(long value)            { fprintf(stderr, "%ld", value); }
+void HostDebugPort::print(unsigned long value)   { fprintf(stderr, "%lu", value); }
+void HostDebugPort::print(double value)          { fprintf(stderr, "%.2f", value); }
+
+void HostDebugPort::println()                    { fputc('\n', stderr); }
+void HostDebugPort::println(const char* str)     { print(str); println(); }
+void HostDebugPort::println(char c)              { print(c); println(); }
+void HostDebugPort::println(int value)           { print(value); println(); }
+void HostDebugPort::println(unsigned int value)  { print(value); println(); }
+void HostDebugPort::println(long value)          { print(value); println(); }
+void HostDebugPort::println(unsigned long value) { print(value); println(); }
+void HostDebugPort::println(double value)        { print(value); println(); }
+
+HardwareSerial::HardwareSerial() {
+  txHead = 0;
+  txCount = 0;
+  bytesPerPoll = 0;
+  sent = nullptr;
+  sentLength = 0;
+  sentCapacity = 0;
+}
+
+HardwareSerial::~HardwareSerial() {
+  free(sent);
+}
+
+void HardwareSerial::begin(unsigned long baudrate) {
+  (void)baudrate;
+  txHead = 0;
+  txCount = 0;
+}
+
+size_t HardwareSerial::write(const uint8_t* data, size_t length) {
+  // 与STM32duino不同，缓冲区满时不等待，只写入空闲部分
+  size_t room = SERIAL_TX_BUFFER_SIZE - 1 - txCount;
+  if (length > room) {
+    length = room;
+  }
+  for (size_t i = 0; i < length; i++) {
+    txBuffer[(txHead + txCount + i) % SERIAL_TX_BUFFER_SIZE] = data[i];
+  }
+  txCount += length;
+  return length;
+}
+
+int HardwareSerial::availableForWrite() {
+  if (bytesPerPoll > 0) {
+    transmit(bytesPerPoll);
+  }
+  return (int)(SERIAL_TX_BUFFER_SIZE - 1 - txCount);
+}
+
+void HardwareSerial::flush() {
+  transmit(txCount);
+}
+
+size_t HardwareSerial::transmit(size_t count) {
+  if (count > txCount) {
+    count = txCount;
+  }
+  if (sentLength + count > sentCapacity) {
+    size_t capacity = (sentCapacity == 0) ? 256 : sentCapacity;
+    while (capacity < sentLength + count) {
+      capacity *= 2;
+    }
+    uint8_t* grown = (uint8_t*)realloc(sent, capacity);
+    if (grown == nullptr) {
+      return 0;
+    }
+    sent = grown;
+    sentCapacity = capacity;
+  }
+  for (size_t i = 0; i < count; i++) {
+    sent[sentLength++] = txBuffer[txHead];
+    txHead = (txHead + 1) % SERIAL_TX_BUFFER_SIZE;
+  }
+  txCount -= count;
+  return count;
+}
+
+void HardwareSerial::setBytesPerPoll(size_t count) {
+  bytesPerPoll = count;
+}
+
+const uint8_t* HardwareSerial::getSent() const {
+  return sent;
+}
+
+size_t HardwareSerial::getSentLength() const {
+  return sentLength;
+}
+
+void HardwareSerial::clearSent() {
+  sentLength = 0;
+}
+
+static uint64_t monotonicMicros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
+}
+
+static const uint64_t startMicros = monotonicMicros();
+
+uint32_t millis() {
+  return (uint32_t)((monotonicMicros() - startMicros) / 1000ULL);
+}
+
+uint32_t micros() {
+  return (uint32_t)(monotonicMicros() - startMicros);
+}
+
+#endif // APRS_PLATFORM_HOST
@@ -0,0 +1,123 @@
+/**
+ * 平台适配层
+ *
+ * 在STM32duino环境下直接使用Arduino核心；
+ * 在主机（Linux等）环境下提供最小化的替代实现，
+ * 使解码核心（AFSK解调、NRZI解码、AX.25解析）可以脱离硬件编译、
+ * 测试和性能分析。
+ */
+
+#ifndef APRS_PLATFORM_H
+#define APRS_PLATFORM_H
+
+#if defined(ARDUINO)
+
+  #include <Arduino.h>
+
+  #define APRS_PLATFORM_ARDUINO   1
+  #define APRS_PLATFORM_HOST      0
+
+#else
+
+  #include <stdint.h>
+  #include <stddef.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  #define APRS_PLATFORM_ARDUINO   0
+  #define APRS_PLATFORM_HOST      1
+
+  /**
+   * 主机端调试输出
+   * 提供与Arduino Print类兼容的print/println接口，输出到stderr
+   */
+  class HostDebugPort {
+  public:
+    void print(const char* str);
+    void print(char c);
+    void print(int value);
+    void print(unsigned int value);
+    void print(long value);
+    void print(unsigned long value);
+    void print(double value);
+
+    void println();
+    void println(const char* str);
+    void println(char c);
+    void println(int value);
+    void println(unsigned int value);
+    void println(long value);
+    void println(unsigned long value);
+    void println(double value);
+  };
+
+  extern HostDebugPort HostDebug;
+
+  // 与STM32duino相同的UART发送缓冲区大小
+  #ifndef SERIAL_TX_BUFFER_SIZE
+    #define SERIAL_TX_BUFFER_SIZE   64
+  #endif
+
+  /**
+   * 主机端串口替身
+   * 模拟STM32duino HardwareSerial的中断驱动发送缓冲区（SERIAL_TX_BUFFER_SIZE字节，
+   * 最多容纳SERIAL_TX_BUFFER_SIZE - 1字节）：write()只写入空闲部分，
+   * transmit()模拟硬件发出字节，发出的字节按顺序保存，供测试检查。
+   * setBytesPerPoll(n)后每次调用availableForWrite()先发出n个字节，
+   * 模拟在轮询期间发送中断持续工作（flush()等忙等待的代码需要）。
+   */
+  class HardwareSerial {
+  public:
+    HardwareSerial();
+    ~HardwareSerial();
+
+    void begin(unsigned long baudrate);
+    size_t write(const uint8_t* data, size_t length);
+    int availableForWrite();
+
+    /**
+     * 等待发送完成：发出缓冲区中的全部字节
+     */
+    void flush();
+
+    /**
+     * 模拟硬件发出最多count个字节
+     * @return 实际发出的字节数
+     */
+    size_t transmit(size_t count);
+
+    void setBytesPerPoll(size_t count);
+
+    /**
+     * 已发出的字节（按发送顺序）
+     */
+    const uint8_t* getSent() const;
+    size_t getSentLength() const;
+    void clearSent();
+
+  protected:
+    uint8_t txBuffer[SERIAL_TX_BUFFER_SIZE];
+    size_t txHead;
+    size_t txCount;
+    size_t bytesPerPoll;
+    uint8_t* sent;
+    size_t sentLength;
+    size_t sentCapacity;
+  };
+
+  // 定时器只在固件中使用，主机上只需要类型名
+  class HardwareTimer;
+
+  /**
+   * 自程序启动以来的毫秒数（单调时钟）
+   */
+  uint32_t millis();
+
+  /**
+   * 自程序启动以来的微秒数（单调时钟）
+   */
+  uint32_t micros();
+
+#endif
+
+#endif // APRS_PLATFORM_H
@@ -0,0 +1,154 @@
+/**
+ * 解码热路径性能计数实现
+ */
+
+#include "aprs_profile.h"
+
+#if APRS_PROFILE
+
+#include <string.h>
+
+#if APRS_PLATFORM_HOST
+  #include <time.h>
+  #include <mutex>
+  #include <vector>
+  #include <algorithm>
+#endif
+
+#if APRS_PLATFORM_HOST
+thread_local ProfileCounter aprsProfileCounters[PROFILE_STAGE_COUNT];
+thread_local bool aprsProfileThreadRegistered = false;
+
+// 已登记线程的计数、已退出线程的合计，由profileMutex保护
+static std::mutex profileMutex;
+static std::vector<ProfileCounter*> profileThreads;
+static ProfileCounter profileRetired[PROFILE_STAGE_COUNT];
+#else
+ProfileCounter aprsProfileCounters[PROFILE_STAGE_COUNT];
+#endif
+
+static const char* const stageNames[PROFILE_STAGE_COUNT] = {
+  "ISR",
+  "demod",
+  "deframe",
+  "parse",
+  "endFrame",
+  "repair"
+};
+
+#if APRS_PLATFORM_HOST
+/**
+ * 将一组计数累加到另一组
+ */
+static void mergeCounters(ProfileCounter* dst, const ProfileCounter* src) {
+  for (uint8_t stage = 0; stage < PROFILE_STAGE_COUNT; stage++) {
+    dst[stage].calls += src[stage].calls;
+    dst[stage].totalCycles += src[stage].totalCycles;
+    dst[stage].totalItems += src[stage].totalItems;
+    if (src[stage].maxCycles > dst[stage].maxCycles) {
+      dst[stage].maxCycles = src[stage].maxCycles;
+    }
+    for (uint8_t bin = 0; bin < PROFILE_HIST_BINS; bin++) {
+      dst[stage].histogram[bin] += src[stage].histogram[bin];
+    }
+  }
+}
+
+// 线程退出时将计数并入合计并注销
+struct ProfileThreadExit {
+  ~ProfileThreadExit() {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    mergeCounters(profileRetired, aprsProfileCounters);
+    profileThreads.erase(std::remove(profileThreads.begin(), profileThreads.end(),
+                                     aprsProfileCounters), profileThreads.end());
+  }
+};
+
+void aprsProfileRegisterThread() {
+  static thread_local ProfileThreadExit threadExit;
+  (void)threadExit;
+  std::lock_guard<std::mutex> lock(profileMutex);
+  profileThreads.push_back(aprsProfileCounters);
+  aprsProfileThreadRegistered = true;
+}
+
+ProfileTime aprsProfileNow() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (ProfileTime)ts.tv_sec * 1000000000ULL + (ProfileTime)ts.tv_nsec;
+}
+#endif
+
+void aprsProfileBegin() {
+#if APRS_PLATFORM_ARDUINO && defined(DWT_CTRL_CYCCNTENA_Msk)
+  // 启用跟踪模块和DWT周期计数器
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  aprsProfileReset();
+}
+
+void aprsProfileReset() {
+#if APRS_PLATFORM_HOST
+  std::lock_guard<std::mutex> lock(profileMutex);
+  memset(profileRetired, 0, sizeof(profileRetired));
+  for (ProfileCounter* counters : profileThreads) {
+    memset(counters, 0, sizeof(ProfileCounter) * PROFILE_STAGE_COUNT);
+  }
+#endif
+  memset(aprsProfileCounters, 0, sizeof(aprsProfileCounters));
+}
+
+/**
+ * 由直方图估计百分位数：返回累计数达到目标的格的上界
+ */
+static uint32_t histogramPercentile(const ProfileCounter* c, uint32_t permille) {
+  uint64_t target = ((uint64_t)c->calls * permille + 999) / 1000;
+  uint64_t sum = 0;
+
+  for (uint8_t bin = 0; bin < PROFILE_HIST_BINS; bin++) {
+    sum += c->histogram[bin];
+    if (sum >= target) {
+      uint32_t upper = (bin + 1 < 32) ? ((1u << (bin + 1)) - 1) : UINT32_MAX;
+      return (upper < c->maxCycles) ? upper : c->maxCycles;
+    }
+  }
+  return c->maxCycles;
+}
+
+void aprsProfileGetSummary(uint8_t stage, ProfileSummary* summary) {
+#if APRS_PLATFORM_HOST
+  ProfileCounter merged[PROFILE_STAGE_COUNT];
+  {
+    std::lock_guard<std::mutex> lock(profileMutex);
+    memcpy(merged, profileRetired, sizeof(merged));
+    for (const ProfileCounter* counters : profileThreads) {
+      mergeCounters(merged, counters);
+    }
+  }
+  const ProfileCounter* c = &merged[stage];
+#else
+  const ProfileCounter* c = &aprsProfileCounters[stage];
+#endif
+
+  memset(summary, 0, sizeof(ProfileSummary));
+  if (c->calls == 0) {
+    return;
+  }
+
+  summary->calls = c->calls;
+  summary->avgCycles = (uint32_t)(c->totalCycles / c->calls);
+  if (c->totalItems > 0) {
+    summary->cyclesPerItemX100 = (uint32_t)(c->totalCycles * 100 / c->totalItems);
+  }
+  summary->p50Cycles = histogramPercentile(c, 500);
+  summary->p99Cycles = histogramPercentile(c, 990);
+  summary->maxCycles = c->maxCycles;
+}
+
+const char* aprsProfileStageName(uint8_t stage) {
+  return (stage < PROFILE_STAGE_COUNT) ? stageNames[stage] : "?";
+}
+
+#endif // APRS_PROFILE
@@ -0,0 +1,168 @@
+/**
+ * 解码热路径性能计数
+ *
+ * 记录各处理阶段每次调用的耗时（周期数）：
+ * - Cortex-M：DWT周期计数器（CYCCNT），单位为CPU周期
+ * - 主机：单调时钟，单位为纳秒
+ *
+ * 每个阶段统计调用次数、总耗时、处理的数据量（采样/比特/字节）、单次最大耗时，
+ * 以及单次耗时的对数直方图（第k格为 [2^k, 2^(k+1)) ），由直方图估计百分位数。
+ * 记录一次只需几条指令（一次CLZ和几次加法），可在采样中断中使用。
+ *
+ * 主机上计数按线程分开（thread_local），多通道解码引擎的工作线程各自记录，互不竞争；
+ * 线程退出时其计数并入全局合计，aprsProfileGetSummary返回合计与仍在运行的线程之和，
+ * 应在工作线程停止后（或在唯一的解码线程中）读取。
+ *
+ * APRS_PROFILE为0时所有PROFILE_*宏为空，不产生任何代码和数据。
+ */
+
+#ifndef APRS_PROFILE_H
+#define APRS_PROFILE_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+
+// 处理阶段
+enum ProfileStage {
+  PROFILE_STAGE_ISR,          // 采样中断（每采样一次）
+  PROFILE_STAGE_DEMOD,        // AFSK解调（数据量：采样数）
+  PROFILE_STAGE_DEFRAME,      // HDLC解帧（数据量：比特数）
+  PROFILE_STAGE_PARSE,        // 状态机和AX.25字节接收，含帧结束处理（数据量：解帧事件数）
+  PROFILE_STAGE_END_FRAME,    // 帧结束CRC校验和字段定位（数据量：帧字节数）
+  PROFILE_STAGE_REPAIR,       // 比特修复（数据量：帧字节数）
+  PROFILE_STAGE_COUNT
+};
+
+// 直方图格数（单次耗时 < 2^PROFILE_HIST_BINS）
+#define PROFILE_HIST_BINS   24
+
+// 单个阶段的计数
+typedef struct {
+  uint32_t calls;                         // 调用次数
+  uint64_t totalCycles;                   // 总耗时
+  uint64_t totalItems;                    // 处理的数据量
+  uint32_t maxCycles;                     // 单次最大耗时
+  uint32_t histogram[PROFILE_HIST_BINS];  // 单次耗时的对数直方图
+} ProfileCounter;
+
+// 阶段摘要（由aprsProfileGetSummary计算）
+typedef struct {
+  uint32_t calls;
+  uint32_t cyclesPerItemX100;             // 每个数据单位的平均耗时 × 100
+  uint32_t avgCycles;                     // 单次平均耗时
+  uint32_t p50Cycles;                     // 单次耗时的中位数（所在直方图格的上界）
+  uint32_t p99Cycles;                     // 单次耗时的99百分位数（所在直方图格的上界）
+  uint32_t maxCycles;                     // 单次最大耗时
+} ProfileSummary;
+
+#if APRS_PROFILE
+
+#if APRS_PLATFORM_ARDUINO && defined(DWT_CTRL_CYCCNTENA_Msk)
+  #define PROFILE_UNIT          "cycles"
+  #define PROFILE_TICKS_PER_SEC SystemCoreClock
+
+  typedef uint32_t ProfileTime;
+
+  static inline ProfileTime aprsProfileNow() {
+    return DWT->CYCCNT;
+  }
+#elif APRS_PLATFORM_ARDUINO
+  // 无DWT的内核（Cortex-M0/M0+）：退回微秒计时
+  #define PROFILE_UNIT          "us"
+  #define PROFILE_TICKS_PER_SEC 1000000UL
+
+  typedef uint32_t ProfileTime;
+
+  static inline ProfileTime aprsProfileNow() {
+    return micros();
+  }
+#else
+  #define PROFILE_UNIT          "ns"
+  #define PROFILE_TICKS_PER_SEC 1000000000UL
+
+  // 纳秒计时32位约4.3秒回绕，时间戳使用64位，只将耗时收窄为32位
+  typedef uint64_t ProfileTime;
+
+  ProfileTime aprsProfileNow();
+#endif
+
+/**
+ * 从start到现在的耗时（先相减再收窄，超过32位范围时饱和）
+ */
+static inline uint32_t aprsProfileElapsed(ProfileTime start) {
+  ProfileTime elapsed = aprsProfileNow() - start;
+  return (elapsed > (ProfileTime)UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+}
+
+#if APRS_PLATFORM_HOST
+extern thread_local ProfileCounter aprsProfileCounters[PROFILE_STAGE_COUNT];
+extern thread_local bool aprsProfileThreadRegistered;
+
+/**
+ * 登记当前线程的计数（线程第一次记录时调用）
+ */
+void aprsProfileRegisterThread();
+#else
+extern ProfileCounter aprsProfileCounters[PROFILE_STAGE_COUNT];
+#endif
+
+/**
+ * 记录一次调用
+ * @param stage 阶段
+ * @param cycles 耗时
+ * @param items 处理的数据量
+ */
+static inline void aprsProfileRecord(uint8_t stage, uint32_t cycles, uint32_t items) {
+#if APRS_PLATFORM_HOST
+  if (!aprsProfileThreadRegistered) {
+    aprsProfileRegisterThread();
+  }
+#endif
+  ProfileCounter* c = &aprsProfileCounters[stage];
+  uint8_t bin = (cycles == 0) ? 0 : (uint8_t)(31 - __builtin_clz(cycles));
+  if (bin >= PROFILE_HIST_BINS) {
+    bin = PROFILE_HIST_BINS - 1;
+  }
+  c->calls++;
+  c->totalCycles += cycles;
+  c->totalItems += items;
+  if (cycles > c->maxCycles) {
+    c->maxCycles = cycles;
+  }
+  c->histogram[bin]++;
+}
+
+/**
+ * 初始化计时器（Cortex-M上启用DWT周期计数器）并清空计数
+ */
+void aprsProfileBegin();
+
+/**
+ * 清空所有计数（主机上包括已退出线程的合计和所有已登记线程的计数）
+ */
+void aprsProfileReset();
+
+/**
+ * 计算阶段摘要（主机上合并所有线程的计数）
+ */
+void aprsProfileGetSummary(uint8_t stage, ProfileSummary* summary);
+
+/**
+ * 阶段名称
+ */
+const char* aprsProfileStageName(uint8_t stage);
+
+// 采样中断的耗时预算（计时单位）
+#define PROFILE_ISR_BUDGET    ((uint32_t)(PROFILE_TICKS_PER_SEC / AFSK_SAMPLE_RATE))
+
+#define PROFILE_BEGIN(var)                ProfileTime var = aprsProfileNow()
+#define PROFILE_END(stage, var, items)    aprsProfileRecord((stage), aprsProfileElapsed(var), (items))
+
+#else
+
+#define PROFILE_BEGIN(var)
+#define PROFILE_END(stage, var, items)
+
+#endif // APRS_PROFILE
+
+#endif // APRS_PROFILE_H
@@ -0,0 +1,373 @@
+/**
+ * 多通道并发解码引擎实现（仅主机环境）
+ */
+
+#include "aprs_stream_engine.h"
+
+#if APRS_PLATFORM_HOST
+
+#include <string.h>
+
+APRSStreamEngine::APRSStreamEngine() {
+  numChannels = 0;
+  numWorkers = 0;
+  stopping.store(false);
+  running = false;
+}
+
+APRSStreamEngine::~APRSStreamEngine() {
+  stop();
+  for (Channel* ch : channels) {
+    delete ch;
+  }
+  for (Worker* w : workers) {
+    delete w;
+  }
+}
+
+bool APRSStreamEngine::begin(uint16_t channelCount, uint16_t workerCount) {
+  if (running || channelCount == 0) {
+    return false;
+  }
+
+  for (Channel* ch : channels) {
+    delete ch;
+  }
+  for (Worker* w : workers) {
+    delete w;
+  }
+  channels.clear();
+  workers.clear();
+
+  if (workerCount == 0) {
+    workerCount = (uint16_t)std::thread::hardware_concurrency();
+    if (workerCount == 0) {
+      workerCount = 1;
+    }
+  }
+  if (workerCount > channelCount) {
+    workerCount = channelCount;
+  }
+  numChannels = channelCount;
+  numWorkers = workerCount;
+
+  for (uint16_t i = 0; i < numChannels; i++) {
+    Channel* ch = new Channel();
+    if (!ch->decoder.begin()) {
+      delete ch;
+      return false;
+    }
+    ch->head.store(0, std::memory_order_relaxed);
+    ch->tail.store(0, std::memory_order_relaxed);
+    ch->closed.store(false, std::memory_order_relaxed);
+    ch->fill = 0;
+    ch->packer.word = 0;
+    ch->packer.count = 0;
+    ch->finished = false;
+    ch->position = 0;
+    ch->done = false;
+    memset(&ch->stats, 0, sizeof(ch->stats));
+    channels.push_back(ch);
+  }
+  for (uint16_t i = 0; i < numWorkers; i++) {
+    workers.push_back(new Worker());
+  }
+
+  return true;
+}
+
+APRSDecoder* APRSStreamEngine::getDecoder(uint16_t channel) {
+  return (channel < numChannels) ? &channels[channel]->decoder : nullptr;
+}
+
+void APRSStreamEngine::start() {
+  if (running || numChannels == 0) {
+    return;
+  }
+
+  stopping.store(false);
+  running = true;
+  for (uint16_t i = 0; i < numWorkers; i++) {
+    workers[i]->thread = std::thread(&APRSStreamEngine::workerLoop, this, i);
+  }
+}
+
+void APRSStreamEngine::stop() {
+  if (!running) {
+    return;
+  }
+
+  stopping.store(true);
+  for (Worker* w : workers) {
+    {
+      std::lock_guard<std::mutex> guard(w->lock);
+    }
+    w->wake.notify_all();
+  }
+  {
+    std::lock_guard<std::mutex> guard(outputLock);
+  }
+  progress.notify_all();
+
+  for (Worker* w : workers) {
+    w->thread.join();
+  }
+  running = false;
+}
+
+bool APRSStreamEngine::waitForSpace(Channel* ch, bool wait) {
+  uint32_t h = ch->head.load(std::memory_order_relaxed);
+  if (h - ch->tail.load(std::memory_order_acquire) < STREAM_QUEUE_BLOCKS) {
+    return true;
+  }
+  if (!wait) {
+    return false;
+  }
+
+  ch->stats.producerWaits++;
+  std::unique_lock<std::mutex> guard(outputLock);
+  progress.wait(guard, [&]() {
+    return stopping.load() || h - ch->tail.load(std::memory_order_acquire) < STREAM_QUEUE_BLOCKS;
+  });
+  return !stopping.load();
+}
+
+void APRSStreamEngine::publish(uint16_t channel) {
+  Channel* ch = channels[channel];
+  uint32_t h = ch->head.load(std::memory_order_relaxed);
+
+  ch->blockWords[h & (STREAM_QUEUE_BLOCKS - 1)] = ch->fill;
+  ch->head.store(h + 1, std::memory_order_release);
+  ch->stats.samplesQueued += (uint64_t)ch->fill * PACKED_SAMPLES_PER_WORD;
+  ch->fill = 0;
+  notifyWorker(channel);
+}
+
+void APRSStreamEngine::notifyWorker(uint16_t channel) {
+  Worker* w = workers[channel % numWorkers];
+  {
+    // 加锁后再通知：工作线程在锁内检查条件，不会错过唤醒
+    std::lock_guard<std::mutex> guard(w->lock);
+  }
+  w->wake.notify_one();
+}
+
+bool APRSStreamEngine::feed(uint16_t channel, const uint32_t* words, size_t count, bool wait) {
+  if (channel >= numChannels) {
+    return false;
+  }
+  Channel* ch = channels[channel];
+
+  while (count > 0) {
+    // 开始新的数据块前确认队列有空位
+    if (ch->fill == 0 && !waitForSpace(ch, wait)) {
+      ch->stats.samplesDropped += (uint64_t)count * PACKED_SAMPLES_PER_WORD;
+      return false;
+    }
+
+    uint32_t* block = ch->blocks[ch->head.load(std::memory_order_relaxed) & (STREAM_QUEUE_BLOCKS - 1)];
+    size_t n = STREAM_BLOCK_WORDS - ch->fill;
+    if (n > count) {
+      n = count;
+    }
+    memcpy(&block[ch->fill], words, n * sizeof(uint32_t));
+    ch->fill = (uint16_t)(ch->fill + n);
+    words += n;
+    count -= n;
+
+    if (ch->fill == STREAM_BLOCK_WORDS) {
+      publish(channel);
+    }
+  }
+
+  return true;
+}
+
+bool APRSStreamEngine::feedSamples(uint16_t channel, const uint8_t* samples, size_t count, bool wait) {
+  if (channel >= numChannels) {
+    return false;
+  }
+  Channel* ch = channels[channel];
+  uint32_t words[64];
+  uint16_t numWords = 0;
+  bool ok = true;
+
+  for (size_t i = 0; i < count; i++) {
+    if (packSample(&ch->packer, samples[i] ? 1 : 0)) {
+      words[numWords++] = ch->packer.word;
+      if (numWords == sizeof(words) / sizeof(words[0])) {
+        ok = feed(channel, words, numWords, wait) && ok;
+        numWords = 0;
+      }
+    }
+  }
+  if (numWords > 0) {
+    ok = feed(channel, words, numWords, wait) && ok;
+  }
+
+  return ok;
+}
+
+void APRSStreamEngine::flush(uint16_t channel) {
+  if (channel < numChannels && channels[channel]->fill > 0) {
+    publish(channel);
+  }
+}
+
+void APRSStreamEngine::close(uint16_t channel) {
+  if (channel >= numChannels) {
+    return;
+  }
+
+  // 先发布最后的数据块，再设置关闭标志（工作线程看到关闭时一定能看到全部数据）
+  flush(channel);
+  channels[channel]->closed.store(true, std::memory_order_release);
+  notifyWorker(channel);
+}
+
+bool APRSStreamEngine::hasWork(uint16_t channel) {
+  Channel* ch = channels[channel];
+  if (ch->head.load(std::memory_order_acquire) != ch->tail.load(std::memory_order_relaxed)) {
+    return true;
+  }
+  return ch->closed.load(std::memory_order_acquire) && !ch->finished;
+}
+
+bool APRSStreamEngine::processChannel(uint16_t channel) {
+  Channel* ch = channels[channel];
+  bool closed = ch->closed.load(std::memory_order_acquire);
+  uint32_t t = ch->tail.load(std::memory_order_relaxed);
+  bool worked = false;
+  std::vector<StreamFrame> completed;
+
+  while (t != ch->head.load(std::memory_order_acquire) && !stopping.load(std::memory_order_relaxed)) {
+    const uint32_t* words = ch->blocks[t & (STREAM_QUEUE_BLOCKS - 1)];
+    uint16_t n = ch->blockWords[t & (STREAM_QUEUE_BLOCKS - 1)];
+
+    // 分段解码，每段之后取出完成的帧（解码器输出队列只有FRAME_QUEUE_DEPTH帧）
+    for (uint16_t offset = 0; offset < n; offset += STREAM_SEGMENT_WORDS) {
+      uint16_t m = (n - offset < STREAM_SEGMENT_WORDS) ? (uint16_t)(n - offset) : STREAM_SEGMENT_WORDS;
+      ch->decoder.processPackedSamples(words + offset, m);
+      ch->stats.samplesDecoded += (uint64_t)m * PACKED_SAMPLES_PER_WORD;
+
+      while (ch->decoder.available()) {
+        APRS_AX25Frame* frame = ch->decoder.getFrame();
+        if (frame != nullptr && frame->valid) {
+          completed.emplace_back();
+          StreamFrame* out = &completed.back();
+          out->channel = channel;
+          out->sample = ch->stats.samplesDecoded;
+          memcpy(&out->frame, frame, sizeof(APRS_AX25Frame));
+          ch->stats.frames++;
+        }
+      }
+    }
+
+    // 先释放数据块，再公布进度（等待空位的生产者和合并输出共用progress）
+    ch->tail.store(++t, std::memory_order_release);
+    {
+      std::lock_guard<std::mutex> guard(outputLock);
+      ch->position = ch->stats.samplesDecoded;
+      for (const StreamFrame& f : completed) {
+        ch->frames.push_back(f);
+      }
+    }
+    progress.notify_all();
+    completed.clear();
+    worked = true;
+  }
+
+  // 关闭标志在读取head之前获取，此时队列为空说明全部数据已处理
+  if (closed && !ch->finished && t == ch->head.load(std::memory_order_acquire)) {
+    ch->finished = true;
+    {
+      std::lock_guard<std::mutex> guard(outputLock);
+      ch->done = true;
+    }
+    progress.notify_all();
+    worked = true;
+  }
+
+  return worked;
+}
+
+void APRSStreamEngine::workerLoop(uint16_t index) {
+  Worker* w = workers[index];
+
+  while (!stopping.load()) {
+    bool worked = false;
+    for (uint16_t ch = index; ch < numChannels; ch += numWorkers) {
+      worked = processChannel(ch) || worked;
+    }
+
+    if (!worked) {
+      std::unique_lock<std::mutex> guard(w->lock);
+      w->wake.wait(guard, [&]() {
+        if (stopping.load()) {
+          return true;
+        }
+        for (uint16_t ch = index; ch < numChannels; ch += numWorkers) {
+          if (hasWork(ch)) {
+            return true;
+          }
+        }
+        return false;
+      });
+    }
+  }
+}
+
+bool APRSStreamEngine::getFrame(StreamFrame* frame, bool wait) {
+  std::unique_lock<std::mutex> guard(outputLock);
+
+  for (;;) {
+    // 所有通道队首帧中（采样位置，通道号）最小的一帧
+    Channel* best = nullptr;
+    bool allDone = true;
+    for (Channel* ch : channels) {
+      if (!ch->frames.empty() &&
+          (best == nullptr || ch->frames.front().sample < best->frames.front().sample)) {
+        best = ch;
+      }
+      allDone = allDone && ch->done && ch->frames.empty();
+    }
+
+    if (best != nullptr) {
+      // 其他通道都已处理到该位置之后，才不会再出现更早的帧
+      uint64_t sample = best->frames.front().sample;
+      bool ready = true;
+      for (Channel* ch : channels) {
+        if (ch != best && !ch->done && ch->position < sample) {
+          ready = false;
+          break;
+        }
+      }
+      if (ready) {
+        *frame = best->frames.front();
+        best->frames.pop_front();
+        return true;
+      }
+    } else if (allDone) {
+      return false;
+    }
+
+    if (!wait || stopping.load()) {
+      return false;
+    }
+    progress.wait(guard);
+  }
+}
+
+StreamStatistics* APRSStreamEngine::getStatistics(uint16_t channel) {
+  return (channel < numChannels) ? &channels[channel]->stats : nullptr;
+}
+
+uint16_t APRSStreamEngine::getNumChannels() {
+  return numChannels;
+}
+
+uint16_t APRSStreamEngine::getNumWorkers() {
+  return numWorkers;
+}
+
+#endif // APRS_PLATFORM_HOST
@@ -0,0 +1,236 @@
+/**
+ * 多通道并发解码引擎（仅主机环境）
+ *
+ * 在固定数量的工作线程上运行多个相互独立的APRSDecoder实例，
+ * 用于同时解码多个通道（例如SDR信道化后的多路1比特采样）：
+ *
+ * - 每个通道有自己的解码器和有界输入队列（STREAM_QUEUE_BLOCKS个数据块的单生产者/
+ *   单消费者环形队列），队列满时生产者等待（或选择丢弃并计数）
+ * - 通道固定分配给一个工作线程（通道号 % 线程数），解码器状态只被该线程访问，
+ *   线程之间不共享任何解码状态，吞吐量随核数近似线性增长
+ * - 解码出的帧带有通道号和采样位置（帧完成时所在数据段末尾的通道内采样序号），
+ *   由getFrame()按（采样位置，通道号）顺序合并为一路输出。输出顺序与线程调度无关：
+ *   只有当其他所有通道都已处理到该采样位置之后，帧才会被输出
+ *
+ * 解码核心没有可变的全局状态（HDLC转移表在静态初始化阶段生成，之后只读）。
+ * APRS_PROFILE的性能计数按线程记录，工作线程退出时并入合计，stop()之后读取。
+ *
+ * 典型用法：
+ *   engine.begin(channels, workers);
+ *   engine.getDecoder(ch)->setDemodulator(...);   // 可选，start()之前
+ *   engine.start();
+ *   engine.feed(ch, words, count);                 // 生产者线程，按通道轮流送入
+ *   while (engine.getFrame(&out, false)) { ... }   // 随时取出已合并的帧
+ *   engine.close(ch);                              // 输入结束
+ *   while (engine.getFrame(&out, true)) { ... }    // 取出剩余的帧
+ *   engine.stop();
+ */
+
+#ifndef APRS_STREAM_ENGINE_H
+#define APRS_STREAM_ENGINE_H
+
+#include "aprs_config.h"
+
+#if APRS_PLATFORM_HOST
+
+#include "aprs_decoder.h"
+#include "afsk_packed.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 输入数据块大小（字，每字32个采样）：1024字 = 32768个采样，26.4kHz下约1.24秒
+#ifndef STREAM_BLOCK_WORDS
+  #define STREAM_BLOCK_WORDS    1024
+#endif
+
+// 每个通道输入队列的数据块数，必须为2的幂
+#ifndef STREAM_QUEUE_BLOCKS
+  #define STREAM_QUEUE_BLOCKS   8
+#endif
+
+// 工作线程每次送入解码器的字数（之后取出已完成的帧，决定采样位置的粒度）
+#ifndef STREAM_SEGMENT_WORDS
+  #define STREAM_SEGMENT_WORDS  64
+#endif
+
+#if (STREAM_QUEUE_BLOCKS & (STREAM_QUEUE_BLOCKS - 1)) != 0
+  #error "STREAM_QUEUE_BLOCKS必须为2的幂"
+#endif
+
+// 合并输出的帧
+typedef struct {
+  uint16_t channel;         // 通道号
+  uint64_t sample;          // 帧完成时所在数据段末尾的通道内采样序号
+  APRS_AX25Frame frame;
+} StreamFrame;
+
+// 通道统计
+typedef struct {
+  uint64_t samplesQueued;   // 送入队列的采样数
+  uint64_t samplesDecoded;  // 已解码的采样数
+  uint32_t frames;          // 解码帧数
+  uint64_t samplesDropped;  // 非等待模式下队列满而丢弃的采样数
+  uint32_t producerWaits;   // 队列满时生产者等待的次数
+} StreamStatistics;
+
+class APRSStreamEngine {
+public:
+  APRSStreamEngine();
+  ~APRSStreamEngine();
+
+  /**
+   * 创建通道和解码器（不启动线程）
+   * @param numChannels 通道数
+   * @param numWorkers 工作线程数，0表示使用硬件线程数
+   * @return 成功返回true
+   */
+  bool begin(uint16_t numChannels, uint16_t numWorkers = 0);
+
+  /**
+   * 获取通道的解码器，只能在start()之前配置（例如setDemodulator）
+   * 各通道的解调器实例不能共享
+   */
+  APRSDecoder* getDecoder(uint16_t channel);
+
+  /**
+   * 启动工作线程
+   */
+  void start();
+
+  /**
+   * 送入位压缩采样（每个通道只能有一个生产者线程）
+   * @param channel 通道号
+   * @param words 采样字，最早的采样在最高位
+   * @param count 字数
+   * @param wait 队列满时等待；为false时丢弃放不下的采样并计数
+   * @return 全部送入时返回true
+   */
+  bool feed(uint16_t channel, const uint32_t* words, size_t count, bool wait = true);
+
+  /**
+   * 送入0/1采样（每字节一个），内部打包为32位字；close()时不足32个的采样被丢弃
+   */
+  bool feedSamples(uint16_t channel, const uint8_t* samples, size_t count, bool wait = true);
+
+  /**
+   * 送出未满的数据块（数据块满时才会自动送出，实时输入时可定期调用以降低延迟）
+   */
+  void flush(uint16_t channel);
+
+  /**
+   * 通道输入结束：送出未满的数据块，该通道处理完后不再阻挡其他通道的输出
+   */
+  void close(uint16_t channel);
+
+  /**
+   * 按（采样位置，通道号）顺序取出下一帧
+   * @param frame 输出
+   * @param wait 暂无可输出的帧时等待
+   * @return 取出一帧时返回true；所有通道都已关闭并处理完且没有剩余帧时，
+   *         或不等待且暂无可输出的帧时返回false
+   */
+  bool getFrame(StreamFrame* frame, bool wait);
+
+  /**
+   * 停止并等待工作线程退出（未处理的输入被丢弃）
+   */
+  void stop();
+
+  /**
+   * 获取通道统计（stop()之后读取；运行中读取的值仅供参考）
+   */
+  StreamStatistics* getStatistics(uint16_t channel);
+
+  /**
+   * 通道数
+   */
+  uint16_t getNumChannels();
+
+  /**
+   * 工作线程数
+   */
+  uint16_t getNumWorkers();
+
+protected:
+  // 通道（各自单独分配；队列索引每个数据块才更新一次，无需按缓存行隔离）
+  struct Channel {
+    APRSDecoder decoder;
+    uint32_t blocks[STREAM_QUEUE_BLOCKS][STREAM_BLOCK_WORDS];
+    uint16_t blockWords[STREAM_QUEUE_BLOCKS];     // 各数据块的字数
+    std::atomic<uint32_t> head;                   // 下一个写入的数据块（仅生产者修改）
+    std::atomic<uint32_t> tail;                   // 下一个读取的数据块（仅工作线程修改）
+    std::atomic<bool> closed;                     // 输入已结束（生产者设置）
+
+    // 生产者状态
+    uint16_t fill;                                // 当前写入块已有的字数
+    SamplePacker packer;
+
+    // 工作线程状态
+    bool finished;                                // 已确认关闭
+
+    // 以下由outputLock保护
+    uint64_t position;                            // 已解码的采样数
+    bool done;                                    // 已关闭且处理完
+    std::deque<StreamFrame> frames;               // 待合并输出的帧
+
+    StreamStatistics stats;
+  };
+
+  // 工作线程
+  struct Worker {
+    std::thread thread;
+    std::mutex lock;
+    std::condition_variable wake;                 // 有新数据或需要停止
+  };
+
+  std::vector<Channel*> channels;
+  std::vector<Worker*> workers;
+  uint16_t numChannels;
+  uint16_t numWorkers;
+  std::atomic<bool> stopping;
+  bool running;
+
+  // 合并输出
+  std::mutex outputLock;
+  std::condition_variable progress;               // 有通道处理完一个数据块
+
+  /**
+   * 等待队列中有空闲的数据块
+   * @return 队列满且不等待（或引擎已停止）时返回false
+   */
+  bool waitForSpace(Channel* ch, bool wait);
+
+  /**
+   * 发布当前写入块并唤醒工作线程
+   */
+  void publish(uint16_t channel);
+
+  /**
+   * 唤醒通道所属的工作线程
+   */
+  void notifyWorker(uint16_t channel);
+
+  /**
+   * 工作线程主循环
+   */
+  void workerLoop(uint16_t index);
+
+  /**
+   * 处理通道队列中的所有数据块
+   * @return 处理了数据时返回true
+   */
+  bool processChannel(uint16_t channel);
+
+  /**
+   * 通道是否有待处理的数据块或未确认的关闭
+   */
+  bool hasWork(uint16_t channel);
+};
+
+#endif // APRS_PLATFORM_HOST
+
+#endif // APRS_STREAM_ENGINE_H
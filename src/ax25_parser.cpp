@@ -10,7 +10,74 @@
 #define CRC_INIT        0xFFFF
 #define CRC_GOOD        0xF0B8
 
+// CRC-16-CCITT查找表（反转多项式0x8408，每次处理一个字节）
+static const uint16_t crcTable[256] = {
+  0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+  0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+  0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+  0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+  0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+  0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+  0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+  0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+  0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+  0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+  0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+  0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+  0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+  0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+  0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+  0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+  0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+  0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+  0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+  0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+  0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+  0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+  0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+  0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+  0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+  0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+  0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+  0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+  0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+  0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+  0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+  0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
+};
+
+void ax25DecodeAddress(const uint8_t* field, APRS_AX25Address* address) {
+  // AX.25地址格式：每个字符左移1位编码，以空格填充
+  uint8_t len = 0;
+  for (int i = 0; i < 6; i++) {
+    char c = field[i] >> 1;  // 右移1位还原
+    if (c == ' ') {
+      break;
+    }
+    address->callsign[len++] = c;
+  }
+  while (len < sizeof(address->callsign)) {
+    address->callsign[len++] = '\0';
+  }
+  
+  // SSID在第7个字节的bit1-4
+  address->ssid = (field[6] >> 1) & 0x0F;
+}
+
+void ax25GetDestination(const APRS_AX25Frame* frame, APRS_AX25Address* address) {
+  ax25DecodeAddress(ax25GetAddressField(frame, AX25_ADDR_DESTINATION), address);
+}
+
+void ax25GetSource(const APRS_AX25Frame* frame, APRS_AX25Address* address) {
+  ax25DecodeAddress(ax25GetAddressField(frame, AX25_ADDR_SOURCE), address);
+}
+
+void ax25GetDigipeater(const APRS_AX25Frame* frame, uint8_t index, APRS_AX25Address* address) {
+  ax25DecodeAddress(ax25GetAddressField(frame, AX25_ADDR_DIGIPEATER + index), address);
+}
+
 AX25Parser::AX25Parser() {
+  currentFrame = nullptr;
   reset();
 }
 
@@ -19,40 +86,21 @@ void AX25Parser::begin() {
 }
 
 void AX25Parser::reset() {
-  memset(&currentFrame, 0, sizeof(APRS_AX25Frame));
-  memset(rawBuffer, 0, sizeof(rawBuffer));
   rawBufferPos = 0;
   crc = CRC_INIT;
 }
 
-void AX25Parser::startFrame() {
+void AX25Parser::setBuffer(APRS_AX25Frame* frame) {
+  currentFrame = frame;
   reset();
 }
 
-void AX25Parser::parseAddress(uint8_t* buffer, APRS_AX25Address* address) {
-  // AX.25地址格式：每个字符左移1位编码
-  memset(address->callsign, 0, sizeof(address->callsign));
-  
-  for (int i = 0; i < 6; i++) {
-    char c = buffer[i] >> 1;  // 右移1位还原
-    if (c != ' ') {  // 移除填充空格
-      address->callsign[i] = c;
-    }
-  }
-  
-  // SSID在第7个字节的高4位
-  address->ssid = (buffer[6] >> 1) & 0x0F;
+void AX25Parser::startFrame() {
+  reset();
 }
 
 void AX25Parser::updateCRC(uint8_t byte) {
-  crc ^= byte;
-  for (int i = 0; i < 8; i++) {
-    if (crc & 0x0001) {
-      crc = (crc >> 1) ^ CRC_POLYNOMIAL;
-    } else {
-      crc = crc >> 1;
-    }
-  }
+  crc = (crc >> 8) ^ crcTable[(crc ^ byte) & 0xFF];
 }
 
 bool AX25Parser::checkCRC() {
@@ -68,73 +116,82 @@ bool AX25Parser::addByte(uint8_t byte) {
   }
   
   // 存储字节并更新CRC
-  rawBuffer[rawBufferPos++] = byte;
+  currentFrame->raw[rawBufferPos++] = byte;
   updateCRC(byte);
   
-  // 检查最小帧长度
-  if (rawBufferPos < AX25_MIN_FRAME_LEN) {
-    return false;
+  return false;  // 在调用endFrame之前不完成解析
+}
+
+void AX25Parser::addBytes(const uint8_t* bytes, uint16_t count) {
+  // 截断到缓冲区剩余空间
+  uint16_t space = AX25_MAX_FRAME_LEN - rawBufferPos;
+  if (count > space) {
+    count = space;
   }
   
-  return false;  // 在调用endFrame之前不完成解析
+  // CRC累加器保存在局部变量中
+  uint16_t c = crc;
+  uint8_t* dst = &currentFrame->raw[rawBufferPos];
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t byte = bytes[i];
+    dst[i] = byte;
+    c = (c >> 8) ^ crcTable[(c ^ byte) & 0xFF];
+  }
+  
+  crc = c;
+  rawBufferPos += count;
+}
+
+uint16_t AX25Parser::getCRCSyndrome() {
+  return crc ^ CRC_GOOD;
+}
+
+uint16_t AX25Parser::getLength() {
+  return rawBufferPos;
 }
 
 bool AX25Parser::endFrame() {
+  APRS_AX25Frame* frame = currentFrame;
+  
   // 检查帧长度
   if (rawBufferPos < AX25_MIN_FRAME_LEN) {
-    currentFrame.valid = false;
+    frame->valid = false;
     return false;
   }
   
   // 校验CRC
-  currentFrame.valid = checkCRC();
-  if (!currentFrame.valid) {
+  frame->valid = checkCRC();
+  if (!frame->valid) {
     DEBUG_PRINTLN("AX.25 CRC Error");
     return false;
   }
   
-  // 解析地址字段
-  uint16_t pos = 0;
-  
-  // 目标地址
-  parseAddress(&rawBuffer[pos], &currentFrame.destination);
-  pos += AX25_ADDR_LEN;
-  
-  // 源地址
-  parseAddress(&rawBuffer[pos], &currentFrame.source);
-  pos += AX25_ADDR_LEN;
+  const uint8_t* raw = frame->raw;
+  frame->fixedBits = 0;
+  uint16_t end = rawBufferPos - 2;  // FCS之前
+  frame->length = rawBufferPos;
+  frame->fcs = raw[end] | (raw[end + 1] << 8);
   
-  // 解析中继路径（检查地址扩展位）
-  currentFrame.numDigipeaters = 0;
-  while ((rawBuffer[pos - 1] & 0x01) == 0 && currentFrame.numDigipeaters < 8) {
-    parseAddress(&rawBuffer[pos], &currentFrame.digipeaters[currentFrame.numDigipeaters]);
-    currentFrame.numDigipeaters++;
+  // 跳过目标地址和源地址，按地址扩展位统计中继数量
+  uint16_t pos = 2 * AX25_ADDR_LEN;
+  frame->numDigipeaters = 0;
+  while ((raw[pos - 1] & 0x01) == 0 && frame->numDigipeaters < AX25_MAX_DIGIPEATERS &&
+         pos + AX25_ADDR_LEN <= end) {
+    frame->numDigipeaters++;
     pos += AX25_ADDR_LEN;
-    
-    // 防止溢出
-    if (pos >= rawBufferPos - 2) break;
   }
   
-  // 控制字段
-  if (pos < rawBufferPos - 2) {
-    currentFrame.control = rawBuffer[pos++];
-  }
-  
-  // PID字段
-  if (pos < rawBufferPos - 2) {
-    currentFrame.pid = rawBuffer[pos++];
-  }
+  // 控制字段和PID
+  frame->control = (pos < end) ? raw[pos++] : 0;
+  frame->pid = (pos < end) ? raw[pos++] : 0;
   
   // 信息字段（去除最后2字节CRC）
-  currentFrame.infoLen = 0;
-  while (pos < rawBufferPos - 2 && currentFrame.infoLen < 256) {
-    currentFrame.info[currentFrame.infoLen++] = rawBuffer[pos++];
-  }
+  frame->infoOffset = pos;
+  frame->infoLen = end - pos;
   
   return true;
 }
 
 APRS_AX25Frame* AX25Parser::getFrame() {
-  return &currentFrame;
+  return currentFrame;
 }
-
@@ -2,6 +2,10 @@
  * AX.25帧解析器
  * 
  * 解析AX.25 UI帧，提取源地址、目标地址、路径和信息字段
+ * 
+ * 帧以接收到的原始字节保存，解析器只记录各字段的位置：
+ * 候选帧开始时不清空缓冲区，帧结束时不复制信息字段，信息字段不被截断。
+ * 呼号和路径在访问时（ax25GetSource等）从原始地址字节解码。
  */
 
 #ifndef AX25_PARSER_H
@@ -16,19 +20,75 @@ typedef struct {
   uint8_t ssid;       // SSID (0-15)
 } APRS_AX25Address;
 
+// 最大中继数量
+#define AX25_MAX_DIGIPEATERS  8
+
+// 地址字段索引
+#define AX25_ADDR_DESTINATION 0
+#define AX25_ADDR_SOURCE      1
+#define AX25_ADDR_DIGIPEATER  2      // 第一个中继地址
+
 // AX.25帧结构 (重命名以避免与RadioLib冲突)
+// raw必须是最后一个成员：帧队列只保存 offsetof(raw) + length 字节
 typedef struct {
-  APRS_AX25Address destination;      // 目标地址
-  APRS_AX25Address source;            // 源地址
-  APRS_AX25Address digipeaters[8];    // 中继路径
+  uint16_t length;               // 原始帧长度（含FCS）
+  uint16_t infoOffset;           // 信息字段在raw中的位置
+  uint16_t infoLen;              // 信息长度
   uint8_t numDigipeaters;        // 中继数量
   uint8_t control;               // 控制字段
   uint8_t pid;                   // 协议标识
-  uint8_t info[256];             // 信息字段
-  uint16_t infoLen;              // 信息长度
+  uint16_t fcs;                  // 帧校验序列（接收到的CRC）
+  uint8_t fixedBits;             // 比特修复翻转的比特数（0表示原样通过CRC）
   bool valid;                    // CRC校验有效
+  uint8_t raw[AX25_MAX_FRAME_LEN];   // 原始帧（地址、控制、PID、信息和FCS）
 } APRS_AX25Frame;
 
+/**
+ * 获取地址字段的原始字节（7字节，字符左移1位编码）
+ * @param frame 帧
+ * @param index 地址索引（AX25_ADDR_DESTINATION、AX25_ADDR_SOURCE、AX25_ADDR_DIGIPEATER + i）
+ */
+static inline const uint8_t* ax25GetAddressField(const APRS_AX25Frame* frame, uint8_t index) {
+  return &frame->raw[index * AX25_ADDR_LEN];
+}
+
+/**
+ * 获取信息字段
+ */
+static inline const uint8_t* ax25GetInfo(const APRS_AX25Frame* frame) {
+  return &frame->raw[frame->infoOffset];
+}
+
+/**
+ * 中继地址是否已被转发（H位，TNC2格式中以*标记）
+ */
+static inline bool ax25IsRepeated(const APRS_AX25Frame* frame, uint8_t digipeater) {
+  return (ax25GetAddressField(frame, AX25_ADDR_DIGIPEATER + digipeater)[6] & 0x80) != 0;
+}
+
+/**
+ * 解码地址字段
+ * @param field 7字节原始地址
+ * @param address 输出地址结构
+ */
+void ax25DecodeAddress(const uint8_t* field, APRS_AX25Address* address);
+
+/**
+ * 解码目标地址
+ */
+void ax25GetDestination(const APRS_AX25Frame* frame, APRS_AX25Address* address);
+
+/**
+ * 解码源地址
+ */
+void ax25GetSource(const APRS_AX25Frame* frame, APRS_AX25Address* address);
+
+/**
+ * 解码中继地址
+ * @param index 中继索引 (0 - numDigipeaters-1)
+ */
+void ax25GetDigipeater(const APRS_AX25Frame* frame, uint8_t index, APRS_AX25Address* address);
+
 class AX25Parser {
 public:
   AX25Parser();
@@ -39,7 +99,13 @@ public:
   void begin();
   
   /**
-   * 开始接收新帧
+   * 设置接收缓冲区（帧在其中原地接收和解析）
+   * @param frame 帧存储，接收期间由解析器独占
+   */
+  void setBuffer(APRS_AX25Frame* frame);
+  
+  /**
+   * 开始接收新帧（只复位长度和CRC，不清空缓冲区）
    */
   void startFrame();
   
@@ -51,14 +117,33 @@ public:
   bool addByte(uint8_t byte);
   
   /**
-   * 结束当前帧并进行CRC校验
+   * 批量添加字节到当前帧
+   * 超出最大帧长度的部分被丢弃
+   * @param bytes 字节数组
+   * @param count 字节数量
+   */
+  void addBytes(const uint8_t* bytes, uint16_t count);
+  
+  /**
+   * 获取当前帧已接收的字节数（含FCS）
+   */
+  uint16_t getLength();
+  
+  /**
+   * 获取CRC校正子（当前CRC累加器与正确余数之差，0表示CRC正确）
+   * 用于比特修复：翻转比特对CRC的影响与该校正子相等时，翻转后CRC正确
+   */
+  uint16_t getCRCSyndrome();
+  
+  /**
+   * 结束当前帧，进行CRC校验并定位各字段
    * @return 如果帧有效，返回true
    */
   bool endFrame();
   
   /**
-   * 获取解析后的帧
-   * @return 指向解析后帧的指针
+   * 获取接收缓冲区中的帧
+   * @return 指向帧的指针
    */
   APRS_AX25Frame* getFrame();
   
@@ -68,18 +153,10 @@ public:
   void reset();
 
 protected:
-  APRS_AX25Frame currentFrame;       // 当前帧
-  uint8_t rawBuffer[AX25_MAX_FRAME_LEN];  // 原始字节缓冲
+  APRS_AX25Frame* currentFrame; // 接收缓冲区
   uint16_t rawBufferPos;        // 缓冲位置
   uint16_t crc;                 // CRC累加器
   
-  /**
-   * 解析地址字段
-   * @param buffer 地址字节数组
-   * @param address 输出地址结构
-   */
-  void parseAddress(uint8_t* buffer, APRS_AX25Address* address);
-  
   /**
    * 更新CRC
    * @param byte 输入字节
@@ -0,0 +1,99 @@
+/**
+ * 1比特采样的CIC抽取滤波器实现
+ */
+
+#include "cic_decimator.h"
+#include <string.h>
+
+CICDecimator::CICDecimator() {
+  begin(1, 1);
+}
+
+bool CICDecimator::begin(uint8_t newFactor, uint8_t order) {
+  if ((newFactor & (newFactor - 1)) != 0 || newFactor == 0 || newFactor > CIC_MAX_DECIMATION ||
+      order == 0 || order > CIC_MAX_ORDER) {
+    return false;
+  }
+
+  // 冲激响应：长度为R的矩形窗自卷积N次
+  uint8_t coeffs[CIC_MAX_ORDER * (CIC_MAX_DECIMATION - 1) + 1];
+  uint8_t length = 1;
+  coeffs[0] = 1;
+  for (uint8_t n = 0; n < order; n++) {
+    uint8_t next[sizeof(coeffs)];
+    memset(next, 0, sizeof(next));
+    for (uint8_t i = 0; i < length; i++) {
+      for (uint8_t j = 0; j < newFactor; j++) {
+        next[i + j] = (uint8_t)(next[i + j] + coeffs[i]);
+      }
+    }
+    length = (uint8_t)(length + newFactor - 1);
+    memcpy(coeffs, next, length);
+  }
+
+  // 按二进制位拆分为位平面
+  memset(planes, 0, sizeof(planes));
+  numPlanes = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    for (uint8_t p = 0; p < CIC_MAX_PLANES; p++) {
+      if (coeffs[i] & (1 << p)) {
+        planes[p] |= 1UL << i;
+        if (p + 1 > numPlanes) {
+          numPlanes = (uint8_t)(p + 1);
+        }
+      }
+    }
+  }
+
+  factor = newFactor;
+  levelShift = 0;
+  while ((1 << levelShift) < newFactor) {
+    levelShift++;
+  }
+  levelShift = (uint8_t)(levelShift * order);
+  gain = (int16_t)(1 << levelShift);
+
+  reset();
+  return true;
+}
+
+void CICDecimator::reset() {
+  // 以0/1交替的历史开始（相当于无信号时的零电平），避免启动时出现满幅输出
+  history = 0x55555555UL;
+  phase = 0;
+}
+
+uint16_t CICDecimator::process(const uint32_t* words, uint16_t count, int16_t* levels) {
+  const uint8_t r = factor;
+  const uint32_t chunkMask = (1UL << r) - 1;
+  uint16_t n = 0;
+
+  // 之前push的采样不足一个输出周期时逐个采样处理，直到与字边界对齐
+  uint16_t i = 0;
+  for (; i < count && phase != 0; i++) {
+    for (int8_t b = 31; b >= 0; b--) {
+      n += push((uint8_t)(words[i] >> b), &levels[n]) ? 1 : 0;
+    }
+  }
+
+  uint32_t hist = history;
+  for (; i < count; i++) {
+    uint32_t word = words[i];
+    // 最早的采样在最高位，每次移入R个采样产生一个输出
+    for (int8_t shift = (int8_t)(32 - r); shift >= 0; shift -= r) {
+      hist = (hist << r) | ((word >> shift) & chunkMask);
+      levels[n++] = filter(hist);
+    }
+  }
+
+  history = hist;
+  return n;
+}
+
+uint8_t CICDecimator::getFactor() {
+  return factor;
+}
+
+uint8_t CICDecimator::getLevelShift() {
+  return levelShift;
+}
@@ -0,0 +1,104 @@
+/**
+ * 1比特采样的CIC抽取滤波器
+ *
+ * 将位压缩的1比特采样（每字32个，最早的采样在最高位）低通滤波并按因子R抽取，
+ * 输出多电平采样。N阶CIC（微分延迟1）的冲激响应是N个长度为R的矩形窗的卷积，
+ * 全部系数为小整数，长度 N(R-1)+1 不超过32：
+ * 输入只有0/1时，加权和可按系数的二进制位分解为若干次"掩码后求位数"，
+ * 每个输出只需几次popcount，不需要逐个输入采样的积分器和梳状器运算。
+ *
+ * 输出电平为 2 * 加权和 - 增益，范围 [-增益, 增益]，增益 = R^N = 2^getLevelShift()。
+ * 系数对称，各输出相对输入的延迟固定，不影响时钟恢复。
+ */
+
+#ifndef CIC_DECIMATOR_H
+#define CIC_DECIMATOR_H
+
+#include "aprs_config.h"
+#include "afsk_packed.h"
+#include <stdint.h>
+
+// 抽取因子上限（须整除32，一个压缩字产生整数个输出）
+#define CIC_MAX_DECIMATION  8
+
+// 阶数上限（8^3 = 512，电平在int16范围内，系数最大48）
+#define CIC_MAX_ORDER       3
+
+// 系数二进制位数上限
+#define CIC_MAX_PLANES      6
+
+class CICDecimator {
+public:
+  CICDecimator();
+
+  /**
+   * 初始化滤波器（生成系数位平面）
+   * @param factor 抽取因子：1、2、4或8
+   * @param order 阶数 (1 - CIC_MAX_ORDER)
+   * @return 参数无效时返回false
+   */
+  bool begin(uint8_t factor, uint8_t order);
+
+  /**
+   * 清空滤波器历史
+   */
+  void reset();
+
+  /**
+   * 输入单个采样
+   * @param sample 采样 (0或1)
+   * @param level 输出电平（返回true时有效）
+   * @return 每输入R个采样产生一个输出，此时返回true
+   */
+  inline bool push(uint8_t sample, int16_t* level) {
+    history = (history << 1) | (sample & 1);
+    if (++phase < factor) {
+      return false;
+    }
+    phase = 0;
+    *level = filter(history);
+    return true;
+  }
+
+  /**
+   * 滤波并抽取位压缩采样
+   * @param words 压缩采样
+   * @param count 字数
+   * @param levels 输出电平，容量至少为 count * 32 / 抽取因子
+   *               （与push混用时，输出与之前push的采样连续）
+   * @return 输出的电平数
+   */
+  uint16_t process(const uint32_t* words, uint16_t count, int16_t* levels);
+
+  /**
+   * 抽取因子
+   */
+  uint8_t getFactor();
+
+  /**
+   * 输出电平的位数：|电平| <= 2^getLevelShift()
+   */
+  uint8_t getLevelShift();
+
+protected:
+  uint32_t planes[CIC_MAX_PLANES];  // 系数位平面：bit i为第i个抽头系数的对应二进制位
+  uint8_t numPlanes;
+  uint8_t factor;
+  uint8_t levelShift;               // log2(增益)
+  int16_t gain;
+  uint32_t history;                 // 最近32个输入采样（bit0为最新）
+  uint8_t phase;                    // 距上一个输出的输入采样数
+
+  /**
+   * 对最近的输入采样加权求和，换算为电平
+   */
+  inline int16_t filter(uint32_t hist) {
+    int32_t sum = 0;
+    for (uint8_t p = 0; p < numPlanes; p++) {
+      sum += (int32_t)popcount32(hist & planes[p]) << p;
+    }
+    return (int16_t)(2 * sum - gain);
+  }
+};
+
+#endif // CIC_DECIMATOR_H
@@ -0,0 +1,157 @@
+/**
+ * DMA采样的半缓冲区处理实现
+ */
+
+#include "dma_capture.h"
+#include <string.h>
+
+DMACapture::DMACapture() {
+  captureBuffer = nullptr;
+  halfSize = 0;
+  sampleBit = 0;
+  captureCallback = nullptr;
+  expectComplete = false;
+  resetStatistics();
+}
+
+bool DMACapture::attach(uint8_t* buffer, uint16_t size, uint8_t pinBit,
+                        DMACaptureCallback callback) {
+  if (buffer == nullptr || size == 0 || size > DMA_CAPTURE_BUFFER_SIZE ||
+      size % (2 * PACKED_SAMPLES_PER_WORD) != 0 || pinBit > 7) {
+    return false;
+  }
+
+  captureBuffer = buffer;
+  halfSize = size / 2;
+  sampleBit = pinBit;
+  captureCallback = callback;
+  expectComplete = false;
+  resetStatistics();
+  return true;
+}
+
+void DMACapture::handleHalfTransfer() {
+  // 中断顺序应为半传输、传输完成交替，否则中间丢失了一个半区
+  if (expectComplete) {
+    stats.overruns++;
+  }
+  expectComplete = true;
+  processHalf(false);
+}
+
+void DMACapture::handleTransferComplete() {
+  if (!expectComplete) {
+    stats.overruns++;
+  }
+  expectComplete = false;
+  processHalf(true);
+}
+
+void DMACapture::processHalf(bool second) {
+  if (captureBuffer == nullptr) {
+    return;
+  }
+
+  uint16_t start = second ? halfSize : 0;
+  packPinSamples(captureBuffer + start, halfSize, sampleBit, words);
+  if (captureCallback != nullptr) {
+    captureCallback(words, (uint16_t)(halfSize / PACKED_SAMPLES_PER_WORD));
+  }
+  stats.halfTransfers++;
+
+  // DMA应在另一半区写入；已回到本半区说明处理时间超过了半个缓冲区
+  uint16_t pos = getWritePosition();
+  if (pos >= start && pos < start + halfSize) {
+    stats.overruns++;
+  }
+}
+
+DMACaptureStatistics* DMACapture::getStatistics() {
+  return &stats;
+}
+
+void DMACapture::resetStatistics() {
+  memset(&stats, 0, sizeof(stats));
+}
+
+#if APRS_PLATFORM_HOST
+
+HostDMASimulator::HostDMASimulator() : DMACapture() {
+  position = 0;
+  noise = 1;
+  stallSamples = 0;
+  stallRemaining = 0;
+  stalledComplete = false;
+}
+
+bool HostDMASimulator::begin(uint8_t* buffer, uint16_t size, uint8_t pinBit,
+                             DMACaptureCallback callback) {
+  position = 0;
+  noise = 0x2545F491UL;
+  stallSamples = 0;
+  stallRemaining = 0;
+  return attach(buffer, size, pinBit, callback);
+}
+
+void HostDMASimulator::feed(const uint8_t* samples, uint32_t count) {
+  if (captureBuffer == nullptr) {
+    return;
+  }
+
+  const uint8_t pinMask = (uint8_t)(1u << sampleBit);
+  for (uint32_t i = 0; i < count; i++) {
+    // xorshift32
+    noise ^= noise << 13;
+    noise ^= noise >> 17;
+    noise ^= noise << 5;
+
+    uint8_t value = (uint8_t)(noise & ~pinMask);
+    if (samples[i]) {
+      value |= pinMask;
+    }
+    captureBuffer[position++] = value;
+
+    // 与DMA相同：写满半区后中断，写满整个缓冲区后回到起点
+    bool half = (position == halfSize);
+    bool complete = (position == 2 * halfSize);
+    if (complete) {
+      position = 0;
+    }
+
+    // 被延迟的中断：期间的边界不产生中断，等待结束后执行
+    if (stallRemaining > 0) {
+      if (--stallRemaining == 0) {
+        raiseInterrupt(stalledComplete);
+      }
+      continue;
+    }
+
+    if (half || complete) {
+      if (stallSamples > 0) {
+        stallRemaining = stallSamples;
+        stalledComplete = complete;
+        stallSamples = 0;
+      } else {
+        raiseInterrupt(complete);
+      }
+    }
+  }
+}
+
+void HostDMASimulator::stallNextInterrupt(uint32_t delay) {
+  stallSamples = delay;
+}
+
+void HostDMASimulator::raiseInterrupt(bool complete) {
+  if (complete) {
+    handleTransferComplete();
+  } else {
+    handleHalfTransfer();
+  }
+}
+
+uint16_t HostDMASimulator::getWritePosition() {
+  return position;
+}
+
+#endif // APRS_PLATFORM_HOST
@@ -0,0 +1,141 @@
+/**
+ * DMA采样的半缓冲区处理
+ *
+ * 定时器每个采样周期触发一次DMA，把GPIO输入寄存器（一个字节）写入循环缓冲区：
+ * - 前半区写满时产生半传输中断，后半区写满时产生传输完成中断，DMA随即从头继续写
+ * - 每次中断把刚写满的半区按引脚位打包为压缩采样（32个采样/字），交给回调
+ *   （写入SampleRing或直接调用processPackedSamples）
+ * 回调必须在DMA写满另一半区之前返回；返回时DMA已写回本半区的次数计为溢出。
+ *
+ * 本类与硬件无关：DMAManager（stm32_hal.h）配置定时器和DMA并在中断中调用
+ * handleHalfTransfer/handleTransferComplete；主机上HostDMASimulator按相同的
+ * 顺序写缓冲区并调用同样的处理，用于回放和测试。
+ */
+
+#ifndef DMA_CAPTURE_H
+#define DMA_CAPTURE_H
+
+#include "aprs_config.h"
+#include "afsk_packed.h"
+#include <stdint.h>
+
+// 每个半区的压缩字数
+#define DMA_CAPTURE_HALF_WORDS  (DMA_CAPTURE_BUFFER_SIZE / 2 / PACKED_SAMPLES_PER_WORD)
+
+// DMA采样统计
+typedef struct {
+  uint32_t halfTransfers;       // 处理的半区数
+  uint32_t overruns;            // 处理不及时的次数（回调返回时DMA已写入本半区，或中断丢失）
+} DMACaptureStatistics;
+
+/**
+ * 半区回调
+ * @param words 压缩采样（最早的采样在最高位）
+ * @param count 字数
+ */
+typedef void (*DMACaptureCallback)(const uint32_t* words, uint16_t count);
+
+class DMACapture {
+public:
+  DMACapture();
+
+  /**
+   * 设置缓冲区和回调（在启动DMA之前调用）
+   * @param buffer 循环缓冲区
+   * @param size 缓冲区大小（采样），两个半区各为32的倍数，不超过DMA_CAPTURE_BUFFER_SIZE
+   * @param pinBit 采样引脚在输入寄存器字节中的位置 (0-7)
+   * @param callback 半区回调（中断上下文）
+   * @return 参数无效时返回false
+   */
+  bool attach(uint8_t* buffer, uint16_t size, uint8_t pinBit, DMACaptureCallback callback);
+
+  /**
+   * 半传输中断：前半区已写满
+   */
+  void handleHalfTransfer();
+
+  /**
+   * 传输完成中断：后半区已写满
+   */
+  void handleTransferComplete();
+
+  /**
+   * 获取统计信息
+   */
+  DMACaptureStatistics* getStatistics();
+
+  /**
+   * 重置统计信息
+   */
+  void resetStatistics();
+
+protected:
+  uint8_t* captureBuffer;
+  uint16_t halfSize;                        // 半区大小（采样）
+  uint8_t sampleBit;
+  DMACaptureCallback captureCallback;
+  bool expectComplete;                      // 下一个中断应为传输完成
+  uint32_t words[DMA_CAPTURE_HALF_WORDS];   // 打包后的半区
+  DMACaptureStatistics stats;
+
+  /**
+   * DMA下一个写入位置（采样索引）
+   */
+  virtual uint16_t getWritePosition() = 0;
+
+  /**
+   * 打包并处理一个半区
+   * @param second 是否为后半区
+   */
+  void processHalf(bool second);
+};
+
+#if APRS_PLATFORM_HOST
+
+/**
+ * 主机端DMA模拟
+ * 每个采样按定时器触发的顺序写入循环缓冲区（采样引脚以外的位填充随机数据，
+ * 与SPI等引脚同在一个端口时相同），写满半区时同步调用对应的中断处理
+ */
+class HostDMASimulator : public DMACapture {
+public:
+  HostDMASimulator();
+
+  /**
+   * 初始化（等价于DMAManager::begin + start）
+   */
+  bool begin(uint8_t* buffer, uint16_t size, uint8_t pinBit, DMACaptureCallback callback);
+
+  /**
+   * 输入采样
+   * @param samples 每字节一个采样 (0或1)
+   * @param count 采样数
+   */
+  void feed(const uint8_t* samples, uint32_t count);
+
+  /**
+   * 模拟下一次半区中断被延迟（例如更高优先级的中断占用CPU）：
+   * 中断到来后DMA继续写入delay个采样，之后才执行中断处理。
+   * 延迟期间经过的半区边界不再产生中断（与中断标志未及时处理相同）。
+   * @param delay 延迟的采样数，超过半区大小时处理时DMA已回到本半区，计为溢出
+   */
+  void stallNextInterrupt(uint32_t delay);
+
+protected:
+  uint16_t position;
+  uint32_t noise;                           // 其他引脚的伪随机数据
+  uint32_t stallSamples;                    // 下一次中断的延迟（采样）
+  uint32_t stallRemaining;                  // 正在延迟的中断还需等待的采样数
+  bool stalledComplete;                     // 被延迟的中断是否为传输完成
+
+  uint16_t getWritePosition() override;
+
+  /**
+   * 执行半传输或传输完成中断处理
+   */
+  void raiseInterrupt(bool complete);
+};
+
+#endif // APRS_PLATFORM_HOST
+
+#endif // DMA_CAPTURE_H
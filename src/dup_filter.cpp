@@ -0,0 +1,87 @@
+/**
+ * 重复帧抑制实现
+ */
+
+#include "dup_filter.h"
+#include <string.h>
+
+#define TABLE_MASK    (DUP_FILTER_SIZE - 1)
+#define FNV_OFFSET    2166136261u
+#define FNV_PRIME     16777619u
+
+DuplicateFilter::DuplicateFilter() {
+  window = DUP_FILTER_WINDOW_MS;
+  reset();
+}
+
+void DuplicateFilter::reset() {
+  memset(table, 0, sizeof(table));
+  memset(&stats, 0, sizeof(stats));
+}
+
+void DuplicateFilter::setWindow(uint32_t windowMs) {
+  window = windowMs;
+}
+
+uint32_t DuplicateFilter::frameKey(const APRS_AX25Frame* frame) {
+  uint32_t h = FNV_OFFSET;
+
+  // 目标和源地址：6个呼号字节 + SSID（不含C位和扩展位）
+  for (uint8_t a = AX25_ADDR_DESTINATION; a <= AX25_ADDR_SOURCE; a++) {
+    const uint8_t* field = ax25GetAddressField(frame, a);
+    for (uint8_t i = 0; i < AX25_ADDR_LEN - 1; i++) {
+      h = (h ^ field[i]) * FNV_PRIME;
+    }
+    h = (h ^ (field[AX25_ADDR_LEN - 1] & 0x1E)) * FNV_PRIME;
+  }
+
+  const uint8_t* info = ax25GetInfo(frame);
+  for (uint16_t i = 0; i < frame->infoLen; i++) {
+    h = (h ^ info[i]) * FNV_PRIME;
+  }
+  h ^= frame->infoLen;
+
+  return (h != 0) ? h : 1;
+}
+
+bool DuplicateFilter::isDuplicate(const APRS_AX25Frame* frame, uint32_t now) {
+  uint32_t key = frameKey(frame);
+  uint16_t start = (uint16_t)((key ^ (key >> 16)) & TABLE_MASK);
+  DupEntry* victim = nullptr;
+  uint32_t victimAge = 0;
+
+  stats.framesChecked++;
+
+  // 探测固定数量的槽位：查找匹配记录，同时选出空槽、过期槽或最旧的槽
+  for (uint8_t i = 0; i < DUP_FILTER_PROBES; i++) {
+    DupEntry* e = &table[(start + i) & TABLE_MASK];
+    uint32_t age = now - e->time;
+
+    if (e->key == 0 || age > window) {
+      if (victim == nullptr || victimAge <= window) {
+        victim = e;
+        victimAge = UINT32_MAX;           // 空槽/过期槽优先
+      }
+      continue;
+    }
+    if (e->key == key) {
+      stats.duplicates++;                 // 窗口从首次出现算起，不刷新
+      return true;
+    }
+    if (victim == nullptr || age > victimAge) {
+      victim = e;
+      victimAge = age;
+    }
+  }
+
+  if (victimAge <= window) {
+    stats.evictions++;
+  }
+  victim->key = key;
+  victim->time = now;
+  return false;
+}
+
+DupFilterStatistics* DuplicateFilter::getStatistics() {
+  return &stats;
+}
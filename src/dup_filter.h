@@ -0,0 +1,82 @@
+/**
+ * 重复帧抑制
+ *
+ * 同一个APRS包通常在几秒内被收到多次：直接收到一次，每个数字中继转发一次。
+ * 各副本的源地址、目标地址和信息字段相同，只有中继路径不同。
+ * 过滤器记录最近输出的帧的键（源/目标地址和信息字段的哈希）和首次出现时刻，
+ * 时间窗口内再次出现的帧判为重复。
+ *
+ * - 开放寻址哈希表，容量DUP_FILTER_SIZE条，不使用堆
+ * - 每次查找固定探测DUP_FILTER_PROBES个槽位，耗时与表中记录数无关
+ * - 过期记录不单独删除，插入时直接复用；探测范围内没有空槽或过期槽时
+ *   替换其中最旧的记录（计入evictions，被替换的帧之后的副本可能不再被抑制）
+ */
+
+#ifndef DUP_FILTER_H
+#define DUP_FILTER_H
+
+#include "aprs_config.h"
+#include "ax25_parser.h"
+#include <stdint.h>
+
+#if (DUP_FILTER_SIZE & (DUP_FILTER_SIZE - 1)) != 0 || DUP_FILTER_SIZE < 8
+  #error "DUP_FILTER_SIZE必须为2的幂且不小于8"
+#endif
+
+// 每次查找探测的槽位数
+#ifndef DUP_FILTER_PROBES
+  #define DUP_FILTER_PROBES     8
+#endif
+
+// 过滤统计
+typedef struct {
+  uint32_t framesChecked;       // 检查的帧数
+  uint32_t duplicates;          // 被抑制的重复帧数
+  uint32_t evictions;           // 未过期即被替换的记录数
+} DupFilterStatistics;
+
+class DuplicateFilter {
+public:
+  DuplicateFilter();
+
+  /**
+   * 清空记录和统计
+   */
+  void reset();
+
+  /**
+   * 设置时间窗口
+   * @param windowMs 时间窗口（毫秒）
+   */
+  void setWindow(uint32_t windowMs);
+
+  /**
+   * 检查帧是否为时间窗口内的重复帧；不是重复帧时记录该帧
+   * @param frame 有效帧
+   * @param now 当前时刻（毫秒，允许回绕）
+   * @return 重复帧返回true（应丢弃）
+   */
+  bool isDuplicate(const APRS_AX25Frame* frame, uint32_t now);
+
+  /**
+   * 获取统计信息
+   */
+  DupFilterStatistics* getStatistics();
+
+protected:
+  typedef struct {
+    uint32_t key;               // 帧键，0表示空槽
+    uint32_t time;              // 首次出现时刻（毫秒）
+  } DupEntry;
+
+  DupEntry table[DUP_FILTER_SIZE];
+  uint32_t window;
+  DupFilterStatistics stats;
+
+  /**
+   * 计算帧键：源/目标地址（仅呼号和SSID）和信息字段的FNV-1a哈希
+   */
+  static uint32_t frameKey(const APRS_AX25Frame* frame);
+};
+
+#endif // DUP_FILTER_H
@@ -0,0 +1,130 @@
+/**
+ * 解码帧输出队列实现
+ */
+
+#include "frame_queue.h"
+#include <string.h>
+
+FrameQueue::FrameQueue() {
+  policy = FRAME_QUEUE_POLICY;
+  reset();
+}
+
+void FrameQueue::reset() {
+  head = 0;
+  numQueued = 0;
+  writePos = 0;
+  dropped = 0;
+  highWater = 0;
+}
+
+void FrameQueue::setPolicy(uint8_t newPolicy) {
+  policy = newPolicy;
+}
+
+APRS_AX25Frame* FrameQueue::acquire() {
+  return &receiveFrame;
+}
+
+int32_t FrameQueue::allocEntry(uint16_t size) {
+  if (numQueued == 0) {
+    writePos = 0;
+    return 0;
+  }
+  
+  uint16_t first = entryPos[head];
+  uint16_t last = entryPos[(head + numQueued - 1) % FRAME_QUEUE_DEPTH];
+  if (last >= first) {
+    // 各帧按顺序排列在 [first, writePos)：先用末尾的空间，不够时回到开头
+    if (writePos + size <= FRAME_QUEUE_BYTES) {
+      return writePos;
+    }
+    return (size <= first) ? 0 : -1;
+  }
+  // 已回绕：空闲空间为 [writePos, first)
+  return (writePos + size <= first) ? writePos : -1;
+}
+
+void FrameQueue::dropHead() {
+  head = (head + 1) % FRAME_QUEUE_DEPTH;
+  numQueued--;
+}
+
+bool FrameQueue::commit(uint8_t tag) {
+  return push(&receiveFrame, tag);
+}
+
+bool FrameQueue::push(const APRS_AX25Frame* frame, uint8_t tag) {
+  uint16_t size = (uint16_t)FRAME_QUEUE_ENTRY_SIZE(frame->length);
+  int32_t pos = (numQueued < FRAME_QUEUE_DEPTH) ? allocEntry(size) : -1;
+  
+  if (pos < 0 && policy == FRAME_QUEUE_DROP_NEWEST) {
+    dropped++;
+    return false;
+  }
+  
+  // 丢弃最旧的帧直到放得下（最长帧总能放入空队列）
+  while (pos < 0) {
+    dropHead();
+    dropped++;
+    pos = (numQueued < FRAME_QUEUE_DEPTH) ? allocEntry(size) : -1;
+  }
+  
+  // 只保存帧头和实际长度的原始字节
+  memcpy(&storage[pos], frame, offsetof(APRS_AX25Frame, raw) + frame->length);
+  uint8_t index = (head + numQueued) % FRAME_QUEUE_DEPTH;
+  entryPos[index] = (uint16_t)pos;
+  entryTag[index] = tag;
+  writePos = (uint16_t)(pos + size);
+  numQueued++;
+  
+  if (numQueued > highWater) {
+    highWater = numQueued;
+  }
+  return true;
+}
+
+APRS_AX25Frame* FrameQueue::pop(uint8_t* tag) {
+  if (numQueued == 0) {
+    return nullptr;
+  }
+  
+  const uint8_t* entry = &storage[entryPos[head]];
+  uint16_t length;
+  memcpy(&length, entry + offsetof(APRS_AX25Frame, length), sizeof(length));
+  memcpy(&heldFrame, entry, offsetof(APRS_AX25Frame, raw) + length);
+  
+  if (tag != nullptr) {
+    *tag = entryTag[head];
+  }
+  dropHead();
+  return &heldFrame;
+}
+
+const uint8_t* FrameQueue::peekInfo(uint16_t* length) {
+  if (numQueued == 0) {
+    return nullptr;
+  }
+  
+  const uint8_t* entry = &storage[entryPos[head]];
+  uint16_t infoOffset;
+  memcpy(&infoOffset, entry + offsetof(APRS_AX25Frame, infoOffset), sizeof(infoOffset));
+  memcpy(length, entry + offsetof(APRS_AX25Frame, infoLen), sizeof(*length));
+  return entry + offsetof(APRS_AX25Frame, raw) + infoOffset;
+}
+
+bool FrameQueue::available() {
+  return numQueued > 0;
+}
+
+uint8_t FrameQueue::count() {
+  return numQueued;
+}
+
+uint32_t FrameQueue::getDropped() {
+  return dropped;
+}
+
+uint8_t FrameQueue::getHighWater() {
+  return highWater;
+}
@@ -0,0 +1,142 @@
+/**
+ * 解码帧输出队列
+ * 
+ * 固定容量的已完成帧队列：解码器完成一帧后立即放入队列并继续搜索下一帧，
+ * 不再等待loop()取走上一帧。数字中继器转发的连续多份副本不会丢失。
+ * 
+ * - 排队的帧紧凑保存在FRAME_QUEUE_BYTES字节的存储中，每帧只占帧头和实际长度
+ *   （典型APRS帧约为最长帧的三分之一），队列容量为FRAME_QUEUE_DEPTH帧
+ * - 接收槽位（acquire()）是一个完整的帧：解析器直接在其中接收候选帧，
+ *   帧有效时commit()只复制帧头和实际长度的字节，候选帧不需要清空或复制
+ * - pop()把队首帧复制到返回槽位，该帧在下一次pop()之前保持有效
+ * - 队列满（帧数或存储）时按策略丢弃最旧或最新的帧，并计数
+ * - 每帧可附带一个标签（例如多判决器中的判决器编号）
+ */
+
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include "aprs_config.h"
+#include "ax25_parser.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if FRAME_QUEUE_DEPTH < 1 || FRAME_QUEUE_DEPTH > 14
+  #error "FRAME_QUEUE_DEPTH必须在1-14之间"
+#endif
+
+// 排队帧在存储中的对齐（字节）
+#define FRAME_QUEUE_ALIGN         4
+
+// 排队帧占用的存储：帧头（raw之前的成员）和实际长度的原始字节
+#define FRAME_QUEUE_ENTRY_SIZE(length) \
+  ((offsetof(APRS_AX25Frame, raw) + (length) + FRAME_QUEUE_ALIGN - 1) & ~(size_t)(FRAME_QUEUE_ALIGN - 1))
+
+#if FRAME_QUEUE_BYTES > 65535
+  #error "FRAME_QUEUE_BYTES不能超过65535"
+#endif
+
+static_assert(FRAME_QUEUE_ENTRY_SIZE(AX25_MAX_FRAME_LEN) <= FRAME_QUEUE_BYTES,
+              "FRAME_QUEUE_BYTES必须能容纳一个最长帧");
+
+class FrameQueue {
+public:
+  FrameQueue();
+  
+  /**
+   * 清空队列和统计
+   */
+  void reset();
+  
+  /**
+   * 设置队列满时的丢弃策略
+   * @param policy FRAME_QUEUE_DROP_OLDEST 或 FRAME_QUEUE_DROP_NEWEST
+   */
+  void setPolicy(uint8_t policy);
+  
+  /**
+   * 获取接收槽位
+   * 在commit()之前总是返回同一个槽位，内容可被任意改写
+   * @return 指向接收槽位的指针
+   */
+  APRS_AX25Frame* acquire();
+  
+  /**
+   * 将接收槽位中的帧加入队尾（复制帧头和实际长度的字节），接收槽位可继续使用
+   * @param tag 附带的标签
+   * @return 帧被放入队列时返回true（DROP_OLDEST策略下总是成功）；
+   *         DROP_NEWEST策略下队列已满时返回false
+   */
+  bool commit(uint8_t tag = 0);
+  
+  /**
+   * 复制一帧到队尾
+   * @param frame 帧
+   * @param tag 附带的标签
+   * @return 帧被放入队列时返回true（DROP_OLDEST策略下总是成功）
+   */
+  bool push(const APRS_AX25Frame* frame, uint8_t tag = 0);
+  
+  /**
+   * 取出队首帧
+   * @param tag 输出：帧的标签（可为nullptr）
+   * @return 指向帧的指针，在下一次pop()或reset()之前有效；队列为空时返回nullptr
+   */
+  APRS_AX25Frame* pop(uint8_t* tag = nullptr);
+  
+  /**
+   * 查看队首帧的信息字段（不取出）
+   * @param length 输出：信息字段长度
+   * @return 指向信息字段的指针，在下一次commit()、push()或pop()之前有效；
+   *         队列为空时返回nullptr
+   */
+  const uint8_t* peekInfo(uint16_t* length);
+  
+  /**
+   * 队列是否非空
+   */
+  bool available();
+  
+  /**
+   * 队列中的帧数
+   */
+  uint8_t count();
+  
+  /**
+   * 因队列满而丢弃的帧数
+   */
+  uint32_t getDropped();
+  
+  /**
+   * 队列中帧数的历史最大值
+   */
+  uint8_t getHighWater();
+
+protected:
+  APRS_AX25Frame receiveFrame;  // 接收槽位
+  APRS_AX25Frame heldFrame;     // 最近一次pop()返回的帧
+  alignas(FRAME_QUEUE_ALIGN) uint8_t storage[FRAME_QUEUE_BYTES];   // 排队帧（环形，帧不跨越末尾）
+  uint16_t entryPos[FRAME_QUEUE_DEPTH];      // 队列中各帧在storage中的位置（先进先出）
+  uint8_t entryTag[FRAME_QUEUE_DEPTH];       // 各帧的标签
+  uint8_t head;                 // 队首在entryPos中的位置
+  uint8_t numQueued;            // 队列中的帧数
+  uint16_t writePos;            // 下一帧的写入位置
+  uint8_t policy;               // 丢弃策略
+  
+  uint32_t dropped;             // 丢弃的帧数
+  uint8_t highWater;            // 最大队列长度
+  
+  /**
+   * 为一帧分配存储（队列未满时）
+   * @param size 帧占用的字节数
+   * @return 存储位置，空间不足时返回-1
+   */
+  int32_t allocEntry(uint16_t size);
+  
+  /**
+   * 丢弃队首帧
+   */
+  void dropHead();
+};
+
+#endif // FRAME_QUEUE_H
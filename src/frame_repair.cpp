@@ -0,0 +1,270 @@
+/**
+ * 软判决比特修复实现
+ */
+
+#include "frame_repair.h"
+#include <string.h>
+
+#define HISTORY_WORDS     (FIX_BITS_HISTORY_BITS / 32)
+
+// 起始标志可能跨越块边界：重新解帧时从帧起始块之前的若干比特开始
+#define FLAG_LOOKBACK     16
+
+// CRC-16-CCITT（反转多项式），与ax25_parser一致
+#define CRC_POLYNOMIAL    0x8408
+
+/**
+ * CRC寄存器输入一个0比特（用于把校正子向帧尾方向推移一位）
+ */
+static inline uint16_t crcShiftZero(uint16_t reg) {
+  return (reg & 1) ? (uint16_t)((reg >> 1) ^ CRC_POLYNOMIAL) : (uint16_t)(reg >> 1);
+}
+
+FrameRepair::FrameRepair() {
+  reset();
+}
+
+void FrameRepair::reset() {
+  memset(history, 0, sizeof(history));
+  bitCount = 0;
+  blockStart = 0;
+  blockConfidence = nullptr;
+  blockCount = 0;
+  frameStart = 0;
+  numCandidates = 0;
+  worstSlot = 0;
+  frameLength = 0;
+  targetSyndrome = 0;
+  nextSingle = pairFirst = pairSecond = 0;
+  attempts = 0;
+  abandoned = false;
+}
+
+uint8_t FrameRepair::getBit(uint32_t index) {
+  return (history[(index >> 5) & (HISTORY_WORDS - 1)] >> (index & 31)) & 1;
+}
+
+void FrameRepair::addCandidate(uint32_t index, uint16_t confidence) {
+  if (numCandidates < FIX_BITS_CANDIDATES) {
+    candidates[numCandidates].index = index;
+    candidates[numCandidates].confidence = confidence;
+    if (confidence >= candidates[worstSlot].confidence) {
+      worstSlot = numCandidates;
+    }
+    numCandidates++;
+    return;
+  }
+
+  if (confidence >= candidates[worstSlot].confidence) {
+    return;
+  }
+
+  // 替换置信度最高的候选，并重新查找最高者
+  candidates[worstSlot].index = index;
+  candidates[worstSlot].confidence = confidence;
+  for (uint8_t i = 0; i < FIX_BITS_CANDIDATES; i++) {
+    if (candidates[i].confidence > candidates[worstSlot].confidence) {
+      worstSlot = i;
+    }
+  }
+}
+
+void FrameRepair::addBits(const uint8_t* bits, const uint16_t* confidence, uint16_t count) {
+  blockStart = bitCount;
+  blockConfidence = confidence;
+  blockCount = count;
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t index = bitCount++;
+    uint32_t* word = &history[(index >> 5) & (HISTORY_WORDS - 1)];
+    uint32_t mask = 1u << (index & 31);
+    if (bits[i]) {
+      *word |= mask;
+    } else {
+      *word &= ~mask;
+    }
+    addCandidate(index, confidence[i]);
+  }
+}
+
+void FrameRepair::startFrame() {
+  frameStart = blockStart;
+  numCandidates = 0;
+  worstSlot = 0;
+
+  // 当前块中起始标志之前的比特也会被登记，重新解帧时它们不在帧内，自动排除
+  for (uint16_t i = 0; i < blockCount; i++) {
+    addCandidate(blockStart + i, blockConfidence[i]);
+  }
+}
+
+uint32_t FrameRepair::noFlip() const {
+  return frameStart - FLAG_LOOKBACK - 1;
+}
+
+bool FrameRepair::deframe(uint32_t flip0, uint32_t flip1, uint8_t* raw) {
+  HDLCDeframer deframer;
+  // 比特序号按2^32取模：bitCount回绕后起始位置仍正确（历史按低位索引）
+  uint32_t start = frameStart - FLAG_LOOKBACK;
+  int32_t dataPos = -1;                   // 帧内数据位计数，-1表示不在帧内
+  int32_t frameBits = (int32_t)frameLength * 8;
+  uint16_t event;
+
+  // 以起始位置之前的比特建立NRZI电平
+  deframer.processBit(getBit(start - 1), &event);
+
+  for (uint32_t index = start; index != bitCount; index++) {
+    uint8_t bit = getBit(index);
+    if (index == flip0 || index == flip1) {
+      bit ^= 1;
+    }
+
+    int8_t out = deframer.processBit(bit, &event);
+    int16_t pos = -1;                     // 本比特解码后的数据位位置
+
+    if (event == DEFRAMER_EVENT_FLAG) {
+      // 结束标志之前还有标志本身的6个比特（0和5个1）被计为数据位
+      if (dataPos >= 0 && (dataPos >> 3) == frameLength) {
+        return true;
+      }
+      dataPos = 0;
+      if (raw == nullptr) {
+        for (uint8_t i = 0; i < numCandidates; i++) {
+          candidates[i].dataPos = -1;
+        }
+      }
+      continue;
+    }
+
+    if (event == DEFRAMER_EVENT_ABORT) {
+      dataPos = -1;
+    } else if (out >= 0 && dataPos >= 0) {
+      if (dataPos >= frameBits + 8) {
+        return false;                     // 帧比预期长
+      }
+      pos = (int16_t)dataPos++;
+      if (raw != nullptr && pos < frameBits) {
+        uint8_t mask = (uint8_t)(1 << (pos & 7));
+        if (out) {
+          raw[pos >> 3] |= mask;
+        } else {
+          raw[pos >> 3] &= ~mask;
+        }
+      }
+    }
+
+    // 翻转原始比特r会翻转解码后的数据位r和r+1：
+    // 只有r+1紧接着产生下一个数据位（中间没有填充位）时候选才可用
+    if (raw == nullptr) {
+      for (uint8_t i = 0; i < numCandidates; i++) {
+        RepairCandidate* c = &candidates[i];
+        if (c->index == index) {
+          c->dataPos = pos;
+        } else if (c->index + 1 == index && c->dataPos >= 0 && pos != c->dataPos + 1) {
+          c->dataPos = -1;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+bool FrameRepair::prepare(uint16_t length, uint16_t syndrome) {
+  frameLength = length;
+  targetSyndrome = syndrome;
+  nextSingle = 0;
+  pairFirst = 0;
+  pairSecond = 1;
+  attempts = 0;
+  abandoned = false;
+
+  // 帧起始（连同之前的标志）必须仍在历史范围内：距离按取模运算，bitCount回绕后同样成立；
+  // 解码器启动后不足FLAG_LOOKBACK个比特时，之前的位置是清零的历史
+  if (bitCount - frameStart + FLAG_LOOKBACK + 1 > FIX_BITS_HISTORY_BITS) {
+    numCandidates = 0;
+    return false;
+  }
+
+  for (uint8_t i = 0; i < numCandidates; i++) {
+    candidates[i].dataPos = -1;
+  }
+  if (!deframe(noFlip(), noFlip(), nullptr)) {
+    numCandidates = 0;
+    return false;
+  }
+
+  // 只保留两个受影响的数据位都在帧内（不含结束标志）的候选
+  int16_t frameBits = (int16_t)(length * 8);
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < numCandidates; i++) {
+    int16_t pos = candidates[i].dataPos;
+    if (pos >= 0 && pos + 1 < frameBits) {
+      candidates[count++] = candidates[i];
+    }
+  }
+  numCandidates = count;
+
+  // 按距帧尾的距离从近到远排序，逐位推移CRC寄存器计算各候选的校正子
+  for (uint8_t i = 1; i < numCandidates; i++) {
+    RepairCandidate c = candidates[i];
+    int8_t j = i - 1;
+    while (j >= 0 && candidates[j].dataPos < c.dataPos) {
+      candidates[j + 1] = candidates[j];
+      j--;
+    }
+    candidates[j + 1] = c;
+  }
+
+  // 数据位p被翻转对最终CRC寄存器的影响：距帧尾d = frameBits-1-p 位，
+  // 即多项式位在之后的d个比特中逐位推移
+  uint16_t reg = CRC_POLYNOMIAL;
+  int16_t distance = 0;
+  for (uint8_t i = 0; i < numCandidates; i++) {
+    int16_t target = frameBits - 2 - candidates[i].dataPos;   // 数据位p+1的距离
+    while (distance < target) {
+      reg = crcShiftZero(reg);
+      distance++;
+    }
+    candidates[i].syndrome = reg ^ crcShiftZero(reg);
+  }
+
+  return numCandidates > 0;
+}
+
+bool FrameRepair::tryFlip(uint32_t flip0, uint32_t flip1, uint8_t* raw) {
+  if (attempts >= FIX_BITS_MAX_ATTEMPTS) {
+    abandoned = true;
+    return false;
+  }
+  attempts++;
+  return deframe(flip0, flip1, raw);
+}
+
+uint8_t FrameRepair::next(uint8_t* raw) {
+  // 单比特翻转
+  while (nextSingle < numCandidates && !abandoned) {
+    RepairCandidate* c = &candidates[nextSingle++];
+    if (c->syndrome == targetSyndrome && tryFlip(c->index, noFlip(), raw)) {
+      return 1;
+    }
+  }
+
+#if FIX_BITS_MAX_FLIPS >= 2
+  // 两比特翻转
+  while (pairFirst + 1 < numCandidates && !abandoned) {
+    if (pairSecond >= numCandidates) {
+      pairFirst++;
+      pairSecond = pairFirst + 1;
+      continue;
+    }
+    RepairCandidate* a = &candidates[pairFirst];
+    RepairCandidate* b = &candidates[pairSecond++];
+    if ((a->syndrome ^ b->syndrome) == targetSyndrome && tryFlip(a->index, b->index, raw)) {
+      return 2;
+    }
+  }
+#endif
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * 软判决比特修复（CRC错误帧的翻转重试）
+ *
+ * 解调器为每个比特给出置信度（Mark/Space能量差）。接收过程中记录原始比特历史
+ * 和当前帧中置信度最低的FIX_BITS_CANDIDATES个比特；帧CRC错误时依次尝试
+ * 翻转其中1个或2个比特：
+ *
+ * - 翻转一个原始（NRZI编码）比特相当于翻转相邻的两个数据位。CRC是线性的，
+ *   翻转数据位对CRC余数的影响（校正子）只取决于该位到帧尾的距离，
+ *   因此每个候选比特的校正子只需计算一次，每种组合只需一次异或比较
+ * - 校正子与帧的CRC校正子相等时，才将翻转后的原始比特重新解帧（含去填充）
+ *   写入帧缓冲区，由解码器重新校验CRC
+ *
+ * 每次修复的开销：一次帧长的逐比特解帧（定位候选）、一次帧长的CRC移位（计算校正子）、
+ * 至多 K + K(K-1)/2 次异或比较（K = FIX_BITS_CANDIDATES，翻转2比特时），
+ * 以及对校正子匹配的组合各一次重新解帧（通常为0或1次，至多FIX_BITS_MAX_ATTEMPTS次，
+ * 超出时放弃该帧，最坏情况的修复时间有上限）。
+ */
+
+#ifndef FRAME_REPAIR_H
+#define FRAME_REPAIR_H
+
+#include "aprs_config.h"
+#include "hdlc_deframer.h"
+#include <stdint.h>
+
+// 原始比特历史容量（比特），必须为2的幂，且大于最长帧去填充前的比特数
+#ifndef FIX_BITS_HISTORY_BITS
+  #define FIX_BITS_HISTORY_BITS   4096
+#endif
+
+#if (FIX_BITS_HISTORY_BITS & (FIX_BITS_HISTORY_BITS - 1)) != 0
+  #error "FIX_BITS_HISTORY_BITS必须为2的幂"
+#endif
+
+#if FIX_BITS_CANDIDATES < 1 || FIX_BITS_CANDIDATES > 16
+  #error "FIX_BITS_CANDIDATES必须在1-16之间"
+#endif
+
+#if FIX_BITS_MAX_ATTEMPTS < 1 || FIX_BITS_MAX_ATTEMPTS > 255
+  #error "FIX_BITS_MAX_ATTEMPTS必须在1-255之间"
+#endif
+
+// 修复候选比特
+typedef struct {
+  uint32_t index;         // 原始比特序号
+  uint16_t confidence;    // 置信度
+  int16_t dataPos;        // 该比特解码后在帧中的数据位位置（-1表示不是帧内数据位）
+  uint16_t syndrome;      // 翻转该比特对CRC余数的影响
+} RepairCandidate;
+
+class FrameRepair {
+public:
+  FrameRepair();
+
+  /**
+   * 清空比特历史和候选
+   */
+  void reset();
+
+  /**
+   * 记录一块原始比特（解帧之前调用）
+   * 比特和置信度数组须在本块的解帧和状态机处理结束前保持有效
+   * @param bits 比特数组
+   * @param confidence 置信度数组
+   * @param count 比特数量
+   */
+  void addBits(const uint8_t* bits, const uint16_t* confidence, uint16_t count);
+
+  /**
+   * 帧起始（检测到起始标志时调用）
+   * 清空候选并重新登记当前块的比特，帧从当前块开始
+   */
+  void startFrame();
+
+  /**
+   * 准备修复CRC错误的帧：重新解帧定位候选比特并计算各自的校正子
+   * @param length 帧长度（含FCS）
+   * @param syndrome 帧的CRC校正子
+   * @return 存在可用的候选比特时返回true
+   */
+  bool prepare(uint16_t length, uint16_t syndrome);
+
+  /**
+   * 尝试下一种校正子匹配的翻转组合
+   * 找到时将翻转后重新解帧的数据写入raw（长度为prepare时的帧长度）
+   * @param raw 帧缓冲区
+   * @return 翻转的比特数，没有更多组合或重新解帧次数用尽时返回0
+   */
+  uint8_t next(uint8_t* raw);
+
+  /**
+   * 本帧是否因重新解帧次数达到FIX_BITS_MAX_ATTEMPTS而放弃了剩余的组合
+   */
+  bool isAbandoned() const {
+    return abandoned;
+  }
+
+protected:
+  uint32_t history[FIX_BITS_HISTORY_BITS / 32];   // 原始比特历史
+  uint32_t bitCount;            // 已记录的比特总数
+  uint32_t blockStart;          // 当前块第一个比特的序号
+  const uint16_t* blockConfidence;
+  uint16_t blockCount;
+  uint32_t frameStart;          // 帧起始标志所在块的第一个比特序号
+
+  RepairCandidate candidates[FIX_BITS_CANDIDATES];
+  uint8_t numCandidates;
+  uint8_t worstSlot;            // 置信度最高（最先被替换）的候选
+
+  uint16_t frameLength;
+  uint16_t targetSyndrome;
+  uint8_t nextSingle;           // 枚举位置：单比特翻转
+  uint8_t pairFirst;            // 枚举位置：两比特翻转
+  uint8_t pairSecond;
+  uint8_t attempts;             // 本帧已重新解帧的次数
+  bool abandoned;               // 重新解帧次数用尽
+
+  /**
+   * 登记一个比特，保留置信度最低的候选
+   */
+  void addCandidate(uint32_t index, uint16_t confidence);
+
+  /**
+   * 读取历史中的比特
+   */
+  uint8_t getBit(uint32_t index);
+
+  /**
+   * 从帧起始重新解帧
+   * @param flip0 翻转的原始比特序号（noFlip()表示不翻转）
+   * @param flip1 第二个翻转的原始比特序号
+   * @param raw 数据输出缓冲区，nullptr表示只定位候选比特
+   * @return 在帧长度处遇到结束标志时返回true
+   */
+  bool deframe(uint32_t flip0, uint32_t flip1, uint8_t* raw);
+
+  /**
+   * 表示不翻转的比特序号：重新解帧起点之前的一个比特，解帧循环不会访问
+   * （比特序号会回绕，不能用固定的无效值）
+   */
+  uint32_t noFlip() const;
+
+  /**
+   * 校正子匹配的组合：在重新解帧次数内重新解帧
+   * @return 重新解帧成功时返回true；次数用尽时置abandoned并返回false
+   */
+  bool tryFlip(uint32_t flip0, uint32_t flip1, uint8_t* raw);
+};
+
+#endif // FRAME_REPAIR_H
@@ -0,0 +1,128 @@
+/**
+ * G3RUH/K9NG 9600波特加扰FSK解调器实现
+ */
+
+#include "g3ruh_demod.h"
+#include "afsk_packed.h"
+
+// 表决窗口掩码
+#define VOTE_MASK   ((1u << G3RUH_VOTE_SAMPLES) - 1)
+
+/**
+ * 时钟恢复（每个采样调用一次）
+ * 输入跳变应位于相位offset附近，跳变时把相位拉向offset；
+ * 相位由正溢出到负时为判决时刻
+ * @param hist 采样历史（已移入当前采样）
+ * @param clock 时钟相位（输入输出）
+ * @return 应进行判决时返回true
+ */
+static inline bool clockSample(uint32_t hist, uint32_t& clock, uint32_t step, uint32_t offset) {
+  if ((hist ^ (hist >> 1)) & 1) {
+    int32_t p = (int32_t)(clock - offset);
+    uint32_t adjusted = (uint32_t)(p - (p >> G3RUH_CLOCK_INERTIA_SHIFT)) + offset;
+    // 调整不得越过判决点（符号改变），否则会重复判决或漏判
+    if ((int32_t)(adjusted ^ clock) >= 0) {
+      clock = adjusted;
+    }
+  }
+  uint32_t prev = clock;
+  clock += step;
+  return (int32_t)prev >= 0 && (int32_t)clock < 0;
+}
+
+G3RUHDemodulator::G3RUHDemodulator() : AFSKDemodulator() {
+  clockStep = 0;
+  clockOffset = 0;
+  reset();
+}
+
+bool G3RUHDemodulator::begin() {
+  AFSKDemodulator::begin();
+
+  // 时钟步进 = baud / sampleRate * 2^32
+  clockStep = (uint32_t)(((uint64_t)G3RUH_BAUD_RATE << 32) / G3RUH_SAMPLE_RATE);
+
+  // 跳变采样平均位于比特边界后半个采样；判决采样位于其后
+  // (每比特采样数 + 表决采样数 - 1) / 2 个采样处时，表决窗口以比特中点为中心
+  clockOffset = 0u - clockStep * (G3RUH_VOTE_SAMPLES - 1) / 2;
+
+  reset();
+  return true;
+}
+
+void G3RUHDemodulator::reset() {
+  AFSKDemodulator::reset();
+  history = 0;
+  clockPhase = 0;
+  descrambler = 0;
+}
+
+inline uint8_t G3RUHDemodulator::decide(uint32_t hist) {
+  // 多数表决
+  uint32_t votes = popcount32(hist & VOTE_MASK);
+  uint8_t level = (votes * 2 > G3RUH_VOTE_SAMPLES) ? 1 : 0;
+
+  // 解扰
+  uint32_t reg = (descrambler << 1) | level;
+  descrambler = reg;
+  uint8_t bit = (uint8_t)((reg ^ (reg >> G3RUH_TAP_A) ^ (reg >> G3RUH_TAP_B)) & 1);
+
+  updateDecision(bit, (uint16_t)(votes * G3RUH_VOTE_SCALE),
+                 (uint16_t)((G3RUH_VOTE_SAMPLES - votes) * G3RUH_VOTE_SCALE));
+  return bit;
+}
+
+bool G3RUHDemodulator::processSample(uint8_t sample) {
+  uint8_t bit;
+  return processSamples(&sample, 1, &bit) > 0;
+}
+
+uint16_t G3RUHDemodulator::processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) {
+  uint32_t hist = history;
+  uint32_t clock = clockPhase;
+  const uint32_t step = clockStep, offset = clockOffset;
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK(count);
+  uint16_t numBits = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    hist = (hist << 1) | (samples[i] ? 1 : 0);
+    if (clockSample(hist, clock, step, offset) && numBits < maxBits) {
+      bits[numBits++] = decide(hist);
+    }
+  }
+
+  history = hist;
+  clockPhase = clock;
+  return numBits;
+}
+
+uint16_t G3RUHDemodulator::processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) {
+  uint32_t hist = history;
+  uint32_t clock = clockPhase;
+  const uint32_t step = clockStep, offset = clockOffset;
+  const uint16_t maxBits = AFSK_MAX_BITS_PER_BLOCK((uint32_t)count * 32);
+  uint16_t numBits = 0;
+
+  for (uint16_t i = 0; i < count; i++) {
+    uint32_t word = words[i];
+    // 最早的采样在最高位
+    for (int8_t b = 31; b >= 0; b--) {
+      hist = (hist << 1) | ((word >> b) & 1);
+      if (clockSample(hist, clock, step, offset) && numBits < maxBits) {
+        bits[numBits++] = decide(hist);
+      }
+    }
+  }
+
+  history = hist;
+  clockPhase = clock;
+  return numBits;
+}
+
+uint32_t G3RUHDemodulator::getSampleRate() {
+  return G3RUH_SAMPLE_RATE;
+}
+
+uint32_t G3RUHDemodulator::getTransitionRate() {
+  return G3RUH_BAUD_RATE;
+}
@@ -0,0 +1,102 @@
+/**
+ * G3RUH/K9NG 9600波特加扰FSK解调器
+ *
+ * 9600波特数据包不使用音频副载波：FM鉴频输出直接是基带NRZ信号，
+ * SX127x在FSK直接模式下由DIO2输出限幅后的1比特基带采样。
+ * 发送端依次进行NRZI编码和自同步加扰（多项式 1 + x^12 + x^17），接收处理为：
+ * - 比特同步：相位累加器时钟，在输入跳变处把相位拉向比特边界
+ * - 判决：以比特中点为中心的G3RUH_VOTE_SAMPLES个采样多数表决（积分判决）
+ * - 解扰：17级移位寄存器，out = in ^ in[-12] ^ in[-17]
+ * 解扰后的比特（仍为NRZI电平）送入与1200波特相同的HDLC解帧器和AX.25解析器。
+ *
+ * 没有滤波和查表，每个采样只有移位、加法和比较，每个比特一次popcount；
+ * 位压缩采样直接按字处理，不解包为字节。
+ * 1比特基带信号没有可用于载波检测的能量，表决票数作为Mark/Space能量上报，
+ * 载波检测总是成立（与相关解调器在噪声中的行为相同），由帧标志完成同步。
+ * 一个判决错误经解扰后成为3个比特错误，比特修复（FIX_BITS）对本模式作用有限。
+ */
+
+#ifndef G3RUH_DEMOD_H
+#define G3RUH_DEMOD_H
+
+#include "afsk_demod.h"
+
+// 判决表决的采样数（奇数，去掉最靠近比特边界的采样，边界附近的判决最容易受噪声和码间干扰影响）
+#define G3RUH_VOTE_SAMPLES        ((G3RUH_SAMPLES_PER_BIT - 1) | 1)
+
+// 时钟恢复：检测到跳变时将相位拉向比特边界的比例 (1 - 1/8)
+// 加扰后跳变密集，比AFSK相关解调器的时钟更平滑也能保持同步
+#define G3RUH_CLOCK_INERTIA_SHIFT 3
+
+// 表决票数换算为能量的比例（使总能量高于CARRIER_DETECT_THR）
+#define G3RUH_VOTE_SCALE          4
+
+// 解扰多项式抽头 (1 + x^12 + x^17)
+#define G3RUH_TAP_A               12
+#define G3RUH_TAP_B               17
+
+#if G3RUH_SAMPLES_PER_BIT < 8 || G3RUH_SAMPLES_PER_BIT > 32
+  #error "G3RUH_SAMPLES_PER_BIT必须在8-32之间（见AFSK_MAX_BITS_PER_BLOCK）"
+#endif
+static_assert(G3RUH_CLOCK_INERTIA_SHIFT >= 2, "时钟调整过大，输出比特数可能超过AFSK_MAX_BITS_PER_BLOCK");
+
+class G3RUHDemodulator : public AFSKDemodulator {
+public:
+  G3RUHDemodulator();
+
+  /**
+   * 初始化解调器（计算时钟步进和判决时刻）
+   */
+  bool begin() override;
+
+  /**
+   * 处理单个采样点
+   */
+  bool processSample(uint8_t sample) override;
+
+  /**
+   * 批量处理采样
+   */
+  uint16_t processSamples(const uint8_t* samples, uint16_t count, uint8_t* bits) override;
+
+  /**
+   * 批量处理位压缩采样（直接在字上处理）
+   */
+  uint16_t processPackedSamples(const uint32_t* words, uint16_t count, uint8_t* bits) override;
+
+  /**
+   * 重置解调器状态
+   */
+  void reset() override;
+
+  /**
+   * 解调器的采样率
+   */
+  uint32_t getSampleRate() override;
+
+  /**
+   * 信号的最大跳变率（基带NRZ每比特最多一次跳变）
+   */
+  uint32_t getTransitionRate() override;
+
+protected:
+  // 采样历史（bit0为最新采样）
+  uint32_t history;
+
+  // 时钟恢复：相位从正溢出到负时判决，跳变应出现在相位clockOffset附近
+  uint32_t clockPhase;
+  uint32_t clockStep;
+  uint32_t clockOffset;
+
+  // 解扰移位寄存器（bit0为最新的接收比特）
+  uint32_t descrambler;
+
+  /**
+   * 表决、解扰并输出一个比特
+   * @param hist 采样历史
+   * @return 解扰后的比特
+   */
+  inline uint8_t decide(uint32_t hist);
+};
+
+#endif // G3RUH_DEMOD_H
@@ -0,0 +1,199 @@
+/**
+ * 查表HDLC解帧器实现
+ */
+
+#include "hdlc_deframer.h"
+
+// 转移表项格式（uint16_t）
+// bit 0-3:   新状态
+// bit 4-7:   输出的数据位（LSB为最早的比特）
+// bit 8-9:   事件 (DEFRAMER_EVENT_FLAG / DEFRAMER_EVENT_ABORT)
+// bit 12-14: 输出的数据位数 (0-4)
+#define ENTRY_STATE(e)      ((e) & 0x0F)
+#define ENTRY_DATA(e)       (((e) >> 4) & 0x0F)
+#define ENTRY_EVENT(e)      ((e) & 0x0300)
+#define ENTRY_COUNT(e)      (((e) >> 12) & 0x07)
+
+#define STATE_LEVEL(s)      ((s) & 1)
+#define STATE_ONES(s)       ((s) >> 1)
+#define MAKE_STATE(lv, n)   (uint8_t)(((n) << 1) | (lv))
+#define ONES_ABORT          7
+
+// 半字节转移表：索引 = 状态 << 4 | 4个输入比特（bit0最早）
+static uint16_t nibbleTable[256];
+// 单比特转移表：索引 = 状态 << 1 | 输入比特
+static uint16_t bitTable[32];
+static bool tablesReady = false;
+
+/**
+ * 单个比特的状态转移
+ * @param state 当前状态（更新为新状态）
+ * @param bit 输入比特（NRZI编码）
+ * @param event 输出：事件，无事件时不修改
+ * @return 输出的数据位 (0/1)，无数据位时返回-1
+ */
+static int8_t stepBit(uint8_t* state, uint8_t bit, uint16_t* event) {
+  uint8_t ones = STATE_ONES(*state);
+  uint8_t decoded = (bit == STATE_LEVEL(*state)) ? 1 : 0;
+  int8_t out = -1;
+
+  if (decoded) {
+    if (ones < ONES_ABORT) {
+      ones++;
+    }
+    if (ones == ONES_ABORT) {
+      // 第7个1进入中止状态，之后的1不再重复报告
+      if (STATE_ONES(*state) != ONES_ABORT) {
+        *event = DEFRAMER_EVENT_ABORT;
+      }
+    } else if (ones < 6) {
+      // 第6个1只可能属于标志或中止序列，不作为数据位
+      out = 1;
+    }
+  } else {
+    if (ones == 6) {
+      *event = DEFRAMER_EVENT_FLAG;
+    } else if (ones < 5) {
+      out = 0;
+    }
+    // ones == 5：填充位；ones == 7：中止结束，均不输出
+    ones = 0;
+  }
+
+  *state = MAKE_STATE(bit, ones);
+  return out;
+}
+
+void HDLCDeframer::buildTables() {
+  if (tablesReady) {
+    return;
+  }
+
+  for (uint8_t s = 0; s < 16; s++) {
+    // 半字节表
+    for (uint8_t nibble = 0; nibble < 16; nibble++) {
+      uint8_t st = s;
+      uint16_t event = 0;
+      uint8_t data = 0, count = 0;
+
+      for (uint8_t k = 0; k < 4; k++) {
+        uint16_t ev = 0;
+        int8_t out = stepBit(&st, (nibble >> k) & 1, &ev);
+        if (ev) {
+          // 事件之前的数据位属于标志/中止序列，丢弃
+          event = ev;
+          data = 0;
+          count = 0;
+        }
+        if (out >= 0) {
+          data |= (uint8_t)out << count;
+          count++;
+        }
+      }
+      nibbleTable[(s << 4) | nibble] =
+          (uint16_t)(st | (data << 4) | event | (count << 12));
+    }
+
+    // 单比特表
+    for (uint8_t bit = 0; bit < 2; bit++) {
+      uint8_t st = s;
+      uint16_t event = 0;
+      int8_t out = stepBit(&st, bit, &event);
+      bitTable[(s << 1) | bit] = (out >= 0)
+          ? (uint16_t)(st | (out << 4) | event | (1 << 12))
+          : (uint16_t)(st | event);
+    }
+  }
+
+  tablesReady = true;
+}
+
+// 转移表在静态初始化阶段生成（早于main()和任何线程），之后只读，
+// 多个解码器实例可在不同线程中并发使用
+static struct DeframerTableInit {
+  DeframerTableInit() {
+    HDLCDeframer::buildTables();
+  }
+} deframerTableInit;
+
+HDLCDeframer::HDLCDeframer() {
+  buildTables();
+  reset();
+}
+
+void HDLCDeframer::begin() {
+  buildTables();
+  reset();
+}
+
+void HDLCDeframer::reset() {
+  state = 0;
+  rxBits = 0;
+  rxBitCount = 0;
+}
+
+int8_t HDLCDeframer::processBit(uint8_t bit, uint16_t* event) {
+  uint16_t e = bitTable[(state << 1) | bit];
+  state = ENTRY_STATE(e);
+  *event = ENTRY_EVENT(e);
+  return ENTRY_COUNT(e) ? (int8_t)ENTRY_DATA(e) : -1;
+}
+
+uint16_t HDLCDeframer::processBits(const uint8_t* bits, uint16_t count, uint16_t* events) {
+  // 将状态载入局部变量
+  uint8_t st = state;
+  uint16_t acc = rxBits;
+  uint8_t accCount = rxBitCount;
+  uint16_t numEvents = 0;
+  uint16_t i = 0;
+
+  // 每个半字节至多产生一个事件和一个字节（事件会清空未完成的字节）
+  for (; i + 4 <= count; i += 4) {
+    uint8_t nibble = (uint8_t)(bits[i] | (bits[i + 1] << 1) |
+                               (bits[i + 2] << 2) | (bits[i + 3] << 3));
+    uint16_t e = nibbleTable[(st << 4) | nibble];
+    st = ENTRY_STATE(e);
+
+    if (ENTRY_EVENT(e)) {
+      events[numEvents++] = ENTRY_EVENT(e);
+      acc = 0;
+      accCount = 0;
+    }
+
+    // AX.25使用LSB优先
+    acc |= (uint16_t)ENTRY_DATA(e) << accCount;
+    accCount += ENTRY_COUNT(e);
+    if (accCount >= 8) {
+      events[numEvents++] = acc & 0xFF;
+      acc >>= 8;
+      accCount -= 8;
+    }
+  }
+
+  // 剩余不足4个的比特
+  for (; i < count; i++) {
+    uint16_t e = bitTable[(st << 1) | bits[i]];
+    st = ENTRY_STATE(e);
+
+    if (ENTRY_EVENT(e)) {
+      events[numEvents++] = ENTRY_EVENT(e);
+      acc = 0;
+      accCount = 0;
+    }
+
+    acc |= (uint16_t)ENTRY_DATA(e) << accCount;
+    accCount += ENTRY_COUNT(e);
+    if (accCount >= 8) {
+      events[numEvents++] = acc & 0xFF;
+      acc >>= 8;
+      accCount -= 8;
+    }
+  }
+
+  // 写回状态
+  state = st;
+  rxBits = acc;
+  rxBitCount = accCount;
+
+  return numEvents;
+}
@@ -0,0 +1,74 @@
+/**
+ * 查表HDLC解帧器（NRZI解码 + 比特去填充 + 帧标志/中止检测）
+ *
+ * NRZI (Non-Return-to-Zero Inverted):
+ * - 没有跳变 = 1
+ * - 有跳变 = 0
+ *
+ * 比特填充移除：
+ * - 在连续5个1后面插入的0需要被移除
+ *
+ * 解帧状态只有NRZI电平（1位）和连续1的计数（0-7，7表示中止），共16个状态。
+ * 启动时预先计算"状态 × 4个输入比特"的转移表，每次查表同时完成
+ * 4个比特的NRZI解码、去填充和标志检测，输出去填充后的数据位：
+ * - 帧标志按连续1计数检测（0后接6个1再接0），与字节边界无关
+ * - 连续7个及以上的1为中止序列，输出中止事件
+ * - 一个半字节内至多出现一个事件，事件之前的数据位属于标志/中止本身，被丢弃
+ */
+
+#ifndef HDLC_DEFRAMER_H
+#define HDLC_DEFRAMER_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+
+// 解帧事件编码（批量接口输出）
+// 低8位为数据字节；帧标志等事件使用高位表示
+#define DEFRAMER_EVENT_FLAG   0x100   // 检测到帧标志 (0x7E)
+#define DEFRAMER_EVENT_ABORT  0x200   // 检测到中止序列（连续7个以上的1）
+#define DEFRAMER_IS_EVENT(e)  ((e) & 0xFF00)
+
+class HDLCDeframer {
+public:
+  HDLCDeframer();
+
+  /**
+   * 初始化解帧器（首次调用时生成转移表，所有实例共用）
+   */
+  void begin();
+
+  /**
+   * 批量处理比特
+   * 按每次4比特查表，不足4比特的部分逐比特查表；解帧状态跨调用保持
+   * @param bits 输入比特数组（每字节一个比特，0或1）
+   * @param count 比特数量
+   * @param events 输出事件数组（数据字节或DEFRAMER_EVENT_*），容量至少为count
+   * @return 输出的事件数
+   */
+  uint16_t processBits(const uint8_t* bits, uint16_t count, uint16_t* events);
+
+  /**
+   * 处理单个比特（逐比特查表，供比特修复时重新解帧使用）
+   * @param bit 输入比特
+   * @param event 输出：事件，无事件时为0
+   * @return 去填充后的数据位 (0/1)，该比特不产生数据位时返回-1
+   */
+  int8_t processBit(uint8_t bit, uint16_t* event);
+
+  /**
+   * 重置解帧器
+   */
+  void reset();
+
+  /**
+   * 生成转移表（静态初始化时已自动调用，重复调用无操作）
+   */
+  static void buildTables();
+
+protected:
+  uint8_t state;            // 解帧状态：bit0为NRZI电平，bit1-3为连续1的计数
+  uint16_t rxBits;          // 已去填充、尚未组成字节的数据位（LSB优先）
+  uint8_t rxBitCount;       // rxBits中的位数 (0-7)
+};
+
+#endif // HDLC_DEFRAMER_H
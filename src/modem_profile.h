@@ -0,0 +1,61 @@
+/**
+ * 编译期调制配置
+ *
+ * aprs_config.h中的采样率、波特率和音调频率是全局宏，整个程序只能有一种配置。
+ * ModemProfile把这些参数作为模板参数，所有派生量（相位步进、时钟步进、
+ * 窗口长度）都是编译期常量：以配置为模板参数的解调器（afsk_profile_demod.h）
+ * 在热路径上没有除法，也不需要从成员变量读取这些参数，
+ * 且同一个程序中可以同时实例化多种配置（例如26.4kHz和13.2kHz两路输入，或VHF与HF）。
+ *
+ * 配置在编译期检查：采样率须为波特率的整数倍，每比特采样数在
+ * [MODEM_PROFILE_MIN_SPB, MODEM_PROFILE_MAX_SPB]内，音调频率低于奈奎斯特频率。
+ */
+
+#ifndef MODEM_PROFILE_H
+#define MODEM_PROFILE_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+
+// 每比特采样数下限：保证批量解调的输出比特数不超过AFSK_MAX_BITS_PER_BLOCK
+#define MODEM_PROFILE_MIN_SPB   8
+
+// 每比特采样数上限：相关窗口的采样历史保存在64位移位寄存器中
+#define MODEM_PROFILE_MAX_SPB   64
+
+template <uint32_t SampleRate, uint16_t BaudRate, uint16_t MarkFreq, uint16_t SpaceFreq>
+struct ModemProfile {
+  static constexpr uint32_t sampleRate = SampleRate;
+  static constexpr uint16_t baudRate = BaudRate;
+  static constexpr uint16_t markFreq = MarkFreq;
+  static constexpr uint16_t spaceFreq = SpaceFreq;
+
+  // 每比特采样数，也是相关窗口长度
+  static constexpr uint8_t samplesPerBit = (uint8_t)(SampleRate / BaudRate);
+  static constexpr uint8_t windowLen = samplesPerBit;
+
+  // 相位步进 = freq / sampleRate * 2^32
+  static constexpr uint32_t markStep = (uint32_t)(((uint64_t)MarkFreq << 32) / SampleRate);
+  static constexpr uint32_t spaceStep = (uint32_t)(((uint64_t)SpaceFreq << 32) / SampleRate);
+  static constexpr uint32_t clockStep = (uint32_t)(((uint64_t)BaudRate << 32) / SampleRate);
+
+  // 窗口起点相对当前相位的回退量（模2^32）
+  static constexpr uint32_t markWindowBack = (uint32_t)((uint64_t)markStep * samplesPerBit);
+  static constexpr uint32_t spaceWindowBack = (uint32_t)((uint64_t)spaceStep * samplesPerBit);
+
+  static_assert(BaudRate > 0 && SampleRate % BaudRate == 0, "采样率必须为波特率的整数倍");
+  static_assert(SampleRate / BaudRate >= MODEM_PROFILE_MIN_SPB, "每比特采样数过少");
+  static_assert(SampleRate / BaudRate <= MODEM_PROFILE_MAX_SPB, "每比特采样数超过相关窗口上限");
+  static_assert(2u * MarkFreq < SampleRate && 2u * SpaceFreq < SampleRate, "音调频率超过奈奎斯特频率");
+  static_assert(MarkFreq != SpaceFreq, "Mark和Space频率不能相同");
+};
+
+// 预定义配置
+typedef ModemProfile<26400, 1200, 2200, 1200> ModemProfile1200;       // Bell 202，26.4kHz（默认）
+typedef ModemProfile<13200, 1200, 2200, 1200> ModemProfile1200Half;   // Bell 202，13.2kHz（降低采样中断频率）
+typedef ModemProfile<9600, 300, 1600, 1800> ModemProfileHF300;        // HF 300波特（200Hz频移）
+
+// 与aprs_config.h一致的配置
+typedef ModemProfile<AFSK_SAMPLE_RATE, AFSK_BAUD_RATE, AFSK_MARK_FREQ, AFSK_SPACE_FREQ> ModemProfileDefault;
+
+#endif // MODEM_PROFILE_H
@@ -0,0 +1,129 @@
+/**
+ * 采样环形缓冲区（单生产者/单消费者，无锁）
+ *
+ * 采样中断只负责把位压缩采样字（见afsk_packed.h）写入环形缓冲区，
+ * 解调、解帧和AX.25解析全部在loop()中按块进行。
+ * 中断内的工作量固定为几条指令，帧结束时的较长处理不会再导致丢失采样时钟。
+ *
+ * - 生产者（中断）只写head，消费者（loop）只写tail，二者均为原子变量：
+ *   写入数据后以release顺序发布head，读取前以acquire顺序获取head
+ * - 缓冲区满时新数据被丢弃并计数，不会覆盖消费者正在读取的数据
+ * - 消费者可直接读取连续区域，无需拷贝
+ */
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+#include <atomic>
+
+// 环形缓冲区容量（字），必须为2的幂
+// 64字 = 2048个采样，26.4kHz下约77ms
+#ifndef SAMPLE_RING_WORDS
+  #define SAMPLE_RING_WORDS   64
+#endif
+
+#if (SAMPLE_RING_WORDS & (SAMPLE_RING_WORDS - 1)) != 0
+  #error "SAMPLE_RING_WORDS必须为2的幂"
+#endif
+
+class SampleRing {
+public:
+  SampleRing() {
+    reset();
+  }
+
+  /**
+   * 清空缓冲区和统计（不得与push/consume并发调用）
+   */
+  void reset() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    overflows = 0;
+    highWater = 0;
+  }
+
+  /**
+   * 写入一个采样字（生产者，中断上下文）
+   * @param word 32个采样，最早的采样在最高位
+   * @return 缓冲区已满时返回false，该字被丢弃
+   */
+  inline bool push(uint32_t word) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t used = (uint16_t)(h - tail.load(std::memory_order_acquire));
+
+    if (used >= SAMPLE_RING_WORDS) {
+      overflows++;
+      return false;
+    }
+
+    buffer[h & (SAMPLE_RING_WORDS - 1)] = word;
+    head.store((uint16_t)(h + 1), std::memory_order_release);
+
+    if (used + 1 > highWater) {
+      highWater = used + 1;
+    }
+    return true;
+  }
+
+  /**
+   * 获取可读的连续区域（消费者）
+   * 缓冲区回绕时只返回到缓冲区末尾的部分，消费后再次调用获取其余部分
+   * @param words 输出：指向第一个可读字
+   * @return 可读的字数
+   */
+  inline uint16_t peek(const uint32_t** words) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t avail = (uint16_t)(head.load(std::memory_order_acquire) - t);
+    uint16_t index = t & (SAMPLE_RING_WORDS - 1);
+
+    if (avail > SAMPLE_RING_WORDS - index) {
+      avail = SAMPLE_RING_WORDS - index;
+    }
+    *words = &buffer[index];
+    return avail;
+  }
+
+  /**
+   * 释放已处理的字（消费者）
+   * @param count 字数（不超过peek返回的数量）
+   */
+  inline void consume(uint16_t count) {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    tail.store((uint16_t)(t + count), std::memory_order_release);
+  }
+
+  /**
+   * 当前缓冲的字数
+   */
+  inline uint16_t available() {
+    return (uint16_t)(head.load(std::memory_order_acquire) -
+                      tail.load(std::memory_order_acquire));
+  }
+
+  /**
+   * 因缓冲区满而丢弃的字数
+   */
+  uint32_t getOverflows() {
+    return overflows;
+  }
+
+  /**
+   * 缓冲区占用的历史最大值（字）
+   */
+  uint16_t getHighWater() {
+    return highWater;
+  }
+
+protected:
+  uint32_t buffer[SAMPLE_RING_WORDS];
+  std::atomic<uint16_t> head;         // 下一个写入位置（仅生产者修改）
+  std::atomic<uint16_t> tail;         // 下一个读取位置（仅消费者修改）
+
+  // 统计（仅生产者修改，消费者读取32位对齐的值是原子的）
+  volatile uint32_t overflows;
+  volatile uint16_t highWater;
+};
+
+#endif // SAMPLE_RING_H
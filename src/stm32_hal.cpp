@@ -1,9 +1,13 @@
 /**
  * STM32硬件抽象层实现
+ *
+ * 主机构建中没有定时器和DMA（SamplingTimer/DMAManager的begin返回false），
+ * UARTOutput使用aprs_platform.h中的HardwareSerial替身，可以脱离硬件测试。
  */
 
 #include "stm32_hal.h"
 #include "ax25_parser.h"
+#include "aprs_format.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -21,7 +25,9 @@ HardwareTimer* SamplingTimer::selectTimer() {
   // 根据不同的STM32系列选择合适的Timer
   // 优先选择高精度Timer
   
-#if defined(TIM2)
+#if APRS_PLATFORM_HOST
+  return nullptr;                 // 主机构建没有定时器
+#elif defined(TIM2)
   return new HardwareTimer(TIM2);
 #elif defined(TIM3)
   return new HardwareTimer(TIM3);
@@ -41,6 +47,7 @@ bool SamplingTimer::begin(uint32_t frequency, void (*callback)(void)) {
     return false;
   }
   
+#if APRS_PLATFORM_ARDUINO
   // 配置Timer频率
   // 设置overflow频率为采样频率
   timer->setOverflow(frequency, HERTZ_FORMAT);
@@ -55,23 +62,33 @@ bool SamplingTimer::begin(uint32_t frequency, void (*callback)(void)) {
   
   DEBUG_PRINT("Sampling Timer initialized: ");
   DEBUG_PRINT(frequency);
-  DEBUG_PRINTLN(" Hz");
+  DEBUG_PRINT(" Hz (actual ");
+  // 高采样率（9600波特的76.8kHz）下分频比较小，实际频率与目标的偏差由时钟恢复吸收
+  DEBUG_PRINT(timer->getOverflow(HERTZ_FORMAT));
+  DEBUG_PRINTLN(" Hz)");
+#else
+  (void)frequency;
+#endif
   
   return true;
 }
 
 void SamplingTimer::start() {
+#if APRS_PLATFORM_ARDUINO
   if (timer != nullptr) {
     timer->resume();
     DEBUG_PRINTLN("Sampling Timer started");
   }
+#endif
 }
 
 void SamplingTimer::stop() {
+#if APRS_PLATFORM_ARDUINO
   if (timer != nullptr) {
     timer->pause();
     DEBUG_PRINTLN("Sampling Timer stopped");
   }
+#endif
 }
 
 uint32_t SamplingTimer::getSampleCount() {
@@ -86,55 +103,140 @@ void SamplingTimer::resetSampleCount() {
 // DMAManager 实现
 // ============================================================================
 
-DMAManager::DMAManager() {
-  dmaBuf1 = nullptr;
-  dmaBuf2 = nullptr;
+#if HAS_DMA_CAPTURE
+static DMA_HandleTypeDef captureDMA;
+
+// HAL在DMA中断中调用的回调（DMAManager为单例）
+static void captureHalfCallback(DMA_HandleTypeDef* hdma) {
+  (void)hdma;
+  dmaManager.handleHalfTransfer();
+}
+
+static void captureCompleteCallback(DMA_HandleTypeDef* hdma) {
+  (void)hdma;
+  dmaManager.handleTransferComplete();
+}
+
+extern "C" void DMA_CAPTURE_IRQHandler(void) {
+  HAL_DMA_IRQHandler(&captureDMA);
+}
+#endif
+
+DMAManager::DMAManager() : DMACapture() {
+  timer = nullptr;
+  sourceAddress = nullptr;
   bufSize = 0;
-  useBuffer1 = true;
-  transferCallback = nullptr;
+  running = false;
 }
 
-bool DMAManager::begin(uint8_t* buffer1, uint8_t* buffer2, uint16_t bufferSize, 
-                       void (*callback)(uint8_t* buffer, uint16_t size)) {
-  dmaBuf1 = buffer1;
-  dmaBuf2 = buffer2;
+bool DMAManager::begin(uint32_t sampleRate, uint32_t pin, uint8_t* buffer, uint16_t bufferSize,
+                       DMACaptureCallback callback) {
+#if HAS_DMA_CAPTURE
+  // 采样引脚所在端口的输入寄存器：DMA按字节读取，取引脚所在的字节
+  PinName pinName = digitalPinToPinName(pin);
+  if (pinName == NC) {
+    return false;
+  }
+  pinMode(pin, INPUT);
+  GPIO_TypeDef* port = get_GPIO_Port(STM_PORT(pinName));
+  uint8_t pinIndex = STM_PIN(pinName);
+  sourceAddress = (volatile uint8_t*)&port->IDR + pinIndex / 8;
+  
+  if (!attach(buffer, bufferSize, pinIndex % 8, callback)) {
+    return false;
+  }
   bufSize = bufferSize;
-  transferCallback = callback;
-  useBuffer1 = true;
   
-  // DMA配置将在实际的STM32环境中完成
-  // 这里提供框架
+  // 定时器：每个采样周期一次更新事件（不使能更新中断）
+  if (timer == nullptr) {
+    timer = new HardwareTimer(TIM1);
+  }
+  timer->setOverflow(sampleRate, HERTZ_FORMAT);
+  
+  // DMA：外设（GPIO输入寄存器）到内存，字节宽度，循环模式
+#if defined(STM32F4xx)
+  __HAL_RCC_DMA2_CLK_ENABLE();
+#elif defined(STM32G4xx)
+  __HAL_RCC_DMAMUX1_CLK_ENABLE();
+  __HAL_RCC_DMA1_CLK_ENABLE();
+#else
+  __HAL_RCC_DMA1_CLK_ENABLE();
+#endif
   
-  DEBUG_PRINTLN("DMA Manager initialized (双缓冲模式)");
+  captureDMA.Instance = DMA_CAPTURE_STREAM;
+#if defined(STM32F4xx)
+  captureDMA.Init.Channel = DMA_CAPTURE_REQUEST;
+  captureDMA.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+#else
+  captureDMA.Init.Request = DMA_CAPTURE_REQUEST;
+#endif
+  captureDMA.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  captureDMA.Init.PeriphInc = DMA_PINC_DISABLE;
+  captureDMA.Init.MemInc = DMA_MINC_ENABLE;
+  captureDMA.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  captureDMA.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  captureDMA.Init.Mode = DMA_CIRCULAR;
+  captureDMA.Init.Priority = DMA_PRIORITY_HIGH;
+  if (HAL_DMA_Init(&captureDMA) != HAL_OK) {
+    DEBUG_PRINTLN("DMA初始化失败");
+    return false;
+  }
+  captureDMA.XferHalfCpltCallback = captureHalfCallback;
+  captureDMA.XferCpltCallback = captureCompleteCallback;
+  
+  HAL_NVIC_SetPriority(DMA_CAPTURE_IRQn, DMA_CAPTURE_IRQ_PRIORITY, 0);
+  HAL_NVIC_EnableIRQ(DMA_CAPTURE_IRQn);
+  
+  DEBUG_PRINT("DMA采样初始化: ");
+  DEBUG_PRINT(sampleRate);
+  DEBUG_PRINT(" Hz (实际 ");
+  DEBUG_PRINT(timer->getOverflow(HERTZ_FORMAT));
+  DEBUG_PRINT(" Hz), 缓冲区 ");
+  DEBUG_PRINT(bufferSize);
+  DEBUG_PRINTLN(" 采样");
   
   return true;
+#else
+  (void)sampleRate; (void)pin; (void)buffer; (void)bufferSize; (void)callback;
+  DEBUG_PRINTLN("此MCU系列不支持DMA采样");
+  return false;
+#endif
 }
 
 void DMAManager::start() {
-  // 启动DMA传输
-  DEBUG_PRINTLN("DMA Transfer started");
+#if HAS_DMA_CAPTURE
+  if (timer == nullptr || running) {
+    return;
+  }
+  expectComplete = false;
+  HAL_DMA_Start_IT(&captureDMA, (uint32_t)sourceAddress, (uint32_t)captureBuffer, bufSize);
+  __HAL_TIM_ENABLE_DMA(timer->getHandle(), TIM_DMA_UPDATE);
+  timer->resume();
+  running = true;
+  DEBUG_PRINTLN("DMA采样已启动");
+#endif
 }
 
 void DMAManager::stop() {
-  // 停止DMA传输
-  DEBUG_PRINTLN("DMA Transfer stopped");
-}
-
-uint8_t* DMAManager::getActiveBuffer() {
-  return useBuffer1 ? dmaBuf1 : dmaBuf2;
+#if HAS_DMA_CAPTURE
+  if (!running) {
+    return;
+  }
+  timer->pause();
+  __HAL_TIM_DISABLE_DMA(timer->getHandle(), TIM_DMA_UPDATE);
+  HAL_DMA_Abort(&captureDMA);
+  running = false;
+  DEBUG_PRINTLN("DMA采样已停止");
+#endif
 }
 
-void DMAManager::handleInterrupt() {
-  // DMA传输完成中断
-  uint8_t* completedBuffer = useBuffer1 ? dmaBuf1 : dmaBuf2;
-  
-  // 切换缓冲区
-  useBuffer1 = !useBuffer1;
-  
-  // 调用回调处理完成的缓冲区
-  if (transferCallback != nullptr) {
-    transferCallback(completedBuffer, bufSize);
-  }
+uint16_t DMAManager::getWritePosition() {
+#if HAS_DMA_CAPTURE
+  // 计数器为剩余的传输次数
+  return (uint16_t)(bufSize - __HAL_DMA_GET_COUNTER(&captureDMA));
+#else
+  return 0;
+#endif
 }
 
 // ============================================================================
@@ -143,14 +245,13 @@ void DMAManager::handleInterrupt() {
 
 UARTOutput::UARTOutput() {
   uartPort = nullptr;
-  useDMATransfer = false;
-  txBufferPos = 0;
-  txBusy = false;
+  outputFormat = UART_OUTPUT_FORMAT;
+  kissPortNumber = KISS_PORT;
 }
 
-bool UARTOutput::begin(HardwareSerial& uart, uint32_t baudrate, bool useDMA) {
+bool UARTOutput::begin(HardwareSerial& uart, uint32_t baudrate) {
   uartPort = &uart;
-  useDMATransfer = useDMA;
+  txRing.reset();
   
   // 初始化UART
   uartPort->begin(baudrate);
@@ -162,85 +263,89 @@ bool UARTOutput::begin(HardwareSerial& uart, uint32_t baudrate, bool useDMA) {
   return true;
 }
 
-void UARTOutput::print(const char* str) {
-  if (uartPort != nullptr) {
-    uartPort->print(str);
-  }
+bool UARTOutput::print(const char* str) {
+  return write((const uint8_t*)str, (uint16_t)strlen(str));
 }
 
-void UARTOutput::println(const char* str) {
-  if (uartPort != nullptr) {
-    uartPort->println(str);
-  }
+bool UARTOutput::println(const char* str) {
+  static const uint8_t newline[2] = { '\r', '\n' };
+  
+  bool ok = txRing.write((const uint8_t*)str, (uint16_t)strlen(str), newline, sizeof(newline));
+  service();
+  return ok;
 }
 
-void UARTOutput::write(const uint8_t* data, uint16_t length) {
-  if (uartPort != nullptr) {
-    uartPort->write(data, length);
-  }
+bool UARTOutput::write(const uint8_t* data, uint16_t length) {
+  bool ok = txRing.write(data, length);
+  service();
+  return ok;
 }
 
-void UARTOutput::formatCallsign(char* output, APRS_AX25Address* addr) {
-  // 格式化呼号为 "CALL-SSID" 格式
-  int len = 0;
-  for (int i = 0; i < 7 && addr->callsign[i] != '\0'; i++) {
-    output[len++] = addr->callsign[i];
-  }
-  
-  if (addr->ssid > 0) {
-    output[len++] = '-';
-    if (addr->ssid >= 10) {
-      output[len++] = '0' + (addr->ssid / 10);
-    }
-    output[len++] = '0' + (addr->ssid % 10);
-  }
-  
-  output[len] = '\0';
+void UARTOutput::setOutputFormat(uint8_t format, uint8_t kissPort) {
+  outputFormat = format;
+  kissPortNumber = kissPort & 0x0F;
 }
 
-void UARTOutput::sendAPRSFrame(APRS_AX25Frame* frame) {
+uint8_t UARTOutput::getOutputFormat() {
+  return outputFormat;
+}
+
+bool UARTOutput::sendAPRSFrame(APRS_AX25Frame* frame) {
   if (uartPort == nullptr || frame == nullptr || !frame->valid) {
-    return;
+    return false;
   }
   
-  char buffer[512];
-  char srcCall[16], dstCall[16];
-  
-  // 格式化源和目标呼号
-  formatCallsign(srcCall, &frame->source);
-  formatCallsign(dstCall, &frame->destination);
+  if (outputFormat == UART_FORMAT_KISS) {
+    // FEND 命令字节 AX.25原始字节 FEND，不格式化呼号
+    uint16_t len = formatKISS(frame, kissPortNumber, lineBuffer, sizeof(lineBuffer));
+    return write(lineBuffer, len);
+  }
   
-  // 构建输出字符串
   // 格式: SOURCE>DESTINATION[,PATH]:INFO
-  int pos = 0;
-  pos += sprintf(buffer + pos, "%s>%s", srcCall, dstCall);
+  formatTNC2(frame, (char*)lineBuffer, sizeof(lineBuffer));
   
-  // 添加中继路径
-  for (uint8_t i = 0; i < frame->numDigipeaters; i++) {
-    char digiCall[16];
-    formatCallsign(digiCall, &frame->digipeaters[i]);
-    pos += sprintf(buffer + pos, ",%s", digiCall);
+  return println((const char*)lineBuffer);
+}
+
+void UARTOutput::service() {
+  if (uartPort == nullptr) {
+    return;
   }
   
-  // 添加信息字段
-  pos += sprintf(buffer + pos, ":");
-  for (uint16_t i = 0; i < frame->infoLen && pos < 500; i++) {
-    buffer[pos++] = frame->info[i];
+  // 只写入UART发送缓冲区的空闲部分，HardwareSerial::write不会等待
+  int room = uartPort->availableForWrite();
+  while (room > 0) {
+    const uint8_t* data;
+    uint16_t len = txRing.startBlock(&data, (uint16_t)room);
+    if (len == 0) {
+      break;
+    }
+    uartPort->write(data, len);
+    txRing.endBlock();
+    room -= len;
   }
-  buffer[pos] = '\0';
-  
-  // 发送
-  println(buffer);
 }
 
 bool UARTOutput::isBusy() {
-  return txBusy;
+  if (uartPort == nullptr) {
+    return false;
+  }
+  // UART发送缓冲区为空时availableForWrite()返回SERIAL_TX_BUFFER_SIZE - 1
+  return txRing.isBusy() || uartPort->availableForWrite() < SERIAL_TX_BUFFER_SIZE - 1;
 }
 
 void UARTOutput::flush() {
-  if (uartPort != nullptr) {
-    uartPort->flush();
+  if (uartPort == nullptr) {
+    return;
+  }
+  while (txRing.isBusy()) {
+    service();
   }
+  uartPort->flush();
+}
+
+UARTTxStatistics* UARTOutput::getStatistics() {
+  return txRing.getStatistics();
 }
 
 // ============================================================================
@@ -10,6 +10,9 @@
 
 #include "aprs_config.h"
 #include "ax25_parser.h"
+#include "aprs_format.h"
+#include "uart_tx_ring.h"
+#include "dma_capture.h"
 #include <stdint.h>
 
 // 检测STM32系列
@@ -27,8 +30,35 @@
   #define HAS_ADVANCED_TIMER 0
 #endif
 
-// 采样缓冲区（双缓冲）
-#define SAMPLE_DMA_BUFFER_SIZE  128
+// DMA采样使用的定时器和DMA通道（定时器更新事件触发DMA读取GPIO输入寄存器）
+// 定时器均为TIM1，与SamplingTimer（TIM2-4）不冲突
+#if defined(STM32F4xx)
+  // F4的DMA1外设端口只连接APB1，GPIO（AHB1）只能由DMA2访问：TIM1_UP = DMA2 Stream5 通道6
+  #define HAS_DMA_CAPTURE         1
+  #define DMA_CAPTURE_STREAM      DMA2_Stream5
+  #define DMA_CAPTURE_REQUEST     DMA_CHANNEL_6
+  #define DMA_CAPTURE_IRQn        DMA2_Stream5_IRQn
+  #define DMA_CAPTURE_IRQHandler  DMA2_Stream5_IRQHandler
+#elif defined(STM32L4xx)
+  // TIM1_UP = DMA1 通道6 请求7
+  #define HAS_DMA_CAPTURE         1
+  #define DMA_CAPTURE_STREAM      DMA1_Channel6
+  #define DMA_CAPTURE_REQUEST     DMA_REQUEST_7
+  #define DMA_CAPTURE_IRQn        DMA1_Channel6_IRQn
+  #define DMA_CAPTURE_IRQHandler  DMA1_Channel6_IRQHandler
+#elif defined(STM32G4xx)
+  // DMAMUX可将TIM1_UP接到任意通道
+  #define HAS_DMA_CAPTURE         1
+  #define DMA_CAPTURE_STREAM      DMA1_Channel1
+  #define DMA_CAPTURE_REQUEST     DMA_REQUEST_TIM1_UP
+  #define DMA_CAPTURE_IRQn        DMA1_Channel1_IRQn
+  #define DMA_CAPTURE_IRQHandler  DMA1_Channel1_IRQHandler
+#else
+  #define HAS_DMA_CAPTURE         0
+#endif
+
+// DMA中断优先级（低于UART，回调只打包采样）
+#define DMA_CAPTURE_IRQ_PRIORITY  2
 
 /**
  * Timer配置类
@@ -78,54 +108,50 @@ protected:
 };
 
 /**
- * DMA传输管理类
+ * DMA采样管理类
+ * 定时器按采样率产生更新事件，每个事件触发DMA把GPIO输入寄存器的一个字节
+ * 写入循环缓冲区；半传输/传输完成中断由DMACapture打包并交给回调
  */
-class DMAManager {
+class DMAManager : public DMACapture {
 public:
   DMAManager();
   
   /**
-   * 初始化DMA
-   * @param buffer1 缓冲区1
-   * @param buffer2 缓冲区2（双缓冲模式）
-   * @param bufferSize 缓冲区大小
-   * @param callback 传输完成回调
+   * 初始化定时器和DMA
+   * @param sampleRate 采样频率 (Hz)
+   * @param pin 采样引脚（Arduino引脚号，例如DIO2）
+   * @param buffer 循环缓冲区
+   * @param bufferSize 缓冲区大小（采样），两个半区各为32的倍数
+   * @param callback 半区回调（DMA中断上下文）
    * @return 成功返回true
    */
-  bool begin(uint8_t* buffer1, uint8_t* buffer2, uint16_t bufferSize, 
-             void (*callback)(uint8_t* buffer, uint16_t size));
+  bool begin(uint32_t sampleRate, uint32_t pin, uint8_t* buffer, uint16_t bufferSize,
+             DMACaptureCallback callback);
   
   /**
-   * 启动DMA传输
+   * 启动DMA采样
    */
   void start();
   
   /**
-   * 停止DMA传输
+   * 停止DMA采样
    */
   void stop();
-  
-  /**
-   * 获取当前活动缓冲区
-   */
-  uint8_t* getActiveBuffer();
-  
-  /**
-   * DMA中断处理（内部使用）
-   */
-  void handleInterrupt();
 
 protected:
-  uint8_t* dmaBuf1;
-  uint8_t* dmaBuf2;
+  HardwareTimer* timer;
+  volatile uint8_t* sourceAddress;    // GPIO输入寄存器中采样引脚所在的字节
   uint16_t bufSize;
-  bool useBuffer1;
-  void (*transferCallback)(uint8_t* buffer, uint16_t size);
+  bool running;
+  
+  uint16_t getWritePosition() override;
 };
 
 /**
  * UART输出类
- * 支持DMA传输和多UART实例
+ * 所有发送接口只把数据写入发送环形缓冲区并立即返回；
+ * service()把缓冲区中的数据交给UART的中断驱动发送缓冲区（由TXE中断发出），
+ * 每次只写入硬件缓冲区的空闲部分，从不等待
  */
 class UARTOutput {
 public:
@@ -135,57 +161,75 @@ public:
    * 初始化UART
    * @param uart UART实例 (Serial1, Serial2等)
    * @param baudrate 波特率
-   * @param useDMA 是否使用DMA
    * @return 成功返回true
    */
-  bool begin(HardwareSerial& uart, uint32_t baudrate, bool useDMA = true);
+  bool begin(HardwareSerial& uart, uint32_t baudrate);
   
   /**
-   * 发送字符串
+   * 发送字符串（不阻塞）
    * @param str 字符串
+   * @return 缓冲区空间不足时返回false，字符串被丢弃
    */
-  void print(const char* str);
+  bool print(const char* str);
   
   /**
-   * 发送字符串并换行
+   * 发送字符串并换行（不阻塞，字符串和换行符一起写入或丢弃）
    * @param str 字符串
    */
-  void println(const char* str);
+  bool println(const char* str);
   
   /**
-   * 发送二进制数据
+   * 发送二进制数据（不阻塞）
    * @param data 数据缓冲区
    * @param length 数据长度
    */
-  void write(const uint8_t* data, uint16_t length);
+  bool write(const uint8_t* data, uint16_t length);
   
   /**
-   * 发送APRS帧（格式化输出）
+   * 设置帧输出格式
+   * @param format UART_FORMAT_TNC2 或 UART_FORMAT_KISS
+   * @param kissPort KISS端口号 (0-15)
+   */
+  void setOutputFormat(uint8_t format, uint8_t kissPort = KISS_PORT);
+  
+  /**
+   * 获取帧输出格式
+   */
+  uint8_t getOutputFormat();
+  
+  /**
+   * 发送APRS帧（按输出格式编码为TNC2文本行或KISS帧，不阻塞）
    * @param frame AX.25帧
+   * @return 缓冲区空间不足时返回false，该帧被丢弃
+   */
+  bool sendAPRSFrame(APRS_AX25Frame* frame);
+  
+  /**
+   * 把发送缓冲区中的数据交给UART（在loop()中调用，不阻塞）
    */
-  void sendAPRSFrame(APRS_AX25Frame* frame);
+  void service();
   
   /**
-   * 检查是否传输忙
+   * 检查是否传输忙（发送缓冲区或UART硬件缓冲区中还有数据）
    */
   bool isBusy();
   
   /**
-   * 等待传输完成
+   * 等待传输完成（阻塞，仅在需要确认输出完成时使用）
    */
   void flush();
-
-protected:
-  HardwareSerial* uartPort;
-  bool useDMATransfer;
-  uint8_t txBuffer[512];
-  uint16_t txBufferPos;
-  bool txBusy;
   
   /**
-   * 格式化呼号
+   * 获取发送统计
    */
-  void formatCallsign(char* output, APRS_AX25Address* addr);
+  UARTTxStatistics* getStatistics();
+
+protected:
+  HardwareSerial* uartPort;
+  UARTTxRing txRing;                      // 发送环形缓冲区
+  uint8_t outputFormat;                   // UART_FORMAT_TNC2 / UART_FORMAT_KISS
+  uint8_t kissPortNumber;
+  uint8_t lineBuffer[KISS_MAX_ENCODED_LEN]; // TNC2文本行或KISS帧的编码缓冲区
 };
 
 // 全局单例
@@ -0,0 +1,187 @@
+/**
+ * UART发送环形缓冲区（单生产者/单消费者，无锁）
+ *
+ * loop()把待发送的文本行写入环形缓冲区后立即返回，由发送中断
+ * （TXE中断或DMA传输完成中断）从缓冲区取出数据发送，主循环不再等待串口。
+ *
+ * - 生产者（loop）只写head，消费者（发送中断）只写tail，与SampleRing相同的内存顺序
+ * - write()整块写入：空间不足时整块丢弃并计数，不会输出半行
+ * - 消费者以块为单位取数据（startBlock/endBlock），可直接作为DMA源地址，无需拷贝；
+ *   块在endBlock()之前保持占用，isBusy()在最后一个字节交给硬件之前一直为true
+ * - 逐字节接口popByte()供TXE中断使用
+ */
+
+#ifndef UART_TX_RING_H
+#define UART_TX_RING_H
+
+#include "aprs_config.h"
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+#if (UART_TX_RING_SIZE & (UART_TX_RING_SIZE - 1)) != 0 || UART_TX_RING_SIZE > 32768
+  #error "UART_TX_RING_SIZE必须为2的幂且不超过32768"
+#endif
+
+// 发送统计
+typedef struct {
+  uint32_t bytesQueued;         // 写入缓冲区的字节数
+  uint32_t bytesSent;           // 已交给硬件的字节数
+  uint32_t bytesDropped;        // 因缓冲区满而丢弃的字节数
+  uint32_t writesDropped;       // 被丢弃的写入次数（行）
+  uint16_t highWater;           // 缓冲区占用的历史最大值（字节）
+} UARTTxStatistics;
+
+class UARTTxRing {
+public:
+  UARTTxRing() {
+    reset();
+  }
+
+  /**
+   * 清空缓冲区和统计（不得与发送并发调用）
+   */
+  void reset() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    blockLen = 0;
+    memset(&stats, 0, sizeof(stats));
+  }
+
+  /**
+   * 写入数据（生产者，不阻塞）
+   * @param data 数据
+   * @param length 长度
+   * @return 空间不足时返回false，数据整块丢弃
+   */
+  bool write(const uint8_t* data, uint16_t length) {
+    return write(data, length, nullptr, 0);
+  }
+
+  /**
+   * 写入两段数据（例如文本行和换行符），作为一个整体写入或丢弃
+   * 两段的总长度一起检查，拷贝完两段后才更新head，消费者不会看到只有前一段的数据
+   */
+  bool write(const uint8_t* data, uint16_t length, const uint8_t* suffix, uint16_t suffixLen) {
+    uint16_t h = head.load(std::memory_order_relaxed);
+    uint16_t used = (uint16_t)(h - tail.load(std::memory_order_acquire));
+    uint32_t total = (uint32_t)length + suffixLen;
+
+    if (total > (uint32_t)(UART_TX_RING_SIZE - used)) {
+      stats.bytesDropped += total;
+      stats.writesDropped++;
+      return false;
+    }
+
+    copyIn(h, data, length);
+    copyIn((uint16_t)(h + length), suffix, suffixLen);
+    head.store((uint16_t)(h + total), std::memory_order_release);
+
+    stats.bytesQueued += total;
+    if (used + total > stats.highWater) {
+      stats.highWater = (uint16_t)(used + total);
+    }
+    return true;
+  }
+
+  /**
+   * 取出下一块连续数据开始发送（消费者）
+   * 缓冲区回绕时只返回到缓冲区末尾的部分
+   * @param data 输出：指向块的第一个字节
+   * @param maxLen 块的最大长度
+   * @return 块长度，无数据或上一块尚未结束时返回0
+   */
+  uint16_t startBlock(const uint8_t** data, uint16_t maxLen) {
+    if (blockLen != 0) {
+      return 0;
+    }
+
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    uint16_t avail = (uint16_t)(head.load(std::memory_order_acquire) - t);
+    uint16_t index = t & (UART_TX_RING_SIZE - 1);
+
+    if (avail > UART_TX_RING_SIZE - index) {
+      avail = UART_TX_RING_SIZE - index;
+    }
+    if (avail > maxLen) {
+      avail = maxLen;
+    }
+    *data = &buffer[index];
+    blockLen = avail;
+    return avail;
+  }
+
+  /**
+   * 当前块发送完成，释放其空间（消费者）
+   */
+  void endBlock() {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    stats.bytesSent += blockLen;
+    tail.store((uint16_t)(t + blockLen), std::memory_order_release);
+    blockLen = 0;
+  }
+
+  /**
+   * 取出一个字节（消费者，TXE中断）
+   * @return 字节，缓冲区为空时返回-1
+   */
+  int16_t popByte() {
+    uint16_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t) {
+      return -1;
+    }
+    uint8_t b = buffer[t & (UART_TX_RING_SIZE - 1)];
+    tail.store((uint16_t)(t + 1), std::memory_order_release);
+    stats.bytesSent++;
+    return b;
+  }
+
+  /**
+   * 尚未发送完成的字节数（含正在发送的块）
+   */
+  uint16_t pending() {
+    return (uint16_t)(head.load(std::memory_order_acquire) -
+                      tail.load(std::memory_order_acquire));
+  }
+
+  /**
+   * 是否有尚未交给硬件的数据
+   */
+  bool isBusy() {
+    return pending() != 0;
+  }
+
+  /**
+   * 获取统计信息
+   */
+  UARTTxStatistics* getStatistics() {
+    return &stats;
+  }
+
+protected:
+  /**
+   * 从位置pos开始拷贝数据（最多分两段，处理回绕），不更新head
+   */
+  void copyIn(uint16_t pos, const uint8_t* data, uint16_t length) {
+    if (length == 0) {
+      return;
+    }
+    uint16_t index = pos & (UART_TX_RING_SIZE - 1);
+    uint16_t first = UART_TX_RING_SIZE - index;
+    if (first > length) {
+      first = length;
+    }
+    memcpy(&buffer[index], data, first);
+    memcpy(&buffer[0], data + first, length - first);
+  }
+
+  uint8_t buffer[UART_TX_RING_SIZE];
+  std::atomic<uint16_t> head;         // 下一个写入位置（仅生产者修改）
+  std::atomic<uint16_t> tail;         // 下一个读取位置（仅消费者修改）
+  volatile uint16_t blockLen;         // 正在发送的块长度（仅消费者修改）
+
+  // bytesQueued/bytesDropped/writesDropped/highWater仅生产者修改，bytesSent仅消费者修改
+  UARTTxStatistics stats;
+};
+
+#endif // UART_TX_RING_H
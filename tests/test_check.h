@@ -0,0 +1,24 @@
+/**
+ * 主机端测试的检查宏
+ *
+ * 每个测试程序是独立的可执行文件，由ctest运行：
+ * CHECK失败时输出位置和条件并计数，main()返回TEST_RESULT()（有失败时为1）。
+ */
+
+#ifndef TEST_CHECK_H
+#define TEST_CHECK_H
+
+#include <stdio.h>
+
+static unsigned testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: 检查失败: %s\n", __FILE__, __LINE__, #cond); \
+      testFailures++; \
+    } \
+  } while (0)
+
+#define TEST_RESULT()   (testFailures == 0 ? 0 : 1)
+
+#endif // TEST_CHECK_H
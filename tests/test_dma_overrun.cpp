@@ -0,0 +1,122 @@
+/**
+ * DMA采样溢出测试（主机端，HostDMASimulator）
+ *
+ * - 中断按时处理时不计溢出，所有帧都能解出
+ * - 一次中断被延迟超过半个缓冲区：处理时DMA已回到本半区，溢出被计数；
+ *   受影响的帧丢失，之后的帧照常解出（解码器恢复）
+ */
+
+#include "aprs_decoder.h"
+#include "aprs_format.h"
+#include "afsk_generator.h"
+#include "dma_capture.h"
+#include "test_check.h"
+
+#include <string>
+#include <vector>
+
+#define TEST_FRAMES     8
+
+static APRSDecoder decoder;
+static HostDMASimulator dma;
+static uint8_t captureBuffer[DMA_CAPTURE_BUFFER_SIZE];
+
+static void captureCallback(const uint32_t* words, uint16_t count) {
+  decoder.processPackedSamples(words, count);
+}
+
+/**
+ * 生成信号，记录每帧的起止采样位置
+ */
+static void generate(std::vector<uint8_t>* samples, std::vector<std::string>* sent,
+                     std::vector<size_t>* frameEnd) {
+  AFSKGenerator generator;
+  uint8_t frame[AX25_MAX_FRAME_LEN];
+  char text[128];
+  std::vector<uint8_t> buffer;
+
+  generator.begin(7);
+  for (unsigned i = 0; i < TEST_FRAMES; i++) {
+    size_t pos = samples->size();
+    samples->resize(pos + AFSK_SAMPLE_RATE / 10);
+    generator.generateNoise(&(*samples)[pos], AFSK_SAMPLE_RATE / 10);
+
+    snprintf(text, sizeof(text), "BG%04u-9>APRS,WIDE1-1:>DMA overrun test %u", i, i);
+    uint16_t length = AFSKGenerator::buildFrame(text, frame, sizeof(frame));
+    CHECK(length > 0);
+    buffer.resize(generator.getMaxSamples(length));
+    uint32_t count = generator.modulateFrame(frame, length, buffer.data(), (uint32_t)buffer.size());
+    samples->insert(samples->end(), buffer.begin(), buffer.begin() + count);
+    sent->push_back(text);
+    frameEnd->push_back(samples->size());
+  }
+  size_t pos = samples->size();
+  samples->resize(pos + AFSK_SAMPLE_RATE / 10);
+  generator.generateNoise(&(*samples)[pos], AFSK_SAMPLE_RATE / 10);
+}
+
+/**
+ * 送入采样并取出帧；stallAt处的下一次中断延迟stall个采样
+ */
+static void run(const std::vector<uint8_t>& samples, size_t stallAt, uint32_t stall,
+                std::vector<std::string>* received) {
+  char line[AX25_MAX_FRAME_LEN * 2];
+
+  decoder.begin();
+  CHECK(dma.begin(captureBuffer, DMA_CAPTURE_BUFFER_SIZE, 3, captureCallback));
+  received->clear();
+
+  for (size_t i = 0; i < samples.size(); i += 256) {
+    if (stall > 0 && i <= stallAt && stallAt < i + 256) {
+      dma.stallNextInterrupt(stall);
+    }
+    size_t n = (samples.size() - i < 256) ? samples.size() - i : 256;
+    dma.feed(&samples[i], (uint32_t)n);
+    while (decoder.available()) {
+      APRS_AX25Frame* frame = decoder.getFrame();
+      if (frame != nullptr && frame->valid) {
+        formatTNC2(frame, line, sizeof(line));
+        received->push_back(line);
+      }
+    }
+  }
+}
+
+static bool contains(const std::vector<std::string>& list, const std::string& text) {
+  for (const std::string& item : list) {
+    if (item == text) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int main() {
+  std::vector<uint8_t> samples;
+  std::vector<std::string> sent, received;
+  std::vector<size_t> frameEnd;
+  generate(&samples, &sent, &frameEnd);
+
+  // 按时处理
+  run(samples, 0, 0, &received);
+  CHECK(dma.getStatistics()->overruns == 0);
+  CHECK(received.size() == sent.size());
+  for (const std::string& text : sent) {
+    CHECK(contains(received, text));
+  }
+
+  // 第4帧中间的一次中断延迟半个缓冲区再加100个采样
+  const unsigned hit = 3;
+  size_t stallAt = (frameEnd[hit - 1] + frameEnd[hit]) / 2 + AFSK_SAMPLE_RATE / 20;
+  run(samples, stallAt, DMA_CAPTURE_BUFFER_SIZE / 2 + 100, &received);
+  CHECK(dma.getStatistics()->overruns >= 1);
+  CHECK(!contains(received, sent[hit]));
+  for (unsigned i = 0; i < TEST_FRAMES; i++) {
+    if (i != hit) {
+      CHECK(contains(received, sent[i]));
+    }
+  }
+  CHECK(decoder.getStatistics()->framesValid == TEST_FRAMES - 1);
+
+  return TEST_RESULT();
+}
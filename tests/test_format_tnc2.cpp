@@ -0,0 +1,109 @@
+/**
+ * TNC2格式化测试（主机端）
+ *
+ * 按地址列表构造帧（地址后带'*'的置H位），经AX.25解析器校验后再格式化：
+ * - 只有最后一个已转发的中继后带'*'
+ * - 没有已转发的中继或没有路径时不带'*'
+ */
+
+#include "aprs_format.h"
+#include "ax25_parser.h"
+#include "test_check.h"
+
+#include <string.h>
+
+static AX25Parser parser;
+static APRS_AX25Frame frame;
+
+/**
+ * 编码一个地址（"CALL-SSID"，末尾'*'表示已转发），不校验输入
+ */
+static void encodeAddress(const char* text, uint8_t* output, bool last) {
+  const char* end = text + strlen(text);
+  bool repeated = end[-1] == '*';
+  if (repeated) {
+    end--;
+  }
+
+  const char* dash = text;
+  while (dash < end && *dash != '-') {
+    dash++;
+  }
+  uint8_t ssid = 0;
+  for (const char* p = dash + 1; p < end; p++) {
+    ssid = (uint8_t)(ssid * 10 + (*p - '0'));
+  }
+
+  for (uint8_t i = 0; i < 6; i++) {
+    char c = (text + i < dash) ? text[i] : ' ';
+    output[i] = (uint8_t)(c << 1);
+  }
+  output[6] = (uint8_t)(0x60 | (ssid << 1) | (repeated ? 0x80 : 0) | (last ? 0x01 : 0));
+}
+
+/**
+ * 构造UI帧（含FCS）：addresses依次为目标、源和中继路径
+ */
+static uint16_t buildFrame(const char* const* addresses, uint8_t count, const char* info, uint8_t* output) {
+  uint16_t pos = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    encodeAddress(addresses[i], &output[pos], i == count - 1);
+    pos += 7;
+  }
+  output[pos++] = 0x03;
+  output[pos++] = 0xF0;
+  memcpy(&output[pos], info, strlen(info));
+  pos += (uint16_t)strlen(info);
+
+  uint16_t crc = 0xFFFF;
+  for (uint16_t i = 0; i < pos; i++) {
+    crc ^= output[i];
+    for (uint8_t b = 0; b < 8; b++) {
+      crc = (crc & 1) ? (uint16_t)((crc >> 1) ^ 0x8408) : (uint16_t)(crc >> 1);
+    }
+  }
+  crc ^= 0xFFFF;
+  output[pos++] = (uint8_t)(crc & 0xFF);
+  output[pos++] = (uint8_t)(crc >> 8);
+  return pos;
+}
+
+/**
+ * 构造并解析帧，返回格式化结果是否等于expected
+ */
+static bool roundTrip(const char* const* addresses, uint8_t count, const char* info, const char* expected) {
+  uint8_t raw[AX25_MAX_FRAME_LEN];
+  char line[AX25_MAX_FRAME_LEN * 2];
+
+  uint16_t length = buildFrame(addresses, count, info, raw);
+  parser.setBuffer(&frame);
+  parser.startFrame();
+  parser.addBytes(raw, length);
+  if (!parser.endFrame()) {
+    return false;
+  }
+  formatTNC2(&frame, line, sizeof(line));
+  if (strcmp(line, expected) != 0) {
+    fprintf(stderr, "  %s\n  期望 %s\n", line, expected);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  parser.begin();
+
+  static const char* const noPath[] = { "APRS", "N0CALL-9" };
+  static const char* const notRepeated[] = { "APRS", "N0CALL", "WIDE1-1", "WIDE2-1" };
+  static const char* const firstHop[] = { "APRS", "N0CALL", "WIDE1-1*", "WIDE2-1" };
+  static const char* const bothHops[] = { "APRS", "N0CALL", "DIGI1*", "WIDE2-1*" };
+  static const char* const lastHop[] = { "APRS", "N0CALL", "DIGI1", "DIGI2", "DIGI3*" };
+
+  CHECK(roundTrip(noPath, 2, ">no path", "N0CALL-9>APRS:>no path"));
+  CHECK(roundTrip(notRepeated, 4, ">not repeated", "N0CALL>APRS,WIDE1-1,WIDE2-1:>not repeated"));
+  CHECK(roundTrip(firstHop, 4, ">first hop", "N0CALL>APRS,WIDE1-1*,WIDE2-1:>first hop"));
+  CHECK(roundTrip(bothHops, 4, ">both hops", "N0CALL>APRS,DIGI1,WIDE2-1*:>both hops"));
+  CHECK(roundTrip(lastHop, 5, ">last", "N0CALL>APRS,DIGI1,DIGI2,DIGI3*:>last"));
+
+  return TEST_RESULT();
+}
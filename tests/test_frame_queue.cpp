@@ -0,0 +1,133 @@
+/**
+ * 帧输出队列测试（主机端）
+ *
+ * 随机长度的帧随机入队、出队，排队帧在存储中反复回绕：
+ * - 取出的帧与入队时的内容、帧头和标签一致，先进先出
+ * - 入队数 = 取出数 + 丢弃数 + 队列中的帧数
+ * - DROP_OLDEST下最新的帧总能入队；DROP_NEWEST下被拒绝的正是新帧
+ * - 最长帧总能放入（DROP_OLDEST）
+ */
+
+#include "frame_queue.h"
+#include "test_check.h"
+
+#include <string.h>
+
+static FrameQueue queue;
+static APRS_AX25Frame frame;
+
+static uint32_t rng = 12345;
+
+static uint32_t random32() {
+  rng = rng * 1103515245u + 12345u;
+  return rng >> 8;
+}
+
+/**
+ * 按序号生成帧：长度和内容由序号决定
+ */
+static void makeFrame(uint32_t seq, uint16_t length) {
+  memset(&frame, 0xEE, sizeof(frame));
+  frame.length = length;
+  frame.infoOffset = 16;
+  frame.infoLen = length - 18;
+  frame.fcs = (uint16_t)seq;
+  frame.fixedBits = (uint8_t)(seq % 3);
+  frame.valid = true;
+  memcpy(frame.raw, &seq, sizeof(seq));
+  for (uint16_t i = sizeof(seq); i < length; i++) {
+    frame.raw[i] = (uint8_t)(seq * 7 + i);
+  }
+}
+
+static bool checkFrame(const APRS_AX25Frame* f, uint32_t seq) {
+  if (f->fcs != (uint16_t)seq || f->fixedBits != seq % 3 || !f->valid ||
+      f->infoOffset != 16 || f->infoLen != f->length - 18) {
+    return false;
+  }
+  uint32_t stored;
+  memcpy(&stored, f->raw, sizeof(stored));
+  if (stored != seq) {
+    return false;
+  }
+  for (uint16_t i = sizeof(seq); i < f->length; i++) {
+    if (f->raw[i] != (uint8_t)(seq * 7 + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void run(uint8_t policy) {
+  uint32_t pushed = 0, popped = 0, nextSeq = 0;
+  uint32_t lastPopped = 0;
+  bool anyPopped = false;
+
+  queue.reset();
+  queue.setPolicy(policy);
+
+  for (uint32_t step = 0; step < 20000; step++) {
+    if (random32() % 100 < 55) {
+      uint16_t length = (random32() % 8 == 0) ? AX25_MAX_FRAME_LEN
+                                              : (uint16_t)(AX25_MIN_FRAME_LEN + random32() % 120);
+      uint32_t seq = nextSeq++;
+      makeFrame(seq, length);
+      uint8_t before = queue.count();
+      uint32_t droppedBefore = queue.getDropped();
+      bool ok;
+      if (step % 2) {
+        ok = queue.push(&frame, (uint8_t)seq);
+      } else {
+        memcpy(queue.acquire(), &frame, sizeof(frame));
+        ok = queue.commit((uint8_t)seq);
+      }
+      pushed++;
+      if (policy == FRAME_QUEUE_DROP_OLDEST) {
+        CHECK(ok);
+      } else {
+        CHECK(ok == (queue.getDropped() == droppedBefore));
+        CHECK(ok ? queue.count() == before + 1 : queue.count() == before);
+      }
+      CHECK(queue.count() <= FRAME_QUEUE_DEPTH);
+    } else {
+      uint8_t tag;
+      uint16_t infoLen;
+      const uint8_t* info = queue.peekInfo(&infoLen);
+      APRS_AX25Frame* f = queue.pop(&tag);
+      CHECK((info == nullptr) == (f == nullptr));
+      if (f == nullptr) {
+        continue;
+      }
+      uint32_t seq;
+      memcpy(&seq, f->raw, sizeof(seq));
+      CHECK(checkFrame(f, seq));
+      CHECK(tag == (uint8_t)seq);
+      CHECK(infoLen == f->infoLen);
+      CHECK(!anyPopped || seq > lastPopped);
+      lastPopped = seq;
+      anyPopped = true;
+      popped++;
+    }
+    CHECK(pushed == popped + queue.getDropped() + queue.count());
+  }
+
+  // 最新的帧总在队尾（DROP_OLDEST）
+  if (policy == FRAME_QUEUE_DROP_OLDEST) {
+    makeFrame(nextSeq, AX25_MAX_FRAME_LEN);
+    CHECK(queue.push(&frame, 0));
+    APRS_AX25Frame* f = nullptr;
+    APRS_AX25Frame* last = nullptr;
+    while ((f = queue.pop()) != nullptr) {
+      last = f;
+    }
+    CHECK(last != nullptr && checkFrame(last, nextSeq));
+  }
+  CHECK(queue.getDropped() > 0);
+  CHECK(queue.getHighWater() == FRAME_QUEUE_DEPTH);
+}
+
+int main() {
+  run(FRAME_QUEUE_DROP_OLDEST);
+  run(FRAME_QUEUE_DROP_NEWEST);
+  return TEST_RESULT();
+}
@@ -0,0 +1,70 @@
+/**
+ * 活动门控关闭计数测试（主机端）
+ *
+ * 帧之间是噪声，门控在每个间隔中关闭。关闭时解帧器通常处于接收状态，
+ * 缓冲区中是结束标志之后由噪声解出的字节：这些不是被放弃的帧，
+ * 不能计入gateAbortedFrames，且所有帧都能解出。
+ */
+
+#include "aprs_decoder.h"
+#include "aprs_format.h"
+#include "afsk_generator.h"
+#include "test_check.h"
+
+#include <string>
+#include <vector>
+
+#define TEST_FRAMES     8
+
+static APRSDecoder decoder;
+
+static void generate(std::vector<uint8_t>* samples, std::vector<std::string>* sent) {
+  AFSKGenerator generator;
+  uint8_t frame[AX25_MAX_FRAME_LEN];
+  char text[128];
+  std::vector<uint8_t> buffer;
+
+  generator.begin(11);
+  for (unsigned i = 0; i <= TEST_FRAMES; i++) {
+    size_t pos = samples->size();
+    samples->resize(pos + AFSK_SAMPLE_RATE / 5);
+    generator.generateNoise(&(*samples)[pos], AFSK_SAMPLE_RATE / 5);
+    if (i == TEST_FRAMES) {
+      break;
+    }
+
+    snprintf(text, sizeof(text), "BG%04u-9>APRS,WIDE1-1:>Gate test %u", i, i);
+    uint16_t length = AFSKGenerator::buildFrame(text, frame, sizeof(frame));
+    CHECK(length > 0);
+    buffer.resize(generator.getMaxSamples(length));
+    uint32_t count = generator.modulateFrame(frame, length, buffer.data(), (uint32_t)buffer.size());
+    samples->insert(samples->end(), buffer.begin(), buffer.begin() + count);
+    sent->push_back(text);
+  }
+}
+
+int main() {
+  std::vector<uint8_t> samples;
+  std::vector<std::string> sent, received;
+  char line[AX25_MAX_FRAME_LEN * 2];
+
+  generate(&samples, &sent);
+  decoder.begin();
+  for (size_t i = 0; i < samples.size(); i += 256) {
+    size_t n = (samples.size() - i < 256) ? samples.size() - i : 256;
+    decoder.processSamples(&samples[i], n);
+    while (decoder.available()) {
+      APRS_AX25Frame* frame = decoder.getFrame();
+      if (frame != nullptr && frame->valid) {
+        formatTNC2(frame, line, sizeof(line));
+        received.push_back(line);
+      }
+    }
+  }
+
+  CHECK(received == sent);
+  CHECK(decoder.getActivityStatistics()->wakeups >= TEST_FRAMES);
+  CHECK(decoder.getStatistics()->gateAbortedFrames == 0);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,122 @@
+/**
+ * UARTOutput / UARTTxRing 测试（主机端，使用HardwareSerial替身）
+ *
+ * - 回绕：多次写满再发出，环形缓冲区的读写位置越过缓冲区末尾，输出与写入一致
+ * - 缓冲区满：写入被整块丢弃并计数；文本行放得下而换行符放不下时两者都不写入
+ * - flush：发送中断持续工作时flush()返回后所有数据已发出
+ */
+
+#include "stm32_hal.h"
+#include "test_check.h"
+
+#include <string>
+
+/**
+ * 替身已发出的字节
+ */
+static std::string sentText(HardwareSerial& serial) {
+  return std::string((const char*)serial.getSent(), serial.getSentLength());
+}
+
+static void testWraparound() {
+  HardwareSerial serial;
+  UARTOutput output;
+  output.begin(serial, UART_BAUDRATE);
+
+  std::string expected;
+  char line[64];
+  // 每轮写入约一半的环形缓冲区，再由"硬件"发出，共越过末尾数次
+  for (unsigned round = 0; round < 12; round++) {
+    unsigned written = 0;
+    for (unsigned n = 0; written < UART_TX_RING_SIZE / 2; n++) {
+      snprintf(line, sizeof(line), "R%02u L%03u abcdefghijklmnopqrstuvwxyz", round, n);
+      CHECK(output.println(line));
+      expected += line;
+      expected += "\r\n";
+      written += (unsigned)strlen(line) + 2;
+    }
+    while (output.isBusy()) {
+      serial.transmit(SERIAL_TX_BUFFER_SIZE);
+      output.service();
+    }
+  }
+
+  CHECK(sentText(serial) == expected);
+  UARTTxStatistics* stats = output.getStatistics();
+  CHECK(stats->writesDropped == 0);
+  CHECK(stats->bytesQueued == expected.size());
+  CHECK(stats->bytesSent == expected.size());
+  CHECK(stats->bytesQueued > 4 * UART_TX_RING_SIZE);
+}
+
+static void testFullRing() {
+  HardwareSerial serial;
+  UARTOutput output;
+  output.begin(serial, UART_BAUDRATE);
+
+  // 硬件不发送：UART缓冲区接收SERIAL_TX_BUFFER_SIZE - 1字节后，其余留在环形缓冲区
+  const unsigned capacity = UART_TX_RING_SIZE + SERIAL_TX_BUFFER_SIZE - 1;
+  std::string expected;
+  char line[UART_TX_RING_SIZE];
+  memset(line, 'x', sizeof(line));
+
+  // 写入32字节的块直到写不下
+  line[32] = '\0';
+  while (expected.size() + 32 <= capacity) {
+    CHECK(output.print(line));
+    expected.append(line, 32);
+  }
+  unsigned room = capacity - (unsigned)expected.size();
+  CHECK(room < 32);
+  CHECK(!output.print(line));
+  CHECK(output.getStatistics()->writesDropped == 1);
+  CHECK(output.getStatistics()->bytesDropped == 32);
+
+  // 文本行正好放得下，加上换行符放不下：整行丢弃
+  memset(line, 'y', room);
+  line[room] = '\0';
+  CHECK(!output.println(line));
+  CHECK(output.getStatistics()->writesDropped == 2);
+  CHECK(output.getStatistics()->bytesDropped == 32 + room + 2);
+
+  // 硬件发出一部分、service()移入UART缓冲区后，同一行可以写入
+  serial.transmit(room + 2);
+  output.service();
+  CHECK(output.println(line));
+  expected.append(line, room);
+  expected += "\r\n";
+
+  serial.setBytesPerPoll(SERIAL_TX_BUFFER_SIZE);
+  output.flush();
+  CHECK(sentText(serial) == expected);
+}
+
+static void testFlush() {
+  HardwareSerial serial;
+  UARTOutput output;
+  output.begin(serial, UART_BAUDRATE);
+
+  std::string expected;
+  for (unsigned n = 0; n < 20; n++) {
+    char line[48];
+    snprintf(line, sizeof(line), "BG%04u>APRS:>flush %u", n, n);
+    CHECK(output.println(line));
+    expected += line;
+    expected += "\r\n";
+  }
+  CHECK(output.isBusy());
+
+  // 每次轮询发出8个字节，flush()忙等待直到全部发出
+  serial.setBytesPerPoll(8);
+  output.flush();
+  CHECK(!output.isBusy());
+  CHECK(sentText(serial) == expected);
+  CHECK(output.getStatistics()->bytesSent == expected.size());
+}
+
+int main() {
+  testWraparound();
+  testFullRing();
+  testFlush();
+  return TEST_RESULT();
+}
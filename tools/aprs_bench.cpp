@@ -0,0 +1,579 @@
+/**
+ * 解码率基准测试（主机端）
+ *
+ * 用AFSKGenerator为一组信道条件生成测试信号（帧之间为随机噪声），
+ * 将同一段信号分别送入各解码器变体，统计：
+ * - 解码帧数/发送帧数（按TNC2文本与发送的帧逐一比对，重复解出只计一次）
+ * - 误帧数（通过CRC但与任何发送帧都不一致的帧，例如错误的比特修复）
+ * - 吞吐量（采样/秒，只计解码器处理时间，不含信号生成）
+ *
+ * 解码器变体：
+ * - goertzel / fixed / corr / packed：APRSDecoder + setDemodulator选择的解调器
+ * - decim：APRSDecoder + CIC抽取前端的相关解调器（AFSKDecimatingDemodulator，
+ *   抽取因子BENCH_DECIMATION，与以抽取后的采样率直接采样的1200h配置对比）
+ * - multi：APRSMultiDecoder（MULTI_SLICER_DEFAULT个判决器）
+ * - profile：APRSDecoder + 编译期调制配置的相关解调器（AFSKProfileDemodulator）
+ *
+ * -p 选择调制配置（默认config为aprs_config.h的配置；1200、1200h、hf300见modem_profile.h；
+ * 9600为G3RUH基带），信号按该配置生成。其他变体只支持aprs_config.h的配置，
+ * 选择其他配置时只运行profile变体（9600时为G3RUHDemodulator）。
+ *
+ * 相同的种子产生相同的信号，结果可重复，用于比较不同实现或参数。
+ * -o 将生成的信号写入raw8文件（每字节一个0/1采样），可用aprs_replay回放。
+ *
+ * 运行全部条件且每种条件至少BENCH_LIMIT_MIN_FRAMES帧时，按各变体的门限检查合计解码率
+ * 和误帧数，未达到门限时返回1（作为ctest回归测试运行）；-G 不检查门限。
+ *
+ * 用法: aprs_bench [-n 帧数] [-S 种子] [-c 条件] [-v 变体] [-p 配置] [-o 文件] [-l] [-G]
+ */
+
+#include "aprs_decoder.h"
+#include "afsk_demod_fixed.h"
+#include "aprs_multi_decoder.h"
+#include "aprs_format.h"
+#include "afsk_generator.h"
+#include "afsk_profile_demod.h"
+#include "afsk_decimating.h"
+#include "g3ruh_demod.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 每次送入解码器的采样数
+#define BENCH_BLOCK     256
+
+// 帧间噪声长度范围（秒的分数：采样率 / N）
+#define BENCH_GAP_MIN_DIV   10
+#define BENCH_GAP_MAX_DIV   2
+
+// 信道条件
+typedef struct {
+  const char* name;
+  uint16_t preambleFlags;
+  float snrDb;
+  float twistDb;
+  float driftPpm;
+  float jitter;
+} BenchScenario;
+
+static const BenchScenario scenarios[] = {
+  // 名称          前导  信噪比              失衡    时钟偏差  抖动
+  { "clean",       32, AFSK_GEN_SNR_CLEAN,  0.0f,     0.0f,  0.00f },
+  { "snr12",       32, 12.0f,               0.0f,     0.0f,  0.00f },
+  { "snr9",        32,  9.0f,               0.0f,     0.0f,  0.00f },
+  { "snr6",        32,  6.0f,               0.0f,     0.0f,  0.00f },
+  { "snr4",        32,  4.0f,               0.0f,     0.0f,  0.00f },
+  { "snr2",        32,  2.0f,               0.0f,     0.0f,  0.00f },
+  { "twist+6",     32,  9.0f,               6.0f,     0.0f,  0.00f },
+  { "twist-6",     32,  9.0f,              -6.0f,     0.0f,  0.00f },
+  { "twist+12",    32,  9.0f,              12.0f,     0.0f,  0.00f },
+  { "drift+0.2%",  32, AFSK_GEN_SNR_CLEAN,  0.0f,  2000.0f,  0.00f },
+  { "drift-1%",    32, AFSK_GEN_SNR_CLEAN,  0.0f, -10000.0f, 0.00f },
+  { "drift+1%",    32, AFSK_GEN_SNR_CLEAN,  0.0f, 10000.0f,  0.00f },
+  { "jitter10%",   32, AFSK_GEN_SNR_CLEAN,  0.0f,     0.0f,  0.10f },
+  { "jitter20%",   32, AFSK_GEN_SNR_CLEAN,  0.0f,     0.0f,  0.20f },
+  { "preamble8",    8, AFSK_GEN_SNR_CLEAN,  0.0f,     0.0f,  0.00f },
+  { "preamble2",    2, AFSK_GEN_SNR_CLEAN,  0.0f,     0.0f,  0.00f },
+  { "mobile",      16,  9.0f,               6.0f,  1000.0f,  0.05f },
+};
+
+#define NUM_SCENARIOS   (sizeof(scenarios) / sizeof(scenarios[0]))
+
+// 解码器变体
+enum BenchVariant {
+  VARIANT_GOERTZEL,
+  VARIANT_FIXED,
+  VARIANT_CORR,
+  VARIANT_PACKED,
+  VARIANT_DECIM,
+  VARIANT_MULTI,
+  VARIANT_PROFILE,
+  VARIANT_COUNT
+};
+
+static const char* const variantNames[VARIANT_COUNT] = {
+  "goertzel", "fixed", "corr", "packed", "decim", "multi", "profile"
+};
+
+// 变体的回归门限：合计解码率（%）下限和误帧数上限
+// 按默认种子、100帧的结果留出约3个百分点的余量；profile变体的解码率门限见profiles
+typedef struct {
+  float minDecodeRate;
+  uint32_t maxFalseFrames;
+} BenchLimit;
+
+static const BenchLimit variantLimits[VARIANT_COUNT] = {
+  { 79.0f, 0 },   // goertzel
+  { 79.0f, 0 },   // fixed
+  { 80.0f, 0 },   // corr
+  { 79.0f, 0 },   // packed
+  { 81.0f, 0 },   // decim
+  { 84.0f, 0 },   // multi
+  {  0.0f, 0 },   // profile
+};
+
+// 帧数少于该值时解码率波动较大，不检查门限
+#define BENCH_LIMIT_MIN_FRAMES  50
+
+// decim变体的抽取因子和CIC阶数
+#define BENCH_DECIMATION    2
+#define BENCH_CIC_ORDER     AFSK_CIC_ORDER
+
+// 抽取后每比特至少8个采样时decim变体可用
+#define BENCH_DECIM_AVAILABLE \
+  ((AFSK_SAMPLE_RATE / BENCH_DECIMATION) % AFSK_BAUD_RATE == 0 && \
+   AFSK_SAMPLE_RATE / BENCH_DECIMATION / AFSK_BAUD_RATE >= 8)
+
+// 编译期调制配置的解调器实例（同一程序中共存）
+static AFSKProfileDemodulator<ModemProfileDefault> profileDefaultDemod;
+static AFSKProfileDemodulator<ModemProfile1200> profile1200Demod;
+static AFSKProfileDemodulator<ModemProfile1200Half> profile1200HalfDemod;
+static AFSKProfileDemodulator<ModemProfileHF300> profileHF300Demod;
+static G3RUHDemodulator g3ruhDemod;
+
+// 调制配置
+typedef struct {
+  const char* name;
+  uint32_t sampleRate;
+  uint16_t baudRate;
+  uint16_t markFreq;
+  uint16_t spaceFreq;
+  uint8_t modulation;
+  AFSKDemodulator* demod;
+  float minDecodeRate;      // profile变体的合计解码率门限（%）
+} BenchProfile;
+
+#define BENCH_PROFILE(name, P, demod, minRate) \
+  { name, P::sampleRate, P::baudRate, P::markFreq, P::spaceFreq, AFSK_GEN_AFSK, demod, minRate }
+
+// 第一项为aprs_config.h的配置（默认），随AFSK_SAMPLE_RATE等编译参数变化
+static const BenchProfile profiles[] = {
+  BENCH_PROFILE("config", ModemProfileDefault, &profileDefaultDemod, 80.0f),
+  BENCH_PROFILE("1200",  ModemProfile1200,     &profile1200Demod,    80.0f),
+  BENCH_PROFILE("1200h", ModemProfile1200Half, &profile1200HalfDemod, 61.0f),
+  BENCH_PROFILE("hf300", ModemProfileHF300,    &profileHF300Demod,   83.0f),
+  { "9600", G3RUH_SAMPLE_RATE, G3RUH_BAUD_RATE, 0, 0, AFSK_GEN_G3RUH, &g3ruhDemod, 72.0f },
+};
+
+#define NUM_PROFILES    (sizeof(profiles) / sizeof(profiles[0]))
+
+/**
+ * 配置是否与aprs_config.h一致（其他变体只支持该配置）
+ */
+static bool isDefaultProfile(const BenchProfile* profile) {
+  return profile->modulation == AFSK_GEN_AFSK &&
+         profile->sampleRate == AFSK_SAMPLE_RATE && profile->baudRate == AFSK_BAUD_RATE &&
+         profile->markFreq == AFSK_MARK_FREQ && profile->spaceFreq == AFSK_SPACE_FREQ;
+}
+
+// 一种条件下的测试信号
+typedef struct {
+  std::vector<uint8_t> samples;
+  std::unordered_map<std::string, uint32_t> sent;   // TNC2文本 → 帧序号
+} BenchSignal;
+
+// 一次运行的结果
+typedef struct {
+  uint32_t decoded;         // 解出的不同发送帧数
+  uint32_t falseFrames;     // 误帧数
+  double seconds;           // 解码耗时
+  uint32_t activeWords;     // 活动门控送入解调器的字数（无门控时为0）
+  uint32_t idleWords;       // 活动门控跳过的字数
+} BenchResult;
+
+// 各变体的累计值
+typedef struct {
+  uint32_t decoded;
+  uint32_t falseFrames;
+  uint64_t samples;
+  double seconds;
+  uint64_t activeWords;
+  uint64_t idleWords;
+} BenchTotal;
+
+/**
+ * 第index个测试帧的TNC2文本（轮换几种常见的APRS数据类型，信息字段长度不同）
+ */
+static void makePacket(uint32_t index, char* text, size_t maxLen) {
+  static const char padding[] = "abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  int pad = (int)((index * 7) % (sizeof(padding) - 1));
+
+  switch (index % 4) {
+    case 0:
+      snprintf(text, maxLen, "BG%04u-9>APRS,WIDE1-1,WIDE2-1:!3745.12N/12205.34W>%03u %.*s",
+               index % 10000, index % 1000, pad, padding);
+      break;
+    case 1:
+      snprintf(text, maxLen, "BH%04u>T2SQ5R,WIDE1-1:`(_fn\"Oj/]%03u %.*s=",
+               index % 10000, index % 1000, pad, padding);
+      break;
+    case 2:
+      snprintf(text, maxLen, "BD%04u-7>APDR15,WIDE2-2::BG1ABC   :Test %u %.*s{%u",
+               index % 10000, index, pad, padding, index % 100000);
+      break;
+    default:
+      snprintf(text, maxLen, "BA%04u-1>APRS,BA1XYZ,WIDE2-1:>Status %u %.*s",
+               index % 10000, index, pad, padding);
+      break;
+  }
+}
+
+/**
+ * 生成一种条件下的测试信号：每帧之前插入随机长度的噪声
+ */
+static void generateSignal(const BenchScenario* scenario, const BenchProfile* profile,
+                           uint32_t numFrames, uint32_t seed, BenchSignal* signal) {
+  AFSKGenerator generator;
+  AFSKGeneratorConfig config;
+  uint8_t frame[AX25_MAX_FRAME_LEN];
+  char text[256];
+  std::vector<uint8_t> buffer;
+
+  generator.begin(seed);
+  AFSKGenerator::defaultConfig(&config);
+  config.preambleFlags = scenario->preambleFlags;
+  config.snrDb = scenario->snrDb;
+  config.twistDb = scenario->twistDb;
+  config.driftPpm = scenario->driftPpm;
+  config.jitter = scenario->jitter;
+  config.sampleRate = profile->sampleRate;
+  config.baudRate = profile->baudRate;
+  config.markFreq = profile->markFreq;
+  config.spaceFreq = profile->spaceFreq;
+  config.modulation = profile->modulation;
+  generator.setConfig(&config);
+
+  uint32_t gapMin = profile->sampleRate / BENCH_GAP_MIN_DIV;
+  uint32_t gapMax = profile->sampleRate / BENCH_GAP_MAX_DIV;
+
+  signal->samples.clear();
+  signal->sent.clear();
+
+  uint32_t rng = seed * 2654435761u + 1;
+  for (uint32_t i = 0; i < numFrames; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    uint32_t gap = gapMin + (rng >> 8) % (gapMax - gapMin);
+    size_t pos = signal->samples.size();
+    signal->samples.resize(pos + gap);
+    generator.generateNoise(&signal->samples[pos], gap);
+
+    makePacket(i, text, sizeof(text));
+    uint16_t length = AFSKGenerator::buildFrame(text, frame, sizeof(frame));
+    if (length == 0) {
+      fprintf(stderr, "无法构造测试帧: %s\n", text);
+      continue;
+    }
+    signal->sent[text] = i;
+
+    buffer.resize(generator.getMaxSamples(length));
+    uint32_t count = generator.modulateFrame(frame, length, buffer.data(), (uint32_t)buffer.size());
+    signal->samples.insert(signal->samples.end(), buffer.begin(), buffer.begin() + count);
+  }
+
+  size_t pos = signal->samples.size();
+  signal->samples.resize(pos + gapMin);
+  generator.generateNoise(&signal->samples[pos], gapMin);
+}
+
+/**
+ * 将信号送入解码器，与发送的帧比对
+ */
+template <typename Decoder>
+static void runDecoder(Decoder& decoder, const BenchSignal* signal, BenchResult* result) {
+  std::vector<bool> received(signal->sent.size(), false);
+  std::vector<std::string> decodedText;
+  char line[AX25_MAX_FRAME_LEN * 2];
+  const uint8_t* samples = signal->samples.data();
+  size_t total = signal->samples.size();
+
+  // 计时只包含解码器；帧文本先保存，结束后再比对
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < total; i += BENCH_BLOCK) {
+    size_t n = (total - i < BENCH_BLOCK) ? total - i : BENCH_BLOCK;
+    decoder.processSamples(samples + i, n);
+    while (decoder.available()) {
+      APRS_AX25Frame* frame = decoder.getFrame();
+      if (frame != nullptr && frame->valid) {
+        formatTNC2(frame, line, sizeof(line));
+        decodedText.push_back(line);
+      }
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  result->decoded = 0;
+  result->falseFrames = 0;
+  result->seconds = std::chrono::duration<double>(end - start).count();
+  result->activeWords = 0;
+  result->idleWords = 0;
+
+  for (const std::string& text : decodedText) {
+    auto it = signal->sent.find(text);
+    if (it == signal->sent.end()) {
+      result->falseFrames++;
+    } else if (!received[it->second]) {
+      received[it->second] = true;
+      result->decoded++;
+    }
+  }
+}
+
+// 解码器对象较大，静态分配，每次运行前重新初始化
+static APRSDecoder decoder;
+static APRSMultiDecoder multiDecoder;
+static AFSKDemodulator goertzelDemod;
+static AFSKDemodulatorFixed fixedDemod;
+static AFSKCorrelatorDemodulator corrDemod;
+static AFSKPackedDemodulator packedDemod;
+static AFSKDecimatingDemodulator decimDemod;
+
+/**
+ * 用指定的解码器变体处理信号
+ */
+static void runVariant(uint8_t variant, const BenchProfile* profile, const BenchSignal* signal,
+                       BenchResult* result) {
+  switch (variant) {
+    case VARIANT_GOERTZEL: decoder.setDemodulator(&goertzelDemod); break;
+    case VARIANT_FIXED:    decoder.setDemodulator(&fixedDemod); break;
+    case VARIANT_CORR:     decoder.setDemodulator(&corrDemod); break;
+    case VARIANT_PACKED:   decoder.setDemodulator(&packedDemod); break;
+    case VARIANT_DECIM:
+      decimDemod.setDecimation(BENCH_DECIMATION, BENCH_CIC_ORDER);
+      decoder.setDemodulator(&decimDemod);
+      break;
+    case VARIANT_PROFILE:  decoder.setDemodulator(profile->demod); break;
+    default:
+      multiDecoder.begin();
+      runDecoder(multiDecoder, signal, result);
+      return;
+  }
+
+  decoder.begin();
+  runDecoder(decoder, signal, result);
+
+  ActivityStatistics* activity = decoder.getActivityStatistics();
+  if (activity != nullptr) {
+    result->activeWords = activity->activeWords;
+    result->idleWords = activity->idleWords;
+  }
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr, "用法: %s [-n 帧数] [-S 种子] [-c 条件] [-v 变体] [-p config|1200|1200h|hf300|9600] [-o 文件] [-l] [-G]\n", prog);
+}
+
+int main(int argc, char** argv) {
+  uint32_t numFrames = 100;
+  uint32_t seed = 1;
+  const char* scenarioName = nullptr;
+  const char* variantName = nullptr;
+  const char* outputPath = nullptr;
+  const BenchProfile* profile = &profiles[0];
+  bool checkLimits = true;
+
+  // 解析命令行
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      numFrames = (uint32_t)atol(argv[++i]);
+      if (numFrames == 0) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+      seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+    } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+      scenarioName = argv[++i];
+    } else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc) {
+      variantName = argv[++i];
+    } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+      const char* name = argv[++i];
+      profile = nullptr;
+      for (size_t p = 0; p < NUM_PROFILES; p++) {
+        if (strcmp(name, profiles[p].name) == 0) {
+          profile = &profiles[p];
+        }
+      }
+      if (profile == nullptr) {
+        fprintf(stderr, "未知的调制配置: %s\n", name);
+        return 2;
+      }
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (strcmp(argv[i], "-G") == 0) {
+      checkLimits = false;
+    } else if (strcmp(argv[i], "-l") == 0) {
+      for (size_t s = 0; s < NUM_SCENARIOS; s++) {
+        const BenchScenario* sc = &scenarios[s];
+        printf("%-12s 前导 %2u, 信噪比 ", sc->name, sc->preambleFlags);
+        if (sc->snrDb >= AFSK_GEN_SNR_CLEAN) printf("  -  ");
+        else printf("%4.1f ", sc->snrDb);
+        printf("dB, 失衡 %+5.1f dB, 时钟偏差 %+6.0f ppm, 抖动 %2.0f%%\n",
+               sc->twistDb, sc->driftPpm, sc->jitter * 100);
+      }
+      return 0;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  // 选择条件和变体
+  bool scenarioSelected[NUM_SCENARIOS];
+  bool variantSelected[VARIANT_COUNT];
+  bool found = (scenarioName == nullptr);
+  for (size_t s = 0; s < NUM_SCENARIOS; s++) {
+    scenarioSelected[s] = (scenarioName == nullptr || strcmp(scenarioName, scenarios[s].name) == 0);
+    found = found || scenarioSelected[s];
+  }
+  if (!found) {
+    fprintf(stderr, "未知的条件: %s（-l 列出所有条件）\n", scenarioName);
+    return 2;
+  }
+  bool defaultProfile = isDefaultProfile(profile);
+  found = (variantName == nullptr);
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    variantSelected[v] = (variantName == nullptr || strcmp(variantName, variantNames[v]) == 0);
+    found = found || variantSelected[v];
+    if (!defaultProfile && v != VARIANT_PROFILE) {
+      if (variantSelected[v] && variantName != nullptr) {
+        fprintf(stderr, "变体 %s 只支持默认调制配置\n", variantName);
+        return 2;
+      }
+      variantSelected[v] = false;
+    }
+    if (v == VARIANT_DECIM && !BENCH_DECIM_AVAILABLE) {
+      if (variantSelected[v] && variantName != nullptr) {
+        fprintf(stderr, "采样频率 %u Hz 不能按 %u 抽取\n", (unsigned)AFSK_SAMPLE_RATE, BENCH_DECIMATION);
+        return 2;
+      }
+      variantSelected[v] = false;
+    }
+  }
+  if (!found) {
+    fprintf(stderr, "未知的变体: %s\n", variantName);
+    return 2;
+  }
+
+  FILE* output = nullptr;
+  if (outputPath != nullptr) {
+    output = fopen(outputPath, "wb");
+    if (output == nullptr) {
+      perror(outputPath);
+      return 1;
+    }
+  }
+
+  // 表头
+  printf("%-12s", "条件");
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (variantSelected[v]) {
+      printf(" %10s", variantNames[v]);
+    }
+  }
+  printf("\n");
+
+  BenchTotal totals[VARIANT_COUNT];
+  memset(totals, 0, sizeof(totals));
+  uint32_t totalSent = 0;
+  BenchSignal* signal = new BenchSignal();
+
+  for (size_t s = 0; s < NUM_SCENARIOS; s++) {
+    if (!scenarioSelected[s]) {
+      continue;
+    }
+
+    generateSignal(&scenarios[s], profile, numFrames, seed + (uint32_t)s, signal);
+    uint32_t sent = (uint32_t)signal->sent.size();
+    totalSent += sent;
+    if (output != nullptr) {
+      fwrite(signal->samples.data(), 1, signal->samples.size(), output);
+    }
+
+    printf("%-12s", scenarios[s].name);
+    for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+      if (!variantSelected[v]) {
+        continue;
+      }
+      BenchResult result;
+      runVariant(v, profile, signal, &result);
+      totals[v].decoded += result.decoded;
+      totals[v].falseFrames += result.falseFrames;
+      totals[v].samples += signal->samples.size();
+      totals[v].seconds += result.seconds;
+      totals[v].activeWords += result.activeWords;
+      totals[v].idleWords += result.idleWords;
+
+      char cell[32];
+      snprintf(cell, sizeof(cell), "%u/%u%s", result.decoded, sent, result.falseFrames ? "*" : "");
+      printf(" %10s", cell);
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+
+  delete signal;
+  if (output != nullptr) {
+    fclose(output);
+  }
+
+  // 合计
+  printf("%-12s", "合计");
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (variantSelected[v]) {
+      printf(" %9.1f%%", totalSent ? totals[v].decoded * 100.0 / totalSent : 0.0);
+    }
+  }
+  printf("\n%-12s", "误帧");
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (variantSelected[v]) {
+      printf(" %10u", totals[v].falseFrames);
+    }
+  }
+  printf("\n%-12s", "M采样/秒");
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (variantSelected[v]) {
+      printf(" %10.2f", totals[v].seconds > 0 ? totals[v].samples / totals[v].seconds / 1e6 : 0.0);
+    }
+  }
+  printf("\n%-12s", "活动占比");
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (variantSelected[v]) {
+      uint64_t words = totals[v].activeWords + totals[v].idleWords;
+      if (words > 0) {
+        printf(" %9.1f%%", totals[v].activeWords * 100.0 / words);
+      } else {
+        printf(" %10s", "-");
+      }
+    }
+  }
+  printf("\n");
+  printf("(* 表示出现误帧；吞吐量只计解码器处理时间，实时需要 %.4f M采样/秒)\n",
+         profile->sampleRate / 1e6);
+  printf("(活动占比：活动门控送入解调器的采样比例，- 表示无门控)\n");
+
+  // 回归门限
+  if (!checkLimits || scenarioName != nullptr || numFrames < BENCH_LIMIT_MIN_FRAMES) {
+    return 0;
+  }
+  bool passed = true;
+  for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+    if (!variantSelected[v]) {
+      continue;
+    }
+    float minRate = (v == VARIANT_PROFILE) ? profile->minDecodeRate : variantLimits[v].minDecodeRate;
+    double rate = totalSent ? totals[v].decoded * 100.0 / totalSent : 0.0;
+    if (rate < minRate) {
+      fprintf(stderr, "%s: 解码率 %.1f%% 低于门限 %.1f%%\n", variantNames[v], rate, minRate);
+      passed = false;
+    }
+    if (totals[v].falseFrames > variantLimits[v].maxFalseFrames) {
+      fprintf(stderr, "%s: 误帧 %u 超过门限 %u\n", variantNames[v], totals[v].falseFrames,
+              variantLimits[v].maxFalseFrames);
+      passed = false;
+    }
+  }
+
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+/**
+ * 静态内存预算报告（主机端）
+ *
+ * 按当前配置输出aprs_memory.h中各部分的大小、内存池大小和总量，
+ * 并按固件的方式在内存池中创建各对象，确认内存池恰好容纳全部对象。
+ * 主机上指针为8字节，各项略大于目标上的值；目标上的准确值在固件启动时输出，
+ * 超出预算时固件和本工具都会编译失败。
+ *
+ * 用法: aprs_memory
+ */
+
+#include "aprs_memory.h"
+
+#include <stdio.h>
+
+static StaticArena<memoryArenaSize()> memoryArena;
+
+int main() {
+  // 与固件相同的分配顺序
+  bool ok = memoryArena.create<APRSDecoderType>() != nullptr;
+#if DUP_FILTER_ENABLE
+  ok = ok && memoryArena.create<DuplicateFilter>() != nullptr;
+#endif
+#if USE_SAMPLE_RING
+  ok = ok && memoryArena.create<SampleRing>() != nullptr;
+#endif
+#if USE_DMA_CAPTURE
+  ok = ok && memoryArena.allocate(DMA_CAPTURE_BUFFER_SIZE) != nullptr;
+#endif
+
+  printf("解码器类型: %s\n", DECODER_TYPE);
+  for (size_t i = 0; i < MEMORY_BUDGET_ENTRIES; i++) {
+    printf("  %7u 字节  %s%s\n", (unsigned)memoryBudget[i].bytes, memoryBudget[i].name,
+           memoryBudget[i].arena ? "（内存池）" : "");
+  }
+  printf("内存池: %u/%u 字节\n", (unsigned)memoryArena.getUsed(), (unsigned)memoryArena.getSize());
+  printf("合计: %u/%u 字节 (%.1f%%)\n", (unsigned)memoryBudgetTotal(), (unsigned)MEMORY_BUDGET_BYTES,
+         memoryBudgetTotal() * 100.0 / MEMORY_BUDGET_BYTES);
+
+  if (!ok || memoryArena.getUsed() != memoryArena.getSize()) {
+    fprintf(stderr, "内存池大小与分配不一致\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,807 @@
+/**
+ * APRS采样回放工具（主机端）
+ *
+ * 通过mmap映射录制的DIO2采样文件或PCM WAV文件，
+ * 逐个采样送入APRSDecoder，无中间拷贝。
+ *
+ * 支持的输入格式：
+ * - raw8: 每字节一个采样（>= 阈值视为1）
+ * - raw1: 每字节8个采样，MSB先行
+ * - wav:  PCM WAV（8位无符号或16位有符号，多声道时取第一声道）
+ *
+ * 解码帧以TNC2格式（SOURCE>DEST,PATH:INFO）输出到stdout，
+ * 统计信息输出到stderr。
+ *
+ * raw8格式且阈值为1时（采样已是0/1），直接以数据块调用
+ * APRSDecoder::processSamples；-s 强制使用逐采样接口以便对比。
+ * -c 不解码，而是逐比特对比浮点与定点Goertzel解调器的判决结果。
+ * -d 在运行时选择解调器: goertzel（浮点）、fixed（定点）、corr（滑动窗口相关）、
+ *    packed（位压缩相关）、decim（CIC抽取前端 + 相关，抽取因子见REPLAY_DECIMATION）、
+ *    g3ruh（9600波特基带，采样率G3RUH_SAMPLE_RATE）。
+ * -p 将采样打包为32位字后通过processPackedSamples送入解码器（与ISR打包路径一致，
+ *    末尾不足32个的采样被丢弃）。
+ * -r 由独立的生产者线程把压缩采样写入SampleRing，主线程通过processRing解码，
+ *    模拟采样中断与loop()之间的环形缓冲区（生产者在缓冲区满时等待，不丢弃采样）。
+ * -g 经模拟的DMA采样路径（HostDMASimulator）送入解码器：采样按定时器触发的顺序写入
+ *    GPIO输入寄存器的循环缓冲区（其他引脚位为随机数据），半区中断打包后通过
+ *    processPackedSamples解码，与USE_DMA_CAPTURE的固件路径一致（末尾不足半区的采样被丢弃）。
+ * -m N 使用N个并行判决器（APRSMultiDecoder），并输出各判决器的贡献统计。
+ * -a 在每帧之后输出APRSPacket解码出的字段（以"  "缩进）。
+ * -u BAUD 解码帧经由UARTTxRing和模拟的UART输出：UART按音频时间以BAUD波特率
+ *    （8N1）逐块取出数据（与DMA发送相同的startBlock/endBlock流程），
+ *    统计发送缓冲区的最大占用和丢弃的行数。
+ * -k PORT 以KISS二进制帧（端口号PORT）代替TNC2文本输出到stdout。
+ * -D MS 启用重复帧抑制（时间窗口MS毫秒，按音频时间计），输出被抑制的帧数。
+ *
+ * 以 -DAPRS_PROFILE=ON 构建时，结束后输出各处理阶段的耗时统计（纳秒）。
+ *
+ * 用法: aprs_replay [-f raw8|raw1|wav] [-t 阈值] [-s] [-c] [-d goertzel|fixed|corr|packed|decim|g3ruh] [-p] [-r] [-g] [-m N] [-a] [-u BAUD] [-k PORT] [-D MS] <文件>
+ */
+
+#include "aprs_decoder.h"
+#include "afsk_demod_fixed.h"
+#include "g3ruh_demod.h"
+#include "afsk_decimating.h"
+#include "aprs_multi_decoder.h"
+#include "aprs_format.h"
+#include "aprs_packet.h"
+#include "uart_tx_ring.h"
+#include "dup_filter.h"
+#include "dma_capture.h"
+#include "aprs_profile.h"
+
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <functional>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// 批量接口每次处理的采样数
+#define REPLAY_BLOCK    256
+
+// -g 模拟的采样引脚在输入寄存器字节中的位置（DIO2 = PA3）
+#define REPLAY_DMA_PIN_BIT  3
+
+// -d decim的抽取因子（AFSK_DECIMATION > 1时与之相同）
+#define REPLAY_DECIMATION  (AFSK_DECIMATION > 1 ? AFSK_DECIMATION : 2)
+
+// 输入格式
+enum InputFormat {
+  FORMAT_AUTO,
+  FORMAT_RAW8,
+  FORMAT_RAW1,
+  FORMAT_WAV
+};
+
+// WAV数据描述
+typedef struct {
+  const uint8_t* data;      // PCM数据起始
+  size_t dataLen;           // PCM数据长度（字节）
+  uint16_t channels;        // 声道数
+  uint16_t bitsPerSample;   // 8或16
+  uint32_t sampleRate;      // 采样率
+} WavInfo;
+
+static uint16_t readLE16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t readLE32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * 解析WAV文件头
+ * @return 成功返回true
+ */
+static bool parseWav(const uint8_t* file, size_t len, WavInfo* info) {
+  if (len < 12 || memcmp(file, "RIFF", 4) != 0 || memcmp(file + 8, "WAVE", 4) != 0) {
+    return false;
+  }
+
+  bool haveFormat = false;
+  size_t pos = 12;
+
+  // 遍历RIFF块
+  while (pos + 8 <= len) {
+    const uint8_t* chunk = file + pos;
+    uint32_t chunkLen = readLE32(chunk + 4);
+    const uint8_t* body = chunk + 8;
+    size_t available = len - pos - 8;
+
+    if (memcmp(chunk, "fmt ", 4) == 0 && chunkLen >= 16 && available >= 16) {
+      uint16_t audioFormat = readLE16(body);
+      info->channels = readLE16(body + 2);
+      info->sampleRate = readLE32(body + 4);
+      info->bitsPerSample = readLE16(body + 14);
+
+      if (audioFormat != 1 || info->channels == 0 ||
+          (info->bitsPerSample != 8 && info->bitsPerSample != 16)) {
+        fprintf(stderr, "不支持的WAV格式（仅支持8/16位PCM）\n");
+        return false;
+      }
+      haveFormat = true;
+    } else if (memcmp(chunk, "data", 4) == 0 && haveFormat) {
+      info->data = body;
+      info->dataLen = (chunkLen < available) ? chunkLen : available;
+      return true;
+    }
+
+    // 块按偶数字节对齐
+    pos += 8 + (size_t)chunkLen + (chunkLen & 1);
+  }
+
+  return false;
+}
+
+// 是否输出APRS字段（-a）
+static bool printPacket = false;
+
+// KISS输出端口（-k），负数表示输出TNC2文本
+static int kissPort = -1;
+
+// 已送入解码器的采样数（模拟UART的时间基准）
+static std::atomic<uint64_t> samplesFed(0);
+
+// 采样率（由所选解调器决定）
+static uint32_t sampleRate = AFSK_SAMPLE_RATE;
+
+/**
+ * 模拟UART（-u）
+ * 以音频时间为时钟，按波特率从发送环形缓冲区逐块取出数据写到stdout，
+ * 每块最多UART_SIM_BLOCK字节，块内字节全部发出后才释放（与DMA传输完成中断一致）
+ */
+#define UART_SIM_BLOCK  64
+
+class SimulatedUART {
+public:
+  SimulatedUART() {
+    baudrate = 0;
+    lastSample = 0;
+    credit = 0;
+    block = nullptr;
+    blockLen = 0;
+    blockPos = 0;
+  }
+
+  void begin(uint32_t baud) {
+    baudrate = baud;
+  }
+
+  bool enabled() {
+    return baudrate != 0;
+  }
+
+  /**
+   * 推进到指定的采样时刻，发出这段时间内能够发送的字节
+   */
+  void advance(UARTTxRing& ring, uint64_t now) {
+    // credit单位：比特 × 采样率；每字节10比特（8N1）
+    credit += (now - lastSample) * baudrate;
+    lastSample = now;
+
+    const uint64_t byteCost = 10ULL * sampleRate;
+    while (credit >= byteCost) {
+      if (blockLen == 0) {
+        blockLen = ring.startBlock(&block, UART_SIM_BLOCK);
+        blockPos = 0;
+        if (blockLen == 0) {
+          credit = 0;                     // 空闲时不积累发送时间
+          return;
+        }
+      }
+      putchar(block[blockPos++]);
+      credit -= byteCost;
+      if (blockPos == blockLen) {
+        ring.endBlock();
+        blockLen = 0;
+      }
+    }
+  }
+
+  /**
+   * 输入结束后继续运行到发送缓冲区为空
+   */
+  void drain(UARTTxRing& ring) {
+    while (ring.isBusy()) {
+      advance(ring, lastSample + sampleRate / 100);
+    }
+  }
+
+protected:
+  uint32_t baudrate;
+  uint64_t lastSample;
+  uint64_t credit;
+  const uint8_t* block;
+  uint16_t blockLen;
+  uint16_t blockPos;
+};
+
+static UARTTxRing uartRing;
+static SimulatedUART uartSim;
+
+// 重复帧抑制（-D）
+static DuplicateFilter dupFilter;
+static bool dupFilterEnabled = false;
+
+/**
+ * 输出APRS信息字段的解码结果
+ */
+static void printPacketFields(const APRS_AX25Frame* frame) {
+  static const char* const typeNames[] = {
+    "unknown", "position", "mic-e", "message", "object", "item", "weather", "telemetry", "status"
+  };
+  APRSPacket packet;
+  APRSPosition position;
+  APRSMessage message;
+  APRSObject object;
+  APRSWeather weather;
+  APRSTelemetry telemetry;
+  const char* text;
+  uint16_t len;
+  int32_t altitude;
+
+  packet.parse(frame);
+  printf("  type=%s", typeNames[packet.getType()]);
+
+  if (packet.getObject(&object)) {
+    printf(" name=\"%.*s\" %s", object.nameLen, object.name, object.alive ? "alive" : "killed");
+  }
+  if (packet.getPosition(&position)) {
+    printf(" lat=%.6f lon=%.6f sym=%c%c", position.latitude / 1e6, position.longitude / 1e6,
+           position.symbolTable, position.symbolCode);
+    if (position.ambiguity) {
+      printf(" ambiguity=%u", position.ambiguity);
+    }
+    if (position.hasCourseSpeed) {
+      printf(" course=%u speed=%u", position.course, position.speed);
+    }
+  }
+  if (packet.getAltitude(&altitude)) {
+    printf(" alt=%ldft", (long)altitude);
+  }
+  if (packet.getMessage(&message)) {
+    static const char* const kinds[] = { "text", "ack", "rej" };
+    printf(" to=\"%.*s\" kind=%s text=\"%.*s\" id=\"%.*s\"", message.addresseeLen, message.addressee,
+           kinds[message.kind], message.textLen, message.text, message.idLen, message.id ? message.id : "");
+  }
+  if (packet.getWeather(&weather)) {
+    printf(" wx=0x%03x", weather.fields);
+    if (weather.fields & APRS_WX_WIND_DIR) printf(" wind=%u", weather.windDirection);
+    if (weather.fields & APRS_WX_WIND_SPEED) printf("/%umph", weather.windSpeed);
+    if (weather.fields & APRS_WX_WIND_GUST) printf(" gust=%u", weather.windGust);
+    if (weather.fields & APRS_WX_TEMPERATURE) printf(" temp=%dF", weather.temperature);
+    if (weather.fields & APRS_WX_HUMIDITY) printf(" hum=%u%%", weather.humidity);
+    if (weather.fields & APRS_WX_PRESSURE) printf(" baro=%u", weather.pressure);
+    if (weather.fields & APRS_WX_RAIN_1H) printf(" rain1h=%u", weather.rain1h);
+  }
+  if (packet.getTelemetry(&telemetry)) {
+    printf(" seq=%u analog=", telemetry.sequence);
+    for (uint8_t i = 0; i < telemetry.numAnalog; i++) {
+      printf("%s%.3f", i ? "," : "", telemetry.analog[i] / 1000.0);
+    }
+    if (telemetry.hasDigital) {
+      printf(" digital=0x%02x", telemetry.digital);
+    }
+  }
+  if (packet.getComment(&text, &len) && len > 0) {
+    printf(" comment=\"%.*s\"", len, text);
+  }
+  putchar('\n');
+}
+
+/**
+ * 输出所有已解码的帧
+ */
+template <typename Decoder>
+static void drainFrames(Decoder& decoder, uint32_t& frames) {
+  uint8_t buffer[KISS_MAX_ENCODED_LEN];
+  char* line = (char*)buffer;
+
+  while (decoder.available()) {
+    APRS_AX25Frame* frame = decoder.getFrame();
+    if (frame != nullptr && frame->valid) {
+      if (dupFilterEnabled) {
+        uint32_t nowMs = (uint32_t)(samplesFed.load(std::memory_order_relaxed) * 1000 / sampleRate);
+        if (dupFilter.isDuplicate(frame, nowMs)) {
+          continue;
+        }
+      }
+      if (kissPort >= 0) {
+        uint16_t len = formatKISS(frame, (uint8_t)kissPort, buffer, sizeof(buffer));
+        if (uartSim.enabled()) {
+          uartRing.write(buffer, len);
+        } else {
+          fwrite(buffer, 1, len, stdout);
+        }
+      } else {
+        uint16_t len = formatTNC2(frame, line, sizeof(buffer));
+        if (uartSim.enabled()) {
+          uartRing.write(buffer, len, (const uint8_t*)"\n", 1);
+        } else {
+          puts(line);
+        }
+      }
+      if (printPacket && !uartSim.enabled() && kissPort < 0) {
+        printPacketFields(frame);
+      }
+      frames++;
+    }
+  }
+
+  if (uartSim.enabled()) {
+    uartSim.advance(uartRing, samplesFed.load(std::memory_order_relaxed));
+  }
+}
+
+/**
+ * 按输入格式逐个取出采样（0或1）并调用fn
+ * @return 采样总数
+ */
+template <typename Fn>
+static uint64_t forEachSample(InputFormat format, const uint8_t* file, size_t fileLen,
+                              const WavInfo& wav, unsigned threshold, Fn fn) {
+  switch (format) {
+    case FORMAT_RAW8:
+    case FORMAT_AUTO:
+      for (size_t i = 0; i < fileLen; i++) {
+        fn(file[i] >= threshold ? 1 : 0);
+      }
+      return fileLen;
+
+    case FORMAT_RAW1:
+      for (size_t i = 0; i < fileLen; i++) {
+        uint8_t byte = file[i];
+        for (int b = 7; b >= 0; b--) {
+          fn((byte >> b) & 1);
+        }
+      }
+      return (uint64_t)fileLen * 8;
+
+    case FORMAT_WAV: {
+      size_t stride = (size_t)wav.channels * (wav.bitsPerSample / 8);
+      size_t count = wav.dataLen / stride;
+      const uint8_t* p = wav.data;
+
+      if (wav.bitsPerSample == 8) {
+        // 8位PCM为无符号，128为零点
+        for (size_t i = 0; i < count; i++, p += stride) {
+          fn(p[0] >= 128 ? 1 : 0);
+        }
+      } else {
+        // 16位PCM为有符号小端，按符号位限幅
+        for (size_t i = 0; i < count; i++, p += stride) {
+          fn((p[1] & 0x80) ? 0 : 1);
+        }
+      }
+      return count;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * 将整个输入送入解码器并输出解码帧
+ * @return 采样总数
+ */
+template <typename Decoder>
+static uint64_t runDecoder(Decoder& decoder, InputFormat format, const uint8_t* file,
+                           size_t fileLen, const WavInfo& wav, unsigned threshold,
+                           bool perSample, uint32_t& frames) {
+  if ((format == FORMAT_RAW8 || format == FORMAT_AUTO) && threshold == 1 && !perSample) {
+    // 采样已是0/1：按块直接送入批量接口
+    for (size_t i = 0; i < fileLen; i += REPLAY_BLOCK) {
+      size_t n = (fileLen - i < REPLAY_BLOCK) ? fileLen - i : REPLAY_BLOCK;
+      decoder.processSamples(file + i, n);
+      samplesFed += n;
+      drainFrames(decoder, frames);
+    }
+    return fileLen;
+  }
+
+  return forEachSample(format, file, fileLen, wav, threshold, [&](uint8_t sample) {
+    decoder.processSample(sample);
+    samplesFed++;
+    drainFrames(decoder, frames);
+  });
+}
+
+/**
+ * 将采样打包为32位字后按块送入解码器的位压缩接口
+ * @return 采样总数
+ */
+template <typename Decoder>
+static uint64_t runPacked(Decoder& decoder, InputFormat format, const uint8_t* file,
+                          size_t fileLen, const WavInfo& wav, unsigned threshold,
+                          uint32_t& frames) {
+  uint32_t words[REPLAY_BLOCK / PACKED_SAMPLES_PER_WORD];
+  uint16_t numWords = 0;
+  SamplePacker packer = { 0, 0 };
+
+  uint64_t samples = forEachSample(format, file, fileLen, wav, threshold, [&](uint8_t sample) {
+    if (packSample(&packer, sample)) {
+      words[numWords++] = packer.word;
+      if (numWords == REPLAY_BLOCK / PACKED_SAMPLES_PER_WORD) {
+        decoder.processPackedSamples(words, numWords);
+        samplesFed += numWords * PACKED_SAMPLES_PER_WORD;
+        drainFrames(decoder, frames);
+        numWords = 0;
+      }
+    }
+  });
+
+  if (numWords > 0) {
+    decoder.processPackedSamples(words, numWords);
+    samplesFed += numWords * PACKED_SAMPLES_PER_WORD;
+    drainFrames(decoder, frames);
+  }
+
+  return samples;
+}
+
+/**
+ * 生产者线程打包采样并写入环形缓冲区，调用线程排空缓冲区并解码
+ * @return 采样总数
+ */
+template <typename Decoder>
+static uint64_t runRing(Decoder& decoder, InputFormat format, const uint8_t* file,
+                        size_t fileLen, const WavInfo& wav, unsigned threshold,
+                        uint32_t& frames) {
+  SampleRing ring;
+  std::atomic<bool> done(false);
+  uint64_t samples = 0;
+
+  std::thread producer([&]() {
+    SamplePacker packer = { 0, 0 };
+    samples = forEachSample(format, file, fileLen, wav, threshold, [&](uint8_t sample) {
+      if (packSample(&packer, sample)) {
+        // 回放时不丢弃采样：等待消费者腾出空间
+        while (ring.available() >= SAMPLE_RING_WORDS) {
+          std::this_thread::yield();
+        }
+        ring.push(packer.word);
+        samplesFed += PACKED_SAMPLES_PER_WORD;
+      }
+    });
+    done.store(true, std::memory_order_release);
+  });
+
+  for (;;) {
+    bool finished = done.load(std::memory_order_acquire);
+    decoder.processRing(&ring);
+    drainFrames(decoder, frames);
+    if (finished && ring.available() == 0) {
+      break;
+    }
+    if (ring.available() == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  return samples;
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr, "用法: %s [-f raw8|raw1|wav] [-t 阈值] [-s] [-c] [-d goertzel|fixed|corr|packed|decim|g3ruh] [-p] [-r] [-g] [-m N] [-a] [-u BAUD] [-k PORT] [-D MS] <文件>\n", prog);
+}
+
+// DMA半区回调转发到当前的解码器
+static std::function<void(const uint32_t*, uint16_t)> dmaSink;
+
+static void dmaCaptureCallback(const uint32_t* words, uint16_t count) {
+  dmaSink(words, count);
+}
+
+/**
+ * 经模拟的DMA采样路径送入解码器
+ * @return 采样总数
+ */
+template <typename Decoder>
+static uint64_t runDMA(Decoder& decoder, InputFormat format, const uint8_t* file,
+                       size_t fileLen, const WavInfo& wav, unsigned threshold,
+                       uint32_t& frames, DMACaptureStatistics* dmaStats) {
+  static uint8_t captureBuffer[DMA_CAPTURE_BUFFER_SIZE];
+  HostDMASimulator dma;
+  uint8_t block[REPLAY_BLOCK];
+  uint16_t n = 0;
+
+  dmaSink = [&](const uint32_t* words, uint16_t count) {
+    decoder.processPackedSamples(words, count);
+    samplesFed += count * PACKED_SAMPLES_PER_WORD;
+    drainFrames(decoder, frames);
+  };
+  dma.begin(captureBuffer, sizeof(captureBuffer), REPLAY_DMA_PIN_BIT, dmaCaptureCallback);
+
+  uint64_t samples = forEachSample(format, file, fileLen, wav, threshold, [&](uint8_t sample) {
+    block[n++] = sample;
+    if (n == REPLAY_BLOCK) {
+      dma.feed(block, n);
+      n = 0;
+    }
+  });
+  dma.feed(block, n);
+
+  *dmaStats = *dma.getStatistics();
+  return samples;
+}
+
+int main(int argc, char** argv) {
+  InputFormat format = FORMAT_AUTO;
+  unsigned threshold = 1;
+  bool perSample = false;
+  bool compareFixed = false;
+  bool packed = false;
+  bool ring = false;
+  bool dmaCapture = false;
+  const char* demodName = nullptr;
+  unsigned numSlicers = 0;
+  unsigned uartBaud = 0;
+  const char* path = nullptr;
+
+  // 解析命令行
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+      const char* name = argv[++i];
+      if (strcmp(name, "raw8") == 0) format = FORMAT_RAW8;
+      else if (strcmp(name, "raw1") == 0) format = FORMAT_RAW1;
+      else if (strcmp(name, "wav") == 0) format = FORMAT_WAV;
+      else { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      threshold = (unsigned)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-s") == 0) {
+      perSample = true;
+    } else if (strcmp(argv[i], "-r") == 0) {
+      ring = true;
+    } else if (strcmp(argv[i], "-p") == 0) {
+      packed = true;
+    } else if (strcmp(argv[i], "-g") == 0) {
+      dmaCapture = true;
+    } else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc) {
+      uartBaud = (unsigned)atoi(argv[++i]);
+      if (uartBaud == 0) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-D") == 0 && i + 1 < argc) {
+      dupFilter.setWindow((uint32_t)atol(argv[++i]));
+      dupFilterEnabled = true;
+    } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+      kissPort = atoi(argv[++i]);
+      if (kissPort < 0 || kissPort > 15) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-a") == 0) {
+      printPacket = true;
+    } else if (strcmp(argv[i], "-c") == 0) {
+      compareFixed = true;
+    } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      numSlicers = (unsigned)atoi(argv[++i]);
+      if (numSlicers == 0 || numSlicers > MULTI_SLICER_MAX) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      demodName = argv[++i];
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      path = argv[i];
+    }
+  }
+
+  if (path == nullptr) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // 映射输入文件
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return 1;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    fprintf(stderr, "%s: 空文件\n", path);
+    close(fd);
+    return 1;
+  }
+
+  size_t fileLen = (size_t)st.st_size;
+  void* mapped = mmap(nullptr, fileLen, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  madvise(mapped, fileLen, MADV_SEQUENTIAL);
+
+  const uint8_t* file = (const uint8_t*)mapped;
+
+  // 自动识别格式
+  WavInfo wav;
+  memset(&wav, 0, sizeof(wav));
+  if (format == FORMAT_AUTO) {
+    format = parseWav(file, fileLen, &wav) ? FORMAT_WAV : FORMAT_RAW8;
+  } else if (format == FORMAT_WAV && !parseWav(file, fileLen, &wav)) {
+    fprintf(stderr, "%s: 无效的WAV文件\n", path);
+    munmap(mapped, fileLen);
+    return 1;
+  }
+
+  APRSDecoder decoder;
+  decoder.begin();
+
+  APRSMultiDecoder multiDecoder;
+  if (numSlicers > 0) {
+    multiDecoder.begin((uint8_t)numSlicers);
+  }
+
+  // 运行时选择解调器
+  AFSKDemodulator goertzelDemod;
+  AFSKDemodulatorFixed fixedDemod;
+  AFSKCorrelatorDemodulator corrDemod;
+  AFSKPackedDemodulator packedDemod;
+  AFSKDecimatingDemodulator decimDemod;
+  G3RUHDemodulator g3ruhDemod;
+  decimDemod.setDecimation(REPLAY_DECIMATION, AFSK_CIC_ORDER);
+  if (demodName != nullptr) {
+    AFSKDemodulator* demod = nullptr;
+    if (strcmp(demodName, "goertzel") == 0) demod = &goertzelDemod;
+    else if (strcmp(demodName, "fixed") == 0) demod = &fixedDemod;
+    else if (strcmp(demodName, "corr") == 0) demod = &corrDemod;
+    else if (strcmp(demodName, "packed") == 0) demod = &packedDemod;
+    else if (strcmp(demodName, "decim") == 0) demod = &decimDemod;
+    else if (strcmp(demodName, "g3ruh") == 0) demod = &g3ruhDemod;
+    else {
+      usage(argv[0]);
+      munmap(mapped, fileLen);
+      return 2;
+    }
+    if (demod == &decimDemod && !decimDemod.begin()) {
+      fprintf(stderr, "采样频率 %u Hz 不能按 %u 抽取\n", (unsigned)AFSK_SAMPLE_RATE,
+              (unsigned)REPLAY_DECIMATION);
+      munmap(mapped, fileLen);
+      return 2;
+    }
+    decoder.setDemodulator(demod);
+    sampleRate = demod->getSampleRate();
+  }
+
+  if (format == FORMAT_WAV && wav.sampleRate != sampleRate) {
+    fprintf(stderr, "警告: WAV采样率 %u Hz 与解码器采样率 %u Hz 不一致\n",
+            wav.sampleRate, sampleRate);
+  }
+
+  uint64_t samples = 0;
+  DMACaptureStatistics dmaStats = { 0, 0 };
+  uint32_t frames = 0;
+
+  uartSim.begin(uartBaud);
+#if APRS_PROFILE
+  aprsProfileBegin();
+#endif
+
+  auto start = std::chrono::steady_clock::now();
+
+  if (compareFixed) {
+    // 浮点与定点解调器逐比特对比
+    AFSKDemodulator floatDemod;
+    AFSKDemodulatorFixed fixedPointDemod;
+    floatDemod.begin();
+    fixedPointDemod.begin();
+
+    uint64_t decisions = 0;
+    uint64_t mismatches = 0;
+    uint64_t firstMismatch = 0;
+
+    samples = forEachSample(format, file, fileLen, wav, threshold, [&](uint8_t sample) {
+      bool floatReady = floatDemod.processSample(sample);
+      bool fixedReady = fixedPointDemod.processSample(sample);
+      if (floatReady || fixedReady) {
+        decisions++;
+        if (floatReady != fixedReady ||
+            floatDemod.getDemodulatedBit() != fixedPointDemod.getDemodulatedBit()) {
+          if (mismatches == 0) firstMismatch = decisions;
+          mismatches++;
+        }
+      }
+    });
+
+    fprintf(stderr, "比特判决: %llu, 不一致: %llu",
+            (unsigned long long)decisions, (unsigned long long)mismatches);
+    if (mismatches > 0) {
+      fprintf(stderr, " (首个不一致: 第%llu个比特)", (unsigned long long)firstMismatch);
+    }
+    fprintf(stderr, "\n");
+  } else if (numSlicers > 0 && dmaCapture) {
+    samples = runDMA(multiDecoder, format, file, fileLen, wav, threshold, frames, &dmaStats);
+  } else if (numSlicers > 0 && ring) {
+    samples = runRing(multiDecoder, format, file, fileLen, wav, threshold, frames);
+  } else if (numSlicers > 0 && packed) {
+    samples = runPacked(multiDecoder, format, file, fileLen, wav, threshold, frames);
+  } else if (numSlicers > 0) {
+    samples = runDecoder(multiDecoder, format, file, fileLen, wav, threshold, perSample, frames);
+  } else if (dmaCapture) {
+    samples = runDMA(decoder, format, file, fileLen, wav, threshold, frames, &dmaStats);
+  } else if (ring) {
+    samples = runRing(decoder, format, file, fileLen, wav, threshold, frames);
+  } else if (packed) {
+    samples = runPacked(decoder, format, file, fileLen, wav, threshold, frames);
+  } else {
+    samples = runDecoder(decoder, format, file, fileLen, wav, threshold, perSample, frames);
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  uartSim.drain(uartRing);
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  munmap(mapped, fileLen);
+
+  // 统计信息
+  DecoderStatistics* stats = (numSlicers > 0) ? multiDecoder.getStatistics()
+                                              : decoder.getStatistics();
+  double audioSeconds = (double)samples / sampleRate;
+
+  fprintf(stderr, "采样数: %llu (%.1f 秒音频)\n", (unsigned long long)samples, audioSeconds);
+  fprintf(stderr, "处理时间: %.3f 秒\n", seconds);
+  if (seconds > 0) {
+    fprintf(stderr, "吞吐量: %.0f 采样/秒 (%.1fx 实时)\n",
+            samples / seconds, audioSeconds / seconds);
+  }
+  fprintf(stderr, "解码帧数: %u\n", frames);
+  fprintf(stderr, "CRC错误: %u\n", stats->framesCRCError);
+  fprintf(stderr, "比特修复: %u, 放弃 %u\n", stats->framesFixed, stats->framesRepairAbandoned);
+  if (dupFilterEnabled) {
+    DupFilterStatistics* dup = dupFilter.getStatistics();
+    fprintf(stderr, "重复抑制: %u/%u 帧, 提前替换 %u\n", dup->duplicates, dup->framesChecked, dup->evictions);
+  }
+  if (uartSim.enabled()) {
+    UARTTxStatistics* tx = uartRing.getStatistics();
+    fprintf(stderr, "UART发送: %u 字节, 丢弃 %u 行 (%u 字节), 最大占用 %u/%u 字节\n",
+            tx->bytesSent, tx->writesDropped, tx->bytesDropped,
+            tx->highWater, (unsigned)UART_TX_RING_SIZE);
+    fprintf(stderr, "阻塞发送将占用: %.2f 秒\n", tx->bytesQueued * 10.0 / uartBaud);
+  }
+  if (dmaCapture) {
+    fprintf(stderr, "DMA采样: %u 半区, 溢出 %u\n", dmaStats.halfTransfers, dmaStats.overruns);
+  }
+  ActivityStatistics* activity = decoder.getActivityStatistics();
+  if (numSlicers == 0 && activity != nullptr) {
+    fprintf(stderr, "活动门控: 活动 %u 字, 空闲 %u 字 (占空比 %u%%), 唤醒 %u 次, 中途关闭放弃 %u 帧\n",
+            activity->activeWords, activity->idleWords, decoder.getDutyCycle(), activity->wakeups,
+            stats->gateAbortedFrames);
+  }
+  if (ring) {
+    fprintf(stderr, "环形缓冲区: 最大占用 %u/%u 字, 溢出 %u 字\n",
+            stats->ringHighWater, (unsigned)SAMPLE_RING_WORDS, stats->sampleOverflows);
+  }
+
+#if APRS_PROFILE
+  // 各阶段耗时：平均值为每个数据单位，百分位数和最大值为单次调用
+  fprintf(stderr, "%-9s %10s %12s %10s %10s %10s %10s\n",
+          "阶段", "调用", "平均/单位", "平均/次", "p50", "p99", "最大");
+  for (uint8_t i = 0; i < PROFILE_STAGE_COUNT; i++) {
+    ProfileSummary summary;
+    aprsProfileGetSummary(i, &summary);
+    if (summary.calls == 0) {
+      continue;
+    }
+    fprintf(stderr, "%-9s %10u %12.2f %10u %10u %10u %10u\n",
+            aprsProfileStageName(i), summary.calls, summary.cyclesPerItemX100 / 100.0,
+            summary.avgCycles, summary.p50Cycles, summary.p99Cycles, summary.maxCycles);
+  }
+  fprintf(stderr, "(单位: %s, 采样中断预算 %u)\n", PROFILE_UNIT, (unsigned)PROFILE_ISR_BUDGET);
+#endif
+
+  // 各判决器的贡献
+  for (uint8_t i = 0; i < numSlicers; i++) {
+    SlicerStatistics* ss = multiDecoder.getSlicerStatistics(i);
+    fprintf(stderr, "判决器 %u: 解出 %u, 最先 %u, 独有 %u\n",
+            i, ss->framesDecoded, ss->framesFirst, ss->framesUnique);
+  }
+
+  return 0;
+}
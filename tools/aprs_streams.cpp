@@ -0,0 +1,235 @@
+/**
+ * 多通道并发解码（主机端）
+ *
+ * 将多个DIO2采样文件（raw8，每字节一个采样，非0视为1）作为独立通道，
+ * 由APRSStreamEngine在工作线程池上并发解码，按采样位置合并输出：
+ *
+ *   [通道号] SOURCE>DEST,PATH:INFO
+ *
+ * 各文件先打包为32位采样字（不计入处理时间），再由主线程按通道轮流送入，
+ * 模拟各通道同步到达的实时输入。
+ *
+ * -n N 通道数（文件按顺序循环分配给各通道，用一个文件即可测试N个通道）
+ * -w N 工作线程数（默认为硬件线程数）
+ * -d 解调器: goertzel、fixed、corr、packed、g3ruh（每个通道独立的实例）
+ * -q 不输出帧，只输出统计（用于测量吞吐量随线程数的变化）
+ *
+ * 以 -DAPRS_PROFILE=ON 构建时，结束后输出所有工作线程合计的各阶段耗时（纳秒）。
+ *
+ * 用法: aprs_streams [-n 通道数] [-w 线程数] [-d goertzel|fixed|corr|packed|g3ruh] [-q] <文件>...
+ */
+
+#include "aprs_stream_engine.h"
+#include "afsk_demod_fixed.h"
+#include "g3ruh_demod.h"
+#include "aprs_format.h"
+#include "aprs_profile.h"
+
+#include <chrono>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/**
+ * 读取raw8文件并打包为采样字（末尾不足32个的采样被丢弃）
+ */
+static bool loadPacked(const char* path, std::vector<uint32_t>* words) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) {
+    perror(path);
+    return false;
+  }
+
+  SamplePacker packer = { 0, 0 };
+  uint8_t buffer[65536];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+    for (size_t i = 0; i < n; i++) {
+      if (packSample(&packer, buffer[i] ? 1 : 0)) {
+        words->push_back(packer.word);
+      }
+    }
+  }
+  fclose(f);
+  return true;
+}
+
+/**
+ * 创建指定类型的解调器
+ */
+static AFSKDemodulator* createDemodulator(const char* name) {
+  if (strcmp(name, "goertzel") == 0) return new AFSKDemodulator();
+  if (strcmp(name, "fixed") == 0) return new AFSKDemodulatorFixed();
+  if (strcmp(name, "corr") == 0) return new AFSKCorrelatorDemodulator();
+  if (strcmp(name, "packed") == 0) return new AFSKPackedDemodulator();
+  if (strcmp(name, "g3ruh") == 0) return new G3RUHDemodulator();
+  return nullptr;
+}
+
+/**
+ * 输出已合并的帧
+ * @return 输出的帧数
+ */
+static uint32_t drainFrames(APRSStreamEngine& engine, bool wait, bool quiet) {
+  StreamFrame out;
+  char line[AX25_MAX_FRAME_LEN * 2];
+  uint32_t frames = 0;
+
+  while (engine.getFrame(&out, wait)) {
+    if (!quiet) {
+      formatTNC2(&out.frame, line, sizeof(line));
+      printf("[%u] %s\n", out.channel, line);
+    }
+    frames++;
+  }
+  return frames;
+}
+
+static void usage(const char* prog) {
+  fprintf(stderr, "用法: %s [-n 通道数] [-w 线程数] [-d goertzel|fixed|corr|packed|g3ruh] [-q] <文件>...\n", prog);
+}
+
+int main(int argc, char** argv) {
+  unsigned numChannels = 0;
+  unsigned numWorkers = 0;
+  const char* demodName = nullptr;
+  bool quiet = false;
+  std::vector<const char*> paths;
+
+  // 解析命令行
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      numChannels = (unsigned)atoi(argv[++i]);
+      if (numChannels == 0 || numChannels > 65535) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+      numWorkers = (unsigned)atoi(argv[++i]);
+      if (numWorkers == 0 || numWorkers > 1024) { usage(argv[0]); return 2; }
+    } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+      demodName = argv[++i];
+    } else if (strcmp(argv[i], "-q") == 0) {
+      quiet = true;
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+      return 2;
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+
+  if (paths.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (numChannels == 0) {
+    numChannels = (unsigned)paths.size();
+  }
+
+  // 读取输入（多个通道可以共享同一个文件的数据）
+  std::vector<std::vector<uint32_t>> inputs(paths.size());
+  for (size_t i = 0; i < paths.size(); i++) {
+    if (!loadPacked(paths[i], &inputs[i])) {
+      return 1;
+    }
+  }
+
+  APRSStreamEngine engine;
+  if (!engine.begin((uint16_t)numChannels, (uint16_t)numWorkers)) {
+    fprintf(stderr, "无法创建 %u 个通道\n", numChannels);
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<AFSKDemodulator>> demods;
+  uint32_t sampleRate = AFSK_SAMPLE_RATE;
+  if (demodName != nullptr) {
+    for (unsigned ch = 0; ch < numChannels; ch++) {
+      AFSKDemodulator* demod = createDemodulator(demodName);
+      if (demod == nullptr) {
+        usage(argv[0]);
+        return 2;
+      }
+      demods.emplace_back(demod);
+      sampleRate = demod->getSampleRate();
+      engine.getDecoder((uint16_t)ch)->setDemodulator(demod);
+    }
+  }
+
+  size_t maxWords = 0;
+  for (const std::vector<uint32_t>& input : inputs) {
+    if (input.size() > maxWords) {
+      maxWords = input.size();
+    }
+  }
+
+  uint32_t frames = 0;
+  auto start = std::chrono::steady_clock::now();
+  engine.start();
+
+  // 按通道轮流送入一个数据块，输入结束的通道立即关闭
+  for (size_t pos = 0; pos < maxWords; pos += STREAM_BLOCK_WORDS) {
+    for (unsigned ch = 0; ch < numChannels; ch++) {
+      const std::vector<uint32_t>& input = inputs[ch % inputs.size()];
+      if (pos < input.size()) {
+        size_t n = input.size() - pos;
+        if (n > STREAM_BLOCK_WORDS) {
+          n = STREAM_BLOCK_WORDS;
+        }
+        engine.feed((uint16_t)ch, &input[pos], n);
+        if (pos + n >= input.size()) {
+          engine.close((uint16_t)ch);
+        }
+      }
+    }
+    frames += drainFrames(engine, false, quiet);
+  }
+  for (unsigned ch = 0; ch < numChannels; ch++) {
+    if (inputs[ch % inputs.size()].empty()) {
+      engine.close((uint16_t)ch);
+    }
+  }
+
+  frames += drainFrames(engine, true, quiet);
+  auto end = std::chrono::steady_clock::now();
+  engine.stop();
+  double seconds = std::chrono::duration<double>(end - start).count();
+
+  // 统计信息
+  uint64_t samples = 0;
+  uint32_t waits = 0;
+  for (unsigned ch = 0; ch < numChannels; ch++) {
+    StreamStatistics* stats = engine.getStatistics((uint16_t)ch);
+    samples += stats->samplesDecoded;
+    waits += stats->producerWaits;
+  }
+  double audioSeconds = (double)samples / sampleRate;
+
+  fprintf(stderr, "通道数: %u, 工作线程: %u\n", numChannels, engine.getNumWorkers());
+  fprintf(stderr, "采样数: %llu (%.1f 秒音频)\n", (unsigned long long)samples, audioSeconds);
+  fprintf(stderr, "处理时间: %.3f 秒\n", seconds);
+  if (seconds > 0) {
+    fprintf(stderr, "吞吐量: %.0f 采样/秒 (%.1fx 实时, 每线程 %.0f 采样/秒)\n",
+            samples / seconds, audioSeconds / seconds, samples / seconds / engine.getNumWorkers());
+  }
+  fprintf(stderr, "解码帧数: %u\n", frames);
+  fprintf(stderr, "生产者等待: %u 次\n", waits);
+
+#if APRS_PROFILE
+  // 工作线程已退出，计数已并入合计
+  fprintf(stderr, "%-9s %10s %12s %10s %10s %10s %10s\n",
+          "阶段", "调用", "平均/单位", "平均/次", "p50", "p99", "最大");
+  for (uint8_t i = 0; i < PROFILE_STAGE_COUNT; i++) {
+    ProfileSummary summary;
+    aprsProfileGetSummary(i, &summary);
+    if (summary.calls == 0) {
+      continue;
+    }
+    fprintf(stderr, "%-9s %10u %12.2f %10u %10u %10u %10u\n",
+            aprsProfileStageName(i), summary.calls, summary.cyclesPerItemX100 / 100.0,
+            summary.avgCycles, summary.p50Cycles, summary.p99Cycles, summary.maxCycles);
+  }
+  fprintf(stderr, "(单位: %s)\n", PROFILE_UNIT);
+#endif
+
+  return 0;
+}